@@ -0,0 +1,180 @@
+#include "arena.h"
+
+#include <sys/mman.h>
+#include <stdint.h>
+
+static const size_t ARENA_MAX_ALIGNMENT = 4096;
+
+/**
+ * @brief Get size class of the pool allocation.
+ * 
+ * @param size number of bytes
+ * @return index of the smallest class that fits the size
+ */
+static size_t Arena_class(size_t size) {
+    if (size <= (size_t) 1 << ARENA_MIN_CLASS_SHIFT) return 0;
+    return (size_t) (64 - __builtin_clzl(size - 1)) - ARENA_MIN_CLASS_SHIFT;
+}
+
+static size_t Arena_class_size(size_t class_id) { return (size_t) 1 << (ARENA_MIN_CLASS_SHIFT + class_id); }
+
+/**
+ * @brief Map memory aligned to the huge page size.
+ * 
+ * @param size size of the mapping (multiple of ARENA_BLOCK_SIZE)
+ * @return pointer to the memory (MAP_FAILED if failed)
+ */
+static void* Arena_map_aligned(size_t size) {
+    char* mapping = (char*) mmap(NULL, size + ARENA_BLOCK_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED) return MAP_FAILED;
+
+    size_t head = (ARENA_BLOCK_SIZE - (uintptr_t) mapping % ARENA_BLOCK_SIZE) % ARENA_BLOCK_SIZE;
+
+    if (head) munmap(mapping, head);
+    munmap(mapping + head + size, ARENA_BLOCK_SIZE - head);
+
+    return mapping + head;
+}
+
+/**
+ * @brief Take block from the system and put it into the block list of the arena.
+ * 
+ * @param arena pointer to the arena
+ * @param size minimal size of the block
+ * @return new block (NULL if failed)
+ */
+static ArenaBlock* Arena_map(Arena* arena, size_t size) {
+    size = (size + ARENA_BLOCK_SIZE - 1) / ARENA_BLOCK_SIZE * ARENA_BLOCK_SIZE;
+
+    void* memory = MAP_FAILED;
+    bool huge = false;
+
+    if (arena->pages == ARENA_HUGETLB_PAGES) {
+        memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        huge = memory != MAP_FAILED;
+    }
+
+    if (memory == MAP_FAILED && arena->pages != ARENA_SMALL_PAGES) {
+        //* Transparent huge pages only back ranges aligned to the huge page size.
+        memory = Arena_map_aligned(size);
+        huge = memory != MAP_FAILED && madvise(memory, size, MADV_HUGEPAGE) == 0;
+    }
+
+    if (memory == MAP_FAILED && arena->pages == ARENA_SMALL_PAGES) {
+        memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    }
+
+    _LOG_FAIL_CHECK_(memory != MAP_FAILED, "error", ERROR_REPORTS, return NULL, NULL, ENOMEM);
+
+    ArenaBlock* block = (ArenaBlock*) memory;
+    block->next = arena->blocks;
+    block->size = size;
+    arena->blocks = block;
+
+    ++arena->stats.block_count;
+    if (huge) ++arena->stats.huge_block_count;
+    arena->stats.bytes_reserved += size;
+
+    return block;
+}
+
+void Arena_ctor(Arena* arena, ARENA_PAGES pages, err_anchor_t err_code) {
+    _LOG_FAIL_CHECK_(arena, "error", ERROR_REPORTS, return, err_code, EINVAL);
+    _LOG_FAIL_CHECK_(pages == ARENA_SMALL_PAGES || pages == ARENA_TRANSPARENT_HUGE_PAGES || pages == ARENA_HUGETLB_PAGES,
+        "error", ERROR_REPORTS, return, err_code, EINVAL);
+
+    *arena = {};
+    arena->pages = pages;
+}
+
+void Arena_dtor(Arena* arena) {
+    _LOG_FAIL_CHECK_(arena, "error", ERROR_REPORTS, return, NULL, EINVAL);
+
+    for (ArenaBlock* block = arena->blocks; block;) {
+        ArenaBlock* next = block->next;
+        munmap(block, block->size);
+        block = next;
+    }
+
+    *arena = {};
+}
+
+void* Arena_alloc(Arena* arena, size_t size, size_t alignment) {
+    _LOG_FAIL_CHECK_(arena && alignment && (alignment & (alignment - 1)) == 0 && alignment <= ARENA_MAX_ALIGNMENT,
+        "error", ERROR_REPORTS, return NULL, NULL, EINVAL);
+
+    uintptr_t start = ((uintptr_t) arena->cursor + alignment - 1) & ~(alignment - 1);
+
+    if (!arena->cursor || start + size > (uintptr_t) arena->limit) {
+        size_t header = (sizeof(ArenaBlock) + alignment - 1) & ~(alignment - 1);
+
+        //* Large allocations get blocks of their own, so that the current block is not abandoned half-empty.
+        if (header + size > ARENA_BLOCK_SIZE / 2) {
+            ArenaBlock* block = Arena_map(arena, header + size);
+            if (!block) return NULL;
+
+            arena->stats.bytes_allocated += header + size;
+            ++arena->stats.allocation_count;
+
+            return (char*) block + header;
+        }
+
+        ArenaBlock* block = Arena_map(arena, ARENA_BLOCK_SIZE);
+        if (!block) return NULL;
+
+        arena->cursor = (char*) (block + 1);
+        arena->limit = (char*) block + block->size;
+
+        start = ((uintptr_t) arena->cursor + alignment - 1) & ~(alignment - 1);
+    }
+
+    arena->stats.bytes_allocated += start + size - (uintptr_t) arena->cursor;
+    ++arena->stats.allocation_count;
+
+    arena->cursor = (char*) (start + size);
+
+    return (void*) start;
+}
+
+void* Arena_pool_alloc(Arena* arena, size_t size) {
+    size_t class_id = Arena_class(size);
+
+    _LOG_FAIL_CHECK_(arena && class_id < ARENA_CLASS_COUNT, "error", ERROR_REPORTS, return NULL, NULL, EINVAL);
+
+    void* memory = arena->pools[class_id];
+
+    if (!memory) return Arena_alloc(arena, Arena_class_size(class_id), ARENA_POOL_ALIGNMENT);
+
+    //* Freed allocations store the pointer to the next freed allocation of the class in their first bytes.
+    arena->pools[class_id] = *(void**) memory;
+
+    arena->stats.bytes_pooled -= Arena_class_size(class_id);
+    ++arena->stats.pool_reuse_count;
+    ++arena->stats.allocation_count;
+
+    return memory;
+}
+
+void Arena_pool_free(Arena* arena, void* memory, size_t size) {
+    if (!memory) return;
+
+    size_t class_id = Arena_class(size);
+
+    _LOG_FAIL_CHECK_(arena && class_id < ARENA_CLASS_COUNT, "error", ERROR_REPORTS, return, NULL, EINVAL);
+
+    *(void**) memory = arena->pools[class_id];
+    arena->pools[class_id] = memory;
+
+    arena->stats.bytes_pooled += Arena_class_size(class_id);
+}
+
+void Arena_log_stats(const Arena* arena, unsigned int importance) {
+    _LOG_FAIL_CHECK_(arena, "error", ERROR_REPORTS, return, NULL, EINVAL);
+
+    const ArenaStats* stats = &arena->stats;
+
+    log_printf(importance, "status", "Arena took %lu blocks (%lu of them on huge pages) of %lu bytes in total, "
+        "%lu bytes were handed out in %lu allocations, %lu allocations reused pooled memory, %lu bytes are pooled.\n",
+        stats->block_count, stats->huge_block_count, stats->bytes_reserved,
+        stats->bytes_allocated, stats->allocation_count, stats->pool_reuse_count, stats->bytes_pooled);
+}
@@ -0,0 +1,136 @@
+/**
+ * @file arena.h
+ * @author Kudryashov Ilya (kudriashov.it@phystech.edu)
+ * @brief Arena allocator with size-class pools and optional huge page backing.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+#include "lib/util/dbg/debug.h"
+
+//* Memory is taken from the system in blocks of this size (size of the huge page), larger requests get blocks of their own.
+static const size_t ARENA_BLOCK_SIZE = 1 << 21;
+//* Alignment of the pool allocations (size of the cache line).
+static const size_t ARENA_POOL_ALIGNMENT = 64;
+//* Pool size classes are powers of two, starting from 1 << ARENA_MIN_CLASS_SHIFT bytes.
+static const size_t ARENA_MIN_CLASS_SHIFT = 6;
+static const size_t ARENA_CLASS_COUNT = 40;
+
+enum ARENA_PAGES {
+    ARENA_SMALL_PAGES,              //* regular pages
+    ARENA_TRANSPARENT_HUGE_PAGES,   //* blocks aligned to the huge page and marked with madvise(MADV_HUGEPAGE)
+    ARENA_HUGETLB_PAGES,            //* MAP_HUGETLB blocks (transparent huge pages if the system has no reserved huge pages)
+};
+
+/**
+ * @brief Block of memory taken from the system, the header is placed at its start.
+ * 
+ * @param next next block of the arena
+ * @param size size of the mapping
+ */
+struct ArenaBlock {
+    ArenaBlock* next;
+    size_t size;
+};
+
+/**
+ * @brief Allocation statistics of the arena.
+ * 
+ * @param block_count number of blocks taken from the system
+ * @param huge_block_count number of blocks backed (or advised to be backed) by huge pages
+ * @param bytes_reserved total size of the blocks
+ * @param bytes_allocated bytes handed out by the arena, including alignment padding
+ * @param bytes_pooled bytes of the freed pool allocations waiting for reuse
+ * @param allocation_count number of allocations
+ * @param pool_reuse_count number of pool allocations served by previously freed memory
+ */
+struct ArenaStats {
+    size_t block_count = 0;
+    size_t huge_block_count = 0;
+    size_t bytes_reserved = 0;
+    size_t bytes_allocated = 0;
+    size_t bytes_pooled = 0;
+    size_t allocation_count = 0;
+    size_t pool_reuse_count = 0;
+};
+
+/**
+ * @brief Arena allocator. Memory is returned to the system only when the arena is destroyed.
+ * 
+ * @param blocks list of the blocks
+ * @param cursor first free byte of the current block
+ * @param limit end of the current block
+ * @param pages pages backing the blocks
+ * @param pools lists of freed pool allocations by size class
+ * @param stats allocation statistics
+ */
+struct Arena {
+    ArenaBlock* blocks = NULL;
+    char* cursor = NULL;
+    char* limit = NULL;
+    ARENA_PAGES pages = ARENA_SMALL_PAGES;
+    void* pools[ARENA_CLASS_COUNT] = {};
+    ArenaStats stats = {};
+};
+
+/**
+ * @brief Initialize the arena (blocks are taken from the system on demand).
+ * 
+ * @param arena pointer to the arena
+ * @param pages pages to back the blocks with
+ * @param err_code variable to use as errno
+ */
+void Arena_ctor(Arena* arena, ARENA_PAGES pages, ERROR_MARKER);
+
+/**
+ * @brief Free all memory of the arena at once.
+ * 
+ * @param arena pointer to the arena
+ */
+void Arena_dtor(Arena* arena);
+
+/**
+ * @brief Allocate memory that lives until the arena is destroyed.
+ * 
+ * @param arena pointer to the arena
+ * @param size number of bytes
+ * @param alignment alignment of the memory (power of 2, at most the system page size)
+ * @return pointer to the memory (NULL if failed)
+ */
+void* Arena_alloc(Arena* arena, size_t size, size_t alignment);
+
+/**
+ * @brief Allocate memory of the size class covering the size (aligned to ARENA_POOL_ALIGNMENT).
+ * 
+ * @param arena pointer to the arena
+ * @param size number of bytes
+ * @return pointer to the memory (NULL if failed)
+ */
+void* Arena_pool_alloc(Arena* arena, size_t size);
+
+/**
+ * @brief Return memory to the pool of its size class, so that it can be reused by the next allocations of the class.
+ * 
+ * @param arena arena the memory was taken from
+ * @param memory pointer returned by Arena_pool_alloc() (can be NULL)
+ * @param size size the memory was requested with
+ */
+void Arena_pool_free(Arena* arena, void* memory, size_t size);
+
+/**
+ * @brief Print allocation statistics of the arena to logs.
+ * 
+ * @param arena pointer to the arena
+ * @param importance importance of the message
+ */
+void Arena_log_stats(const Arena* arena, unsigned int importance);
+
+#endif
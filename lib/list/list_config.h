@@ -24,13 +24,19 @@
     "\t\t<TR><TD PORT=\"head\" BGCOLOR=\"%s\">Cell %d</TD></TR>\n" \
     "\t\t<TR><TD BGCOLOR=\"%s\">%02X %02X %02X %02X</TD></TR>\n" \
     "\t\t<TR><TD PORT=\"bottom\">P:%ld N:%ld</TD></TR></TABLE>>]\n", (int)id, \
-    cell==list->first_empty || cell==list->buffer ? LIST_POISON_COLOR : LIST_VALUE_COLOR, \
+    id==list->first_empty || id==0 ? LIST_POISON_COLOR : LIST_VALUE_COLOR, \
     (int)id, cell->content==LIST_ELEM_POISON ? LIST_POISON_COLOR : LIST_VALUE_COLOR, \
-    data[0], data[1], data[2], data[3], cell->prev-list->buffer, cell->next-list->buffer
+    data[0], data[1], data[2], data[3], (long)_LIST_PREV(list, id), (long)_LIST_NEXT(list, id)
 #else
 #define LIST_VERTEX_FORMAT "\tV%d", (int)id
 #endif
 
+//* Fragmented list is linearized once positional lookups walk this many list sizes.
+const size_t LIST_RELINEARIZE_FACTOR = 1;
+
+//* Alignment of the list buffers (at OPTIMIZATION_LEVEL >= 1).
+const size_t LIST_BUFFER_ALIGNMENT = 64;
+
 const size_t LIST_PICT_NAME_SIZE = 128;
 const size_t LIST_DRAW_REQUEST_SIZE = 256;
 
@@ -17,269 +17,479 @@
 #include "listworks_.h"
 
 #include <time.h>
+#include <string.h>
 
 #include "list_config.h"
 
-_ListCell* _List_ptr_by_index(List* list, size_t index, int id);
+#ifdef LIST_SPLIT_STORAGE
+#define _LIST_LINKS(list) ((list)->links)
+#else
+#define _LIST_LINKS(list) ((list)->buffer)
+#endif
 
-void List_ctor(List* list, size_t capacity, int* const err_code) {
-    _LOG_FAIL_CHECK_(check_ptr(list), "error", ERROR_REPORTS, return, err_code, EFAULT);
+#define _LIST_NEXT(list, id) _LIST_LINKS(list)[id].next
+#define _LIST_PREV(list, id) _LIST_LINKS(list)[id].prev
+
+/**
+ * @brief Convert cell index to the link value.
+ * 
+ * @param id index of the cell
+ * @return list_link_t
+ */
+static inline list_link_t _List_link(size_t id) {
+    #ifdef LIST_SPLIT_STORAGE
+    return (list_link_t) id;
+    #else
+    return id;
+    #endif
+}
+
+/**
+ * @brief Allocate buffer of list cells.
+ * 
+ * @param list list the buffer is allocated for
+ * @param capacity number of cells
+ * @return pointer to the buffer (NULL if failed)
+ */
+static _ListCell* _List_alloc_cells(const List* const list, size_t capacity) {
+    if (list->arena) return (_ListCell*) Arena_pool_alloc(list->arena, capacity * sizeof(_ListCell));
 
     #if OPTIMIZATION_LEVEL < 1  //! WARNING: THIS PREPROCESSING CODE IS TASK-SPECIFIC!
-    list->buffer = (_ListCell*) calloc(capacity, sizeof(*list->buffer));
+    return (_ListCell*) calloc(capacity, sizeof(_ListCell));
     #else
-    list->buffer = NULL;
-    int alloc_status = posix_memalign((void**)&list->buffer, 32, capacity * sizeof(*list->buffer));
-    _LOG_FAIL_CHECK_(alloc_status == 0, "error", ERROR_REPORTS, return, err_code, ENOMEM);
+    _ListCell* buffer = NULL;
+    if (posix_memalign((void**)&buffer, LIST_BUFFER_ALIGNMENT, capacity * sizeof(*buffer)) != 0) return NULL;
+    return buffer;
     #endif
+}
 
-    _LOG_FAIL_CHECK_(list->buffer, "error", ERROR_REPORTS, return, err_code, ENOMEM);
+/**
+ * @brief Free buffer allocated by _List_alloc_cells().
+ * 
+ * @param list list the buffer was allocated for
+ * @param buffer buffer to free
+ * @param capacity number of cells in the buffer
+ */
+static void _List_free_cells(const List* const list, _ListCell* buffer, size_t capacity) {
+    if (list->arena) Arena_pool_free(list->arena, buffer, capacity * sizeof(*buffer));
+    else free(buffer);
+}
 
-    for (size_t id = 0; id < capacity; ++id) {
-        _ListCell* cell = list->buffer + id;
-        *cell = _ListCell {};
-        cell->next = cell + 1;
-        cell->prev = cell - 1;
+#ifdef LIST_SPLIT_STORAGE
+/**
+ * @brief Allocate zeroed buffer of list links.
+ * 
+ * @param list list the buffer is allocated for
+ * @param capacity number of links
+ * @return pointer to the buffer (NULL if failed)
+ */
+static _ListLink* _List_alloc_links(const List* const list, size_t capacity) {
+    if (!list->arena) return (_ListLink*) calloc(capacity, sizeof(_ListLink));
+
+    _ListLink* links = (_ListLink*) Arena_pool_alloc(list->arena, capacity * sizeof(*links));
+    for (size_t id = 0; links && id < capacity; ++id) links[id] = _ListLink {};
+    return links;
+}
+
+static void _List_free_links(const List* const list, _ListLink* links, size_t capacity) {
+    if (list->arena) Arena_pool_free(list->arena, links, capacity * sizeof(*links));
+    else free(links);
+}
+#endif
+
+/**
+ * @brief Link cells of the list whose elements occupy cells [1, size] in order.
+ * 
+ * @param list pointer to the list
+ */
+static void _List_relink(List* const list) {
+    for (size_t id = 1; id < list->capacity; ++id) {
+        _LIST_NEXT(list, id) = _List_link(id + 1);
+        _LIST_PREV(list, id) = _List_link(id - 1);
     }
 
-    list->buffer[0].next = list->buffer;
-    list->buffer[0].prev = list->buffer;
-    list->buffer[capacity - 1].next = list->buffer + 1;
-    list->buffer[1].prev = list->buffer + capacity - 1;
+    _LIST_NEXT(list, 0) = _List_link(list->size ? 1 : 0);
+    _LIST_NEXT(list, list->size) = 0;
+    _LIST_PREV(list, 0) = _List_link(list->size);
 
-    list->capacity = capacity;
-    list->first_empty = list->buffer + 1;
-    list->size = 0;
+    _LIST_PREV(list, list->size + 1) = _List_link(list->capacity - 1);
+    _LIST_NEXT(list, list->capacity - 1) = _List_link(list->size + 1);
 
-    _LOG_FAIL_CHECK_(List_status(list) == 0, "error", ERROR_REPORTS, return, err_code, EAGAIN);
+    list->first_empty = _List_link(list->size + 1);
+    list->linearized = true;
+    list->walk_length = 0;
 }
 
-void List_dtor(List* list, int* const err_code) {
-    _LOG_FAIL_CHECK_(List_status(list) == 0, "error", ERROR_REPORTS, return, err_code, EFAULT);
+/**
+ * @brief Exclude the cell from the cycle it is in.
+ * 
+ * @param list pointer to the list
+ * @param cell index of the cell
+ */
+static inline void _List_unlink(List* const list, list_link_t cell) {
+    _LIST_NEXT(list, _LIST_PREV(list, cell)) = _LIST_NEXT(list, cell);
+    _LIST_PREV(list, _LIST_NEXT(list, cell)) = _LIST_PREV(list, cell);
+}
 
-    free(list->buffer);
-    
-    list->buffer = NULL;
-    list->capacity = 0;
-    list->first_empty = NULL;
-    list->size = 0;
+/**
+ * @brief Put the cell into a cycle right before another cell.
+ * 
+ * @param list pointer to the list
+ * @param cell index of the cell to put
+ * @param next_nbor index of the cell to put it before
+ */
+static inline void _List_link_before(List* const list, list_link_t cell, list_link_t next_nbor) {
+    list_link_t prev_nbor = _LIST_PREV(list, next_nbor);
+
+    _LIST_NEXT(list, cell) = next_nbor;
+    _LIST_PREV(list, cell) = prev_nbor;
+    _LIST_NEXT(list, prev_nbor) = cell;
+    _LIST_PREV(list, next_nbor) = cell;
 }
 
-void List_dtor_void(List* const list) { List_dtor(list, NULL); }
+/**
+ * @brief Check if elements of the list occupy cells [1, size] in order.
+ * 
+ * @param list pointer to the list
+ * @return true if the list is compact
+ */
+static bool _List_is_compact(const List* const list) {
+    return list->linearized && (list->size == 0 || _LIST_NEXT(list, 0) == 1);
+}
 
-void List_linearize(List* const list, int* const err_code) {
-    _LOG_FAIL_CHECK_(List_status(list) == 0, "error", ERROR_REPORTS, return, err_code, EFAULT);
+/**
+ * @brief Move elements of the list into a new buffer, placing them into cells [1, size] in order.
+ * 
+ * @param list pointer to the list
+ * @param capacity capacity of the new buffer
+ * @return 0 if relocation was successful, 1 otherwise
+ */
+static int _List_relocate(List* const list, size_t capacity) {
+    if (capacity > LIST_MAX_CAPACITY) return 1;
+
+    _ListCell* new_buffer = _List_alloc_cells(list, capacity);
+    if (!new_buffer) return 1;
+
+    #ifdef LIST_SPLIT_STORAGE
+    //* Links are rebuilt from scratch, so they are never copied.
+    _ListLink* new_links = _List_alloc_links(list, capacity);
+    if (!new_links) {
+        _List_free_cells(list, new_buffer, capacity);
+        return 1;
+    }
+    #endif
 
-    _ListCell* cell = list->buffer->next;
-    size_t index = 0;
+    new_buffer[0] = list->buffer[0];
 
-    while (cell != list->buffer) {
-        _ListCell* target_spot = list->buffer + (index++) + 1;
+    if (_List_is_compact(list)) {
+        memcpy(new_buffer + 1, list->buffer + 1, list->size * sizeof(*new_buffer));
+    } else {
+        list_link_t cell = _LIST_NEXT(list, 0);
+        for (size_t id = 1; id <= list->size; ++id, cell = _LIST_NEXT(list, cell)) new_buffer[id].content = list->buffer[cell].content;
+    }
 
-        target_spot->next->prev = cell;
-        if (target_spot == cell->next) {
-            target_spot->prev = target_spot;
-            cell->next = cell;
-        } else {
-            target_spot->prev->next = cell;
-            cell->next->prev = target_spot;
-            cell->prev->next = target_spot;
-        }
+    for (size_t id = list->size + 1; id < capacity; ++id) new_buffer[id] = _ListCell {};
 
-        _ListCell cell_copy = *cell;
-        *cell = *target_spot;
-        *target_spot = cell_copy;
+    _List_free_cells(list, list->buffer, list->capacity);
+    list->buffer = new_buffer;
 
-        cell = target_spot->next;
-    }
+    #ifdef LIST_SPLIT_STORAGE
+    _List_free_links(list, list->links, list->capacity);
+    list->links = new_links;
+    #endif
 
-    list->first_empty = list->buffer + list->size + 1;
+    list->capacity = capacity;
 
-    for (size_t id = 1; id < list->capacity; ++id) {
-        list->buffer[id].next = list->buffer + id + 1;
-        list->buffer[id].prev = list->buffer + id - 1;
-    }
+    _List_relink(list);
 
-    list->buffer[list->size].next = list->buffer;
-    list->buffer->prev = list->buffer + list->size;
+    return 0;
+}
 
-    list->buffer[list->size + 1].prev = list->buffer + list->capacity - 1;
-    list->buffer[list->capacity - 1].next = list->buffer + list->size + 1;
+void List_ctor(List* list, size_t capacity, int* const err_code, Arena* arena) {
+    _LOG_FAIL_CHECK_(check_ptr(list),                "error", ERROR_REPORTS, return, err_code, EFAULT);
+    _LOG_FAIL_CHECK_(capacity <= LIST_MAX_CAPACITY, "error", ERROR_REPORTS, return, err_code, EINVAL);
 
-    list->linearized = true;
+    list->arena = arena;
+    list->buffer = _List_alloc_cells(list, capacity);
+
+    _LOG_FAIL_CHECK_(list->buffer, "error", ERROR_REPORTS, return, err_code, ENOMEM);
+
+    #ifdef LIST_SPLIT_STORAGE
+    list->links = _List_alloc_links(list, capacity);
+
+    _LOG_FAIL_CHECK_(list->links, "error", ERROR_REPORTS, {
+        _List_free_cells(list, list->buffer, capacity);
+        list->buffer = NULL;
+        return;
+    }, err_code, ENOMEM);
+    #endif
+
+    for (size_t id = 0; id < capacity; ++id) list->buffer[id] = _ListCell {};
+
+    list->capacity = capacity;
+    list->size = 0;
+
+    _List_relink(list);
 
     _LOG_FAIL_CHECK_(List_status(list) == 0, "error", ERROR_REPORTS, return, err_code, EAGAIN);
 }
 
-list_position_t List_insert(List* const list, const list_elem_t elem, const list_position_t position, int* const err_code) {
-    _LOG_FAIL_CHECK_(List_status(list) == 0,          "error", ERROR_REPORTS, return 0, err_code, EFAULT);
-    _LOG_FAIL_CHECK_(position < list->capacity,       "error", ERROR_REPORTS, return 0, err_code, EINVAL);
-    _LOG_FAIL_CHECK_(list->first_empty->next != NULL, "error", ERROR_REPORTS, return 0, err_code, ENOMEM);
+void List_dtor(List* list, int* const err_code) {
+    _LOG_FAIL_CHECK_(List_status(list) == 0, "error", ERROR_REPORTS, return, err_code, EFAULT);
 
-    _ListCell* pasted_cell = NULL;
+    _List_free_cells(list, list->buffer, list->capacity);
 
-    if (list->linearized && (list->buffer + position == list->buffer->next || 
-                             list->buffer + position == list->buffer->prev)) {
+    #ifdef LIST_SPLIT_STORAGE
+    _List_free_links(list, list->links, list->capacity);
+    list->links = NULL;
+    #endif
 
-        if (list->buffer + position == list->buffer->prev) {
+    list->buffer = NULL;
+    list->capacity = 0;
+    list->first_empty = 0;
+    list->size = 0;
+}
 
-            pasted_cell = list->first_empty;
+void List_dtor_void(List* const list) { List_dtor(list, NULL); }
 
-            pasted_cell->prev->next = pasted_cell->next;
-            pasted_cell->next->prev = pasted_cell->prev;
+/**
+ * @brief Sort list elements in place if they are already compact, relocate them otherwise.
+ * 
+ * @param list pointer to the list
+ * @return 0 if the list was linearized, 1 if relocation failed
+ */
+static int _List_linearize(List* const list) {
+    if (_List_is_compact(list)) {
+        _List_relink(list);
+        return 0;
+    }
+
+    return _List_relocate(list, list->capacity);
+}
 
-            list->first_empty = list->first_empty->next;
+void List_linearize(List* const list, int* const err_code) {
+    _API_CHECK_(List_status(list) == 0, return, err_code, EFAULT);
 
-        } else {
+    _LOG_FAIL_CHECK_(_List_linearize(list) == 0, "error", ERROR_REPORTS, return, err_code, ENOMEM);
 
-            pasted_cell = list->first_empty->prev;
+    _API_CHECK_(List_status(list) == 0, return, err_code, EAGAIN);
+}
 
-            list->first_empty->prev = pasted_cell->prev;
+list_position_t List_insert(List* const list, const list_elem_t elem, const list_position_t position, int* const err_code) {
+    _API_CHECK_(List_status(list) == 0,          return 0, err_code, EFAULT);
+    _API_CHECK_(position < list->capacity,       return 0, err_code, EINVAL);
+    _API_CHECK_(list->size + 2 < list->capacity, return 0, err_code, ENOMEM);
 
-            pasted_cell->prev->next = pasted_cell->next;
-            pasted_cell->next->prev = pasted_cell->prev;
+    list_position_t pasted_cell = List_insert_unchecked(list, elem, position);
+
+    _API_CHECK_(List_status(list) == 0, return 0, err_code, EAGAIN);
+
+    return pasted_cell;
+}
+
+list_position_t List_insert_unchecked(List* const list, const list_elem_t elem, const list_position_t position) {
+    list_link_t pasted_cell = 0;
+
+    //* Only insertions at the ends (after the sentinel or after the last element) keep the list linearized.
+    if (list->linearized && (position == 0 || position == _LIST_PREV(list, 0))) {
+
+        //* Elements are appended into the first free cell and prepended into the last one.
+        pasted_cell = position == _LIST_PREV(list, 0) ? list->first_empty : _LIST_PREV(list, list->first_empty);
 
-        }
     } else {
         list->linearized = false;
 
         pasted_cell = list->first_empty;
-
-        list->first_empty->next->prev = list->first_empty->prev;
-        list->first_empty->prev->next = list->first_empty->next;
-
-        list->first_empty = list->first_empty->next;
     }
 
-    pasted_cell->content = elem;
+    if (pasted_cell == list->first_empty) list->first_empty = _LIST_NEXT(list, pasted_cell);
+    _List_unlink(list, pasted_cell);
 
-    _ListCell* prev_nbor = list->buffer + position;
-    _ListCell* next_nbor = prev_nbor->next;
-    
-    pasted_cell->next = next_nbor;
-    pasted_cell->prev = prev_nbor;
-    prev_nbor->next = pasted_cell;
-    next_nbor->prev = pasted_cell;
+    list->buffer[pasted_cell].content = elem;
 
-    ++list->size;
+    _List_link_before(list, pasted_cell, _LIST_NEXT(list, position));
 
-    _LOG_FAIL_CHECK_(List_status(list) == 0, "error", ERROR_REPORTS, return 0, err_code, EAGAIN);
+    ++list->size;
 
-    return (list_position_t)(pasted_cell - list->buffer);
+    return pasted_cell;
 }
 
 list_position_t List_push(List* const list, const list_elem_t elem, int* const err_code) {
-    if (list->size >= list->capacity - 1) {
-        if (List_inflate(list, list->capacity * 2, err_code)) return 0;
+    _API_CHECK_(List_status(list) == 0, return 0, err_code, EFAULT);
+
+    list_position_t position = List_push_unchecked(list, elem, err_code);
+
+    _API_CHECK_(List_status(list) == 0, return 0, err_code, EAGAIN);
+
+    return position;
+}
+
+list_position_t List_push_unchecked(List* const list, const list_elem_t elem, int* const err_code) {
+    //* Last free cell is never taken, as the free cycle can not be empty.
+    if (list->size + 2 >= list->capacity) {
+        _LOG_FAIL_CHECK_(_List_relocate(list, list->capacity * 2) == 0, "error", ERROR_REPORTS, return 0, err_code, ENOMEM);
     }
 
-    return List_insert(list, elem, List_find_position(list, -1), err_code);
+    //* The sentinel precedes the first element, so its previous cell is the last element (or the sentinel itself).
+    return List_insert_unchecked(list, elem, _LIST_PREV(list, 0));
 }
 
 list_position_t List_find_position(List* const list, const int index, int* const err_code) {
-    _LOG_FAIL_CHECK_(List_status(list) == 0, "error", ERROR_REPORTS, return 0, err_code, EFAULT);
+    _API_CHECK_(List_status(list) == 0, return 0, err_code, EFAULT);
 
-    _LOG_FAIL_CHECK_((-(int)list->size <= index && index < (int)list->size) || list->size == 0, "error", ERROR_REPORTS, {
+    _API_CHECK_((-(int)list->size <= index && index < (int)list->size) || list->size == 0, {
         log_printf(ERROR_REPORTS, "error", "Requested index was %d with size %lld.\n", index, (long long) list->size);
         return 0;
     }, err_code, EFAULT);
 
+    return List_find_position_unchecked(list, index);
+}
+
+list_position_t List_find_position_unchecked(List* const list, const int index) {
     if (list->size == 0) return 0;
 
+    //* Walk from the nearest end: forward for index >= 0, backward for negative ones.
+    long long offset = index >= 0 ? index : index + (long long) list->size;
+    if (offset >= (long long) list->size / 2) offset -= (long long) list->size;
+
+    if (!list->linearized) {
+        size_t steps = (size_t) (offset >= 0 ? offset : -offset - 1);
+        list->walk_length += steps;
+
+        //* Failed relocation leaves the list fragmented, so it is walked as it is.
+        if (list->walk_length >= LIST_RELINEARIZE_FACTOR * list->size) _List_linearize(list);
+    }
+
     if (list->linearized) {
-        long long delta = index + (long long)(list->capacity - 1);
-        _ListCell* count_start = list->buffer->prev;
+        long long delta = offset + (long long)(list->capacity - 1);
+        long long count_start = (long long) _LIST_PREV(list, 0);
 
-        if (index >= 0) {
-            delta = index - 1;
-            count_start = list->buffer->next;
+        if (offset >= 0) {
+            delta = offset - 1;
+            count_start = (long long) _LIST_NEXT(list, 0);
         }
 
-        return (unsigned long long)(count_start - list->buffer + delta) % (list->capacity - 1) + 1;
+        return (unsigned long long)(count_start + delta) % (list->capacity - 1) + 1;
     }
 
-    _ListCell* current = index >= 0 ? 
-        list->buffer->next : list->buffer->prev;
+    list_link_t current = offset >= 0 ? _LIST_NEXT(list, 0) : _LIST_PREV(list, 0);
 
-    for (int id = 0; id < index; ++id) {
-        current = index >= 0 ? current->next : current->prev;
-    }
+    if (offset >= 0) for (long long id = 0; id < offset; ++id) current = _LIST_NEXT(list, current);
+    else for (long long id = -1; id > offset; --id) current = _LIST_PREV(list, current);
 
-    return (list_position_t)(current - list->buffer);
+    return current;
 }
 
 list_elem_t List_get(List* const list, const list_position_t position, int* const err_code) {
-    _LOG_FAIL_CHECK_(List_status(list) == 0,          "error", ERROR_REPORTS, return LIST_ELEM_POISON, err_code, EFAULT);
-    _LOG_FAIL_CHECK_(position < list->capacity,       "error", ERROR_REPORTS, return LIST_ELEM_POISON, err_code, EINVAL);
-    _LOG_FAIL_CHECK_(list->first_empty->next != NULL, "error", ERROR_REPORTS, return LIST_ELEM_POISON, err_code, ENOMEM);
+    _API_CHECK_(List_status(list) == 0,    return LIST_ELEM_POISON, err_code, EFAULT);
+    _API_CHECK_(position < list->capacity, return LIST_ELEM_POISON, err_code, EINVAL);
+
+    return List_get_unchecked(list, position);
+}
 
-    return (list->buffer + position)->content;
+list_elem_t List_get_unchecked(const List* const list, const list_position_t position) {
+    return list->buffer[position].content;
 }
 
 void List_remove(List* const list, const list_position_t position, int* const err_code) {
-    _LOG_FAIL_CHECK_(List_status(list) == 0,          "error", ERROR_REPORTS, return, err_code, EFAULT);
-    _LOG_FAIL_CHECK_(position < list->capacity,       "error", ERROR_REPORTS, return, err_code, EINVAL);
-    _LOG_FAIL_CHECK_(list->first_empty->next != NULL, "error", ERROR_REPORTS, return, err_code, ENOMEM);
-    _LOG_FAIL_CHECK_(list->size > 0,                  "error", ERROR_REPORTS, return, err_code, ENOENT);
+    _API_CHECK_(List_status(list) == 0,          return, err_code, EFAULT);
+    _API_CHECK_(position < list->capacity,       return, err_code, EINVAL);
+    _API_CHECK_(position > 0,                    return, err_code, EINVAL);
+    _API_CHECK_(list->size > 0,                  return, err_code, ENOENT);
 
     #if OPTIMIZATION_LEVEL < 1  //! WARNING: THIS PREPROCESSING CODE IS TASK-SPECIFIC!
-    _LOG_FAIL_CHECK_(list->buffer[position].content != LIST_ELEM_POISON, "error", ERROR_REPORTS, return, err_code, EFAULT);
+    _API_CHECK_(list->buffer[position].content != LIST_ELEM_POISON, return, err_code, EFAULT);
     #endif
 
-    _ListCell* cell = list->buffer + position;
-
-    cell->prev->next = cell->next;
-    cell->next->prev = cell->prev;
-
-    if (list->linearized && (cell->next == list->buffer || cell->prev == list->buffer)) {
-        if (cell->next == list->buffer) {
-            cell->next = list->first_empty;
-            cell->prev = list->first_empty->prev;
-            list->first_empty->prev->next = cell;
-            list->first_empty->prev = cell;
-            list->first_empty = cell;
-        } else {
-            cell->next = list->first_empty;
-            cell->prev = list->first_empty->prev;
-            list->first_empty->prev->next = cell;
-            list->first_empty->prev = cell;
-        }
-    } else {
-        list->linearized = false;
+    List_remove_unchecked(list, position);
 
-        cell->next = list->first_empty;
-        cell->prev = list->first_empty->prev;
-        cell->next->prev = cell;
-        cell->prev->next = cell;
+    _API_CHECK_(List_status(list) == 0, return, err_code, EAGAIN);
+}
 
-        list->first_empty = cell;
-    }
+void List_remove_unchecked(List* const list, const list_position_t position) {
+    list_link_t cell = _List_link(position);
 
-    cell->content = LIST_ELEM_POISON;
-    --list->size;
+    _List_unlink(list, cell);
 
-    _LOG_FAIL_CHECK_(List_status(list) == 0, "error", ERROR_REPORTS, return, err_code, EAGAIN);
+    //* Cells removed from the ends of the linearized list border the free cells, so the list stays linearized.
+    bool keeps_linearity = list->linearized && (_LIST_NEXT(list, cell) == 0 || _LIST_PREV(list, cell) == 0);
+    bool was_last = _LIST_NEXT(list, cell) == 0;
+
+    _List_link_before(list, cell, list->first_empty);
+
+    if (!keeps_linearity) list->linearized = false;
+    if (!keeps_linearity || was_last) list->first_empty = cell;
+
+    list->buffer[cell].content = LIST_ELEM_POISON;
+    --list->size;
 }
 
 int List_inflate(List* const list, size_t new_capacity, int* const err_code) {
-    _LOG_FAIL_CHECK_(List_status(list) == 0,    "error", ERROR_REPORTS, return 1, err_code, EFAULT);
-    _LOG_FAIL_CHECK_(new_capacity > list->size, "error", ERROR_REPORTS, return 1, err_code, EINVAL);
+    _API_CHECK_(List_status(list) == 0, return 1, err_code, EFAULT);
+    _LOG_FAIL_CHECK_(new_capacity > list->size + 1, "error", ERROR_REPORTS, return 1, err_code, EINVAL);
+
+    _LOG_FAIL_CHECK_(_List_relocate(list, new_capacity) == 0, "error", ERROR_REPORTS, return 1, err_code, ENOMEM);
+
+    _API_CHECK_(List_status(list) == 0, return 1, err_code, EAGAIN);
+
+    return 0;
+}
+
+int List_reserve(List* const list, size_t element_count, int* const err_code) {
+    _API_CHECK_(List_status(list) == 0, return 1, err_code, EFAULT);
 
-    List new_list = {};
-    List_ctor(&new_list, new_capacity, err_code);
-    _LOG_FAIL_CHECK_(List_status(&new_list) == 0, "error", ERROR_REPORTS, return 1, err_code, EFAULT);
+    //* Last free cell is never taken, as the free cycle can not be empty.
+    if (element_count + 2 <= list->capacity) return 0;
 
-    _ListCell* current_cell = list->buffer->next;
-    for (size_t id = 0; id < list->size; ++id) {
-        List_insert(&new_list, current_cell->content, List_find_position(&new_list, -1, err_code), err_code);
-        current_cell = current_cell->next;
+    return List_inflate(list, element_count + 2, err_code);
+}
+
+list_position_t List_push_bulk(List* const list, const list_elem_t* elems, size_t count, int* const err_code) {
+    _API_CHECK_(List_status(list) == 0, return 0, err_code, EFAULT);
+    _API_CHECK_(elems || count == 0, return 0, err_code, EINVAL);
+
+    if (count == 0) return 0;
+
+    if (list->size + count + 2 > list->capacity) {
+        size_t new_capacity = list->capacity * 2;
+        if (new_capacity < list->size + count + 2) new_capacity = list->size + count + 2;
+
+        if (List_inflate(list, new_capacity, err_code)) return 0;
+    } else if (!_List_is_compact(list)) {
+        List_linearize(list, err_code);
     }
 
-    List_dtor(list, err_code);
+    list_position_t first_position = list->size + 1;
 
-    *list = new_list;
+    for (size_t id = 0; id < count; ++id) list->buffer[first_position + id].content = elems[id];
+    list->size += count;
 
-    return 0;
+    _List_relink(list);
+
+    _API_CHECK_(List_status(list) == 0, return 0, err_code, EAGAIN);
+
+    return first_position;
+}
+
+_ListCell* List_data(List* const list, int* const err_code) {
+    _API_CHECK_(List_status(list) == 0, return NULL, err_code, EFAULT);
+
+    if (!_List_is_compact(list)) {
+        List_linearize(list, err_code);
+        _LOG_FAIL_CHECK_(_List_is_compact(list), "error", ERROR_REPORTS, return NULL, err_code, ENOMEM);
+    }
+
+    return list->buffer + 1;
+}
+
+size_t List_memory(const List* const list) {
+    _LOG_FAIL_CHECK_(list, "error", ERROR_REPORTS, return 0, NULL, EFAULT);
+
+    #ifdef LIST_SPLIT_STORAGE
+    return sizeof(*list) + list->capacity * (sizeof(*list->buffer) + sizeof(*list->links));
+    #else
+    return sizeof(*list) + list->capacity * sizeof(*list->buffer);
+    #endif
 }
 
 list_report_t List_status(List* const list) {
@@ -289,13 +499,17 @@ list_report_t List_status(List* const list) {
 
     if (list->size >= list->capacity) report |= LIST_BIG_SIZE;
     if (!check_ptr(list->buffer))     report |= LIST_NULL_CONTENT;
-    else if (list->first_empty <= list->buffer || list->first_empty > list->buffer + list->capacity)
+    else if (list->first_empty == 0 || list->first_empty >= list->capacity)
         report |= LIST_INV_FREE;
+
+    #ifdef LIST_SPLIT_STORAGE
+    if (!check_ptr(list->links))      report |= LIST_NULL_CONTENT;
+    #endif
     
     #ifdef _DEBUG
-    for (_ListCell* cell = list->buffer; cell < list->buffer + list->capacity; ++cell) {
-        if (cell->prev == NULL || cell->next == NULL ||
-            cell->prev->next != cell || cell->next->prev != cell) report |= LIST_INV_CONNECTIONS;
+    if (report == 0) for (size_t id = 0; id < list->capacity; ++id) {
+        if (_LIST_PREV(list, id) >= list->capacity || _LIST_NEXT(list, id) >= list->capacity ||
+            _LIST_NEXT(list, _LIST_PREV(list, id)) != id || _LIST_PREV(list, _LIST_NEXT(list, id)) != id) report |= LIST_INV_CONNECTIONS;
     }
     #endif
 
@@ -320,7 +534,7 @@ void _List_dump(List* const list, const unsigned int importance, const int line,
 
     _log_printf(importance, LIST_DUMP_TAG, "List:\n");
 
-    _log_printf(importance, LIST_DUMP_TAG, "\tfirst empty = %lld,\n", (long long) (list->first_empty - list->buffer));
+    _log_printf(importance, LIST_DUMP_TAG, "\tfirst empty = %lld,\n", (long long) list->first_empty);
     _log_printf(importance, LIST_DUMP_TAG, "\tsize =        %lld,\n", (long long) list->size);
     _log_printf(importance, LIST_DUMP_TAG, "\tcapacity =    %lld,\n", (long long) list->capacity);
     _log_printf(importance, LIST_DUMP_TAG, "\tlinearized =  %d,\n", list->linearized);
@@ -333,7 +547,7 @@ void _List_dump(List* const list, const unsigned int importance, const int line,
         _log_printf(importance, LIST_DUMP_TAG, "\t\t[%5ld] = %02X %02X %02X %02X (%s), next [%lld], prev [%lld]\n", (long) id,
             data_start[0], data_start[1], data_start[2], data_start[3],
             list->buffer[id].content == LIST_ELEM_POISON ? "POISON" : "VALUE",
-            (long long) (list->buffer[id].next - list->buffer), (long long) (list->buffer[id].prev - list->buffer));
+            (long long) _LIST_NEXT(list, id), (long long) _LIST_PREV(list, id));
         #endif
     }
 }
@@ -364,7 +578,7 @@ void _List_dump_graph(List* const list, unsigned int importance) {
     }
 
     for (size_t id = 0; id < list->capacity; ++id) {
-        fprintf(temp_file, "\tV%ld->V%ld [arrowsize=0.3]\n", (long int)id, list->buffer[id].next - list->buffer);
+        fprintf(temp_file, "\tV%ld->V%ld [arrowsize=0.3]\n", (long int)id, (long int)_LIST_NEXT(list, id));
     }
 
     fputc('}', temp_file);
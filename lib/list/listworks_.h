@@ -15,6 +15,7 @@
 #include <stdint.h>
 
 #include "lib/util/dbg/debug.h"
+#include "lib/alloc_tracker/arena.h"
 #include "listreports.h"
 
 const char LIST_DUMP_TAG[] = "list_dump";
@@ -27,16 +28,53 @@ static const list_elem_t ___LIST_ELEM_T_OR_POISON_IS_NOT_DEFINED___ = LIST_ELEM_
 //*   static const list_elem_t LIST_ELEM_POISON = '\0';
 //*   #include "listworks.h"
 
+//* Define [LIST_SPLIT_STORAGE] before the library include to keep links and contents in separate arrays.
+//* Links are then stored as 32-bit indices and contents are packed densely, so content scans touch only element memory.
+
+//* Functions with the _unchecked suffix trust their arguments and validate nothing, the rest validate them unless
+//* [UNCHECKED_API] is defined for the whole build.
+
 //* Type that is used to identify elements in raw list buffer.
 typedef uintptr_t list_position_t;
 
+//* Index of the cell the link points to.
+#ifdef LIST_SPLIT_STORAGE
+typedef uint32_t list_link_t;
+#else
+typedef size_t list_link_t;
+#endif
+
+//* Max number of cells the list buffer can have.
+static const size_t LIST_MAX_CAPACITY = (list_link_t) -1;
+
+#ifdef LIST_SPLIT_STORAGE
+
+/**
+ * @brief Linkage of the list cell.
+ * 
+ */
+struct _ListLink {
+    list_link_t next = 0;
+    list_link_t prev = 0;
+};
+
+/**
+ * @brief Primary content of the list.
+ * 
+ */
+struct _ListCell {
+    list_elem_t content = LIST_ELEM_POISON;
+};
+
+#else
+
 /**
  * @brief Primary content of the list with all the linkage.
  * 
  */
 struct _ListCell {
-    _ListCell* next = NULL;
-    _ListCell* prev = NULL;
+    list_link_t next = 0;
+    list_link_t prev = 0;
     list_elem_t content = LIST_ELEM_POISON;
 #if OPTIMIZATION_LEVEL < 1
 };
@@ -44,21 +82,31 @@ struct _ListCell {
 } __attribute__((__aligned__(64)));
 #endif
 
+#endif
+
 /**
  * @brief List data structure.
  * 
  * @param buffer
+ * @param links linkage of the cells (only with LIST_SPLIT_STORAGE)
  * @param first_empty
  * @param size
  * @param capacity
  * @param linearized
+ * @param walk_length number of cells passed by positional lookups since the list lost linearity
+ * @param arena arena the buffers are drawn from (NULL to use the heap)
  */
 struct List {
     _ListCell* buffer = NULL;
-    _ListCell* first_empty = NULL;
+#ifdef LIST_SPLIT_STORAGE
+    _ListLink* links = NULL;
+#endif
+    list_link_t first_empty = 0;
     size_t size = 0;
     size_t capacity = 0;
     bool linearized = true;
+    size_t walk_length = 0;
+    Arena* arena = NULL;
 };
 
 /**
@@ -67,8 +115,9 @@ struct List {
  * @param list list to initialize
  * @param capacity max number of elements the list can hold +1 empty element
  * @param err_code variable to use as errno
+ * @param arena arena to draw the buffers from (NULL to use the heap, the arena should outlive the list)
  */
-void List_ctor(List* list, size_t capacity = 1024, int* const err_code = NULL);
+void List_ctor(List* list, size_t capacity = 1024, int* const err_code = NULL, Arena* arena = NULL);
 
 /**
  * @brief Destroy the list.
@@ -88,6 +137,8 @@ void List_dtor_void(List* const list);
 /**
  * @brief Sort list elements for faster element access.
  * 
+ * Elements of the fragmented list are gathered into a new buffer of the same capacity.
+ * 
  * @param list list to linearize
  * @param err_code variable to use as errno
  */
@@ -103,6 +154,16 @@ void List_linearize(List* const list, int* const err_code = NULL);
  */
 list_position_t List_insert(List* const list, const list_elem_t elem, const list_position_t position, int* const err_code = NULL);
 
+/**
+ * @brief Insert element into the list without validating the list and the position.
+ * 
+ * @param list list with at least one free cell besides the last one
+ * @param elem element to insert
+ * @param position which element to insert after (less than capacity)
+ * @return position of the inserted element
+ */
+list_position_t List_insert_unchecked(List* const list, const list_elem_t elem, const list_position_t position);
+
 /**
  * @brief Push element to the back of the list.
  * 
@@ -113,16 +174,39 @@ list_position_t List_insert(List* const list, const list_elem_t elem, const list
  */
 list_position_t List_push(List* const list, const list_elem_t elem, int* const err_code = NULL);
 
+/**
+ * @brief Push element to the back of the list without validating the list.
+ * 
+ * @param list pointer to the valid list
+ * @param elem element to push
+ * @param err_code variable to use as errno (only set if the list could not be inflated)
+ * @return position of the pushed element (0 if failed)
+ */
+list_position_t List_push_unchecked(List* const list, const list_elem_t elem, int* const err_code = NULL);
+
 /**
  * @brief Find position of the index'th element in the list.
  * 
+ * Takes constant time for linearized lists. Fragmented lists are walked from the nearest end,
+ * and once the walks add up to LIST_RELINEARIZE_FACTOR times the list size the list is linearized,
+ * which invalidates previously obtained positions.
+ * 
  * @param list 
- * @param index index of the element
+ * @param index index of the element (negative indices count from the end)
  * @param err_code variable to use as errno
  * @return 
  */
 list_position_t List_find_position(List* const list, const int index, int* const err_code = NULL);
 
+/**
+ * @brief Find position of the index'th element in the list without validating the list and the index.
+ * 
+ * @param list pointer to the valid list
+ * @param index index of the element (in [-size, size))
+ * @return position of the element (0 if the list is empty)
+ */
+list_position_t List_find_position_unchecked(List* const list, const int index);
+
 /**
  * @brief Get element from the list at specified position.
  * 
@@ -133,6 +217,15 @@ list_position_t List_find_position(List* const list, const int index, int* const
  */
 list_elem_t List_get(List* const list, const list_position_t position, int* const err_code = NULL);
 
+/**
+ * @brief Get element from the list at specified position without validating the list and the position.
+ * 
+ * @param list pointer to the valid list
+ * @param position position of the element (less than capacity)
+ * @return list_elem_t
+ */
+list_elem_t List_get_unchecked(const List* const list, const list_position_t position);
+
 /**
  * @brief Remove element from the list.
  * 
@@ -142,15 +235,70 @@ list_elem_t List_get(List* const list, const list_position_t position, int* cons
  */
 void List_remove(List* const list, const list_position_t position, int* const err_code = NULL);
 
+/**
+ * @brief Remove element from the list without validating the list and the position.
+ * 
+ * @param list pointer to the valid list
+ * @param position position of an element of the list
+ */
+void List_remove_unchecked(List* const list, const list_position_t position);
+
 /**
  * @brief Relocate and increase the size of the list
  * 
+ * Elements of the linearized list are moved to the new buffer by a single block copy,
+ * others are gathered in list order. Links are rebuilt in one pass, so the list becomes linearized.
+ * 
  * @param list pointer to the list
  * @param new_size new size of the list
  * @return 0 if relocation was successful, 1 otherwise
  */
 int List_inflate(List* const list, size_t new_size, int* const err_code = NULL);
 
+/**
+ * @brief Make sure the list can hold the specified number of elements without relocation.
+ * 
+ * @param list pointer to the list
+ * @param element_count number of elements
+ * @param err_code variable to use as errno
+ * @return 0 if the list has enough space, 1 if relocation failed
+ */
+int List_reserve(List* const list, size_t element_count, int* const err_code = NULL);
+
+/**
+ * @brief Push array of elements to the back of the list.
+ * 
+ * Elements are copied into consecutive cells and linked in one pass, the list stays linearized.
+ * 
+ * @param list pointer to the list
+ * @param elems elements to push
+ * @param count number of elements
+ * @param err_code variable to use as errno
+ * @return position of the first pushed element (0 if failed)
+ */
+list_position_t List_push_bulk(List* const list, const list_elem_t* elems, size_t count, int* const err_code = NULL);
+
+/**
+ * @brief Place elements into consecutive cells in list order and get the first of them.
+ * 
+ * The list is linearized if needed, which invalidates previously obtained positions.
+ * Elements can then be scanned as data[0].content ... data[size - 1].content
+ * (densely packed with LIST_SPLIT_STORAGE).
+ * 
+ * @param list pointer to the list
+ * @param err_code variable to use as errno
+ * @return cell of the first element (NULL if failed)
+ */
+_ListCell* List_data(List* const list, int* const err_code = NULL);
+
+/**
+ * @brief Get number of bytes taken by the list buffers.
+ * 
+ * @param list pointer to the list
+ * @return size_t
+ */
+size_t List_memory(const List* const list);
+
 /**
  * @brief Get info about list as binary mask.
  * 
@@ -30,14 +30,22 @@ void parse_args(const int argc, const char** argv, const int action_c, const str
             continue;
         
         for (int tag_id = 0; tag_id < action_c; tag_id++) {
-            if (!(arg[1] == actions[tag_id].name.short_name || 
-                (arg[1] == '-' && strcmp(arg + 2, actions[tag_id].name.long_name) == 0))) continue;
-            //                                  ^ number of chars in "--"
+            const char* long_name = actions[tag_id].name.long_name;
+            size_t long_length = strlen(long_name);
+
+            //* Long names take values after the equality sign (--name=value), short ones right after the name (-Nvalue).
+            bool long_match = arg[1] == '-' && *long_name && strncmp(arg + 2, long_name, long_length) == 0 &&
+                              (arg[2 + long_length] == '\0' || arg[2 + long_length] == '=');
+            //                      ^ number of chars in "--"
+            if (!(arg[1] == actions[tag_id].name.short_name || long_match)) continue;
+
+            const char* argument = long_match && arg[2 + long_length] == '=' ? arg + 3 + long_length : arg + 2;
+
             const GenericFunctionCall* call = &actions[tag_id].action;
             if (call->function)
                 call->function(call->parameters_length, 
-                call->parameters, arg + 2);
-        }  //   number of chars in "--" ^
+                call->parameters, argument);
+        }
 
         if (strcmp(arg, "--help") == 0 || strcmp(arg, "-help") == 0 || strcmp(arg, "-h") == 0 || strcmp(arg, "-H") == 0) {
             printf("Valid tags:\n\n");
@@ -58,7 +66,7 @@ void edit_int(const int argc, void** argv, const char* argument) {
 
 void edit_string(const int argc, void** argv, const char* argument) {
     SILENCE_UNUSED(argc);
-    strcpy(*(char**)argv, argument);
+    *(const char**)argv[0] = argument;
 }
 
 void edit_double(const int argc, void** argv, const char* argument) {
@@ -66,6 +74,11 @@ void edit_double(const int argc, void** argv, const char* argument) {
     *(double*)argv[0] = atof(argument);
 }
 
+void edit_flag(const int argc, void** argv, const char* argument) {
+    SILENCE_UNUSED(argc); SILENCE_UNUSED(argument);
+    *(bool*)argv[0] = true;
+}
+
 void print_description(const ActionTag& tag) {
     if (*tag.name.long_name)
         printf("-%c --%s - %s\n\n", tag.name.short_name, tag.name.long_name, tag.description);
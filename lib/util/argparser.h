@@ -81,4 +81,13 @@ void edit_string(const int argc, void** argv, const char* argument);
  */
 void edit_double(const int argc, void** argv, const char* argument);
 
-#endif
\ No newline at end of file
+/**
+ * @brief Set boolean value (first pointer) to true.
+ * 
+ * @param argc number of arguments
+ * @param argv pointers to arguments (1-st element should be bool*)
+ * @param argument argument as string
+ */
+void edit_flag(const int argc, void** argv, const char* argument);
+
+#endif
\ No newline at end of file
@@ -44,6 +44,24 @@ do {
     }                                                                                                                   \
 } while(0)
 
+/**
+ * @brief Validate arguments or state of the data structure at the entry of a library function.
+ * 
+ * Same as _LOG_FAIL_CHECK_() with ERROR_REPORTS importance. Builds with UNCHECKED_API defined
+ * drop the check together with the calls in its condition.
+ * 
+ * @param condition value to use as an inverse trigger for assert
+ * @param action sequence to run of failure
+ * @param errcode variable to write errtype in
+ * @param errtype error code
+ */
+#ifdef UNCHECKED_API
+#define _API_CHECK_(condition, action, errcode, errtype) do { SILENCE_UNUSED(errcode); } while(0)
+#else
+#define _API_CHECK_(condition, action, errcode, errtype) \
+    _LOG_FAIL_CHECK_(condition, "error", ERROR_REPORTS, action, errcode, errtype)
+#endif
+
 
 /**
  * @brief Print errno value and its description and close log file.
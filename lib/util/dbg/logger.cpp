@@ -2,35 +2,163 @@
 
 #include <string.h>
 #include <time.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include <x86intrin.h>
 
 #include "debug.h"
 
+//* Every thread records its lines to its own ring of this many bytes (power of 2).
+static const size_t LOG_RING_SIZE = 1 << 16;
+//* Largest record, longer string arguments are cut.
+static const size_t LOG_RECORD_SIZE = 2048;
+//* Background thread writes recorded lines at least this often.
+static const long LOG_FLUSH_INTERVAL_NS = 20000000;
+
+/**
+ * @brief Log line recorded by the program thread and formatted by the writer thread.
+ * 
+ * @param size size of the record with its arguments (multiple of 8)
+ * @param importance importance of the message
+ * @param tsc time stamp counter value at the moment of the call
+ * @param tag message tag (string literal)
+ * @param file file the message was recorded from (NULL if the call place is not printed)
+ * @param line line the message was recorded from
+ * @param format format string (string literal), arguments follow the record in the order of the format
+ */
+struct LogRecord {
+    uint32_t size;
+    uint32_t importance;
+    uint64_t tsc;
+    const char* tag;
+    const char* file;
+    const char* format;
+    int line;
+};
+
+/**
+ * @brief Single-producer single-consumer ring of log records.
+ * 
+ * @param buffer record storage
+ * @param head number of bytes ever consumed by the writer thread
+ * @param tail number of bytes ever recorded by the owning thread
+ * @param drain_tail tail the writer thread drains the ring up to
+ * @param released true if the owning thread has exited and the ring can be taken by a new thread once empty
+ * @param next next ring of the list of all rings
+ */
+struct LogRing {
+    char buffer[LOG_RING_SIZE];
+    size_t head;
+    size_t tail;
+    size_t drain_tail;
+    bool released;
+    LogRing* next;
+};
+
+/**
+ * @brief Ring of the current thread, released when the thread exits.
+ */
+struct LogRingHolder {
+    LogRing* ring = NULL;
+    ~LogRingHolder() {
+        if (ring) __atomic_store_n(&ring->released, true, __ATOMIC_RELEASE);
+        ring = NULL;
+    }
+};
+
 static FILE* logfile = NULL;
 static unsigned int log_threshold = 0;
 
+static bool log_active = false;
+static bool log_async = false;
+static bool log_stop = false;
+
+static LogRing* log_rings = NULL;
+static thread_local LogRingHolder log_thread_ring = {};
+
+//* Guards the ring list and the log file (the latter only if lines are written synchronously).
+static pthread_mutex_t log_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t log_wakeup = PTHREAD_COND_INITIALIZER;
+static pthread_t log_writer = {};
+
+static uint64_t log_start_tsc = 0;
+static struct timespec log_start_time = {};
+static struct timespec log_start_clock = {};
+
 /**
- * @brief Prints out log line prefix (time and tag).
+ * @brief Conversion specification of the format string.
  * 
- * @param tag (optional) prefix tag
- * @param importance (optional) message importance
+ * @param end first character after the specification
+ * @param star_count number of '*' width and precision arguments
+ * @param length length modifier ('H' for "hh", 'q' for "ll", 0 if none)
+ * @param conversion conversion character (0 if the specification is not valid)
  */
-static void log_prefix(const char* tag = "status", const unsigned int importance = ABSOLUTE_IMPORTANCE);
+struct LogSpec {
+    const char* end;
+    unsigned star_count;
+    char length;
+    char conversion;
+};
 
 /**
- * @brief Returns currently opened log file by given importance.
+ * @brief Parse conversion specification of the format string.
  * 
- * @param importance (optional) importance of the message file will be used for.
+ * @param spec pointer to the '%' character
+ * @return parsed specification
+ */
+static LogSpec log_parse_spec(const char* spec);
+
+/**
+ * @brief Copy arguments of the format to the record.
  * 
- * @return FILE* log file
+ * @param format format string
+ * @param args arguments of the format
+ * @param buffer buffer to store arguments to
+ * @param capacity size of the buffer
+ * @return number of bytes taken by the arguments
  */
-static FILE* log_file(const unsigned int importance = ABSOLUTE_IMPORTANCE);
+static size_t log_pack(const char* format, va_list args, char* buffer, size_t capacity);
+
+/**
+ * @brief Write the record to the log file (called by the thread owning the log file).
+ * 
+ * @param record record followed by its arguments
+ */
+static void log_write(const LogRecord* record);
+
+/**
+ * @brief Write all records of all rings to the log file (called by the writer thread).
+ */
+static void log_drain();
+
+static void* log_writer_loop(void* arg);
+
+/**
+ * @brief Prints out log line prefix (time and tag).
+ * 
+ * @param tsc time stamp counter value at the moment of the call
+ * @param tag prefix tag
+ */
+static void log_prefix(uint64_t tsc, const char* tag);
 
 void log_init(const char* filename, const unsigned int threshold, int* const error_code) {
     log_threshold = threshold;
 
     if ((logfile = fopen(filename, "a"))) {
-        setvbuf(logfile, NULL, _IONBF, 0);
+        log_start_tsc = __rdtsc();
+        clock_gettime(CLOCK_REALTIME, &log_start_time);
+        clock_gettime(CLOCK_MONOTONIC, &log_start_clock);
+
         fprintf(logfile, "<pre>");
+
+        //* Lines are written synchronously if the writer thread could not be started.
+        log_stop = false;
+        log_async = pthread_create(&log_writer, NULL, log_writer_loop, NULL) == 0;
+        log_active = true;
+
         log_printf(ABSOLUTE_IMPORTANCE, "open", "Log file %s was opened.\n", filename);
         return;
     }
@@ -38,39 +166,465 @@ void log_init(const char* filename, const unsigned int threshold, int* const err
     if (error_code) *error_code = ENOENT;
 }
 
-static void log_prefix(const char* tag, const unsigned int importance) {
-    if (!log_file()) return;
-    time_t raw_time;
-    struct tm * time_info;
+static LogSpec log_parse_spec(const char* spec) {
+    LogSpec result = {};
+    const char* cur = spec + 1;
 
-    time(&raw_time);
-    time_info = localtime (&raw_time);
-    char* pc_timestamp = asctime(time_info);
-    pc_timestamp[strlen(pc_timestamp) - 1] = '\0';
+    while (*cur && strchr("-+ #0'", *cur)) ++cur;
+
+    if (*cur == '*') { ++result.star_count; ++cur; }
+    while ('0' <= *cur && *cur <= '9') ++cur;
+
+    if (*cur == '.') {
+        ++cur;
+        if (*cur == '*') { ++result.star_count; ++cur; }
+        while ('0' <= *cur && *cur <= '9') ++cur;
+    }
+
+    if (*cur == 'h' || *cur == 'l') {
+        result.length = *cur++;
+        if (*cur == result.length) result.length = *cur++ == 'h' ? 'H' : 'q';
+    } else if (*cur && strchr("Ljzt", *cur)) {
+        result.length = *cur++;
+    }
 
-    fprintf(log_file(importance), "%-20s [%s]:  ", pc_timestamp, tag);
+    if (*cur && strchr("diouxXcfFeEgGaAspn%", *cur)) result.conversion = *cur++;
+
+    result.end = cur;
+    return result;
 }
 
-void _log_printf(const unsigned int importance, const char* tag, const char* format, ...) {
+/**
+ * @brief Append value to the record arguments if it fits.
+ */
+static void log_push(char* buffer, size_t capacity, size_t* size, const void* value, size_t value_size) {
+    if (*size + value_size > capacity) return;
+    memcpy(buffer + *size, value, value_size);
+    *size += value_size;
+}
+
+static size_t log_pack(const char* format, va_list args, char* buffer, size_t capacity) {
+    size_t size = 0;
+
+    for (const char* cur = strchr(format, '%'); cur; cur = strchr(cur, '%')) {
+        LogSpec spec = log_parse_spec(cur);
+        cur = spec.end;
+
+        for (unsigned star_id = 0; star_id < spec.star_count; ++star_id) {
+            long long star = va_arg(args, int);
+            log_push(buffer, capacity, &size, &star, sizeof(star));
+        }
+
+        //* Integers are stored as long long already converted to the type of the specification.
+        long long integer = 0;
+        bool is_signed = spec.conversion == 'd' || spec.conversion == 'i';
+
+        switch (spec.conversion) {
+            case 'd': case 'i': case 'o': case 'u': case 'x': case 'X': {
+                switch (spec.length) {
+                    case 'H': integer = is_signed ? (signed char) va_arg(args, int) : (unsigned char) va_arg(args, int); break;
+                    case 'h': integer = is_signed ? (short) va_arg(args, int) : (unsigned short) va_arg(args, int); break;
+                    case 'l': integer = is_signed ? va_arg(args, long) : (long long) va_arg(args, unsigned long); break;
+                    case 'q': integer = is_signed ? va_arg(args, long long) : (long long) va_arg(args, unsigned long long); break;
+                    case 'j': integer = is_signed ? va_arg(args, intmax_t) : (long long) va_arg(args, uintmax_t); break;
+                    case 'z': integer = (long long) va_arg(args, size_t); break;
+                    case 't': integer = va_arg(args, ptrdiff_t); break;
+                    default:  integer = is_signed ? (long long) va_arg(args, int) : (long long) va_arg(args, unsigned); break;
+                }
+                log_push(buffer, capacity, &size, &integer, sizeof(integer));
+                break;
+            }
+            case 'c': {
+                integer = va_arg(args, int);
+                log_push(buffer, capacity, &size, &integer, sizeof(integer));
+                break;
+            }
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A': {
+                if (spec.length == 'L') {
+                    long double value = va_arg(args, long double);
+                    log_push(buffer, capacity, &size, &value, sizeof(value));
+                } else {
+                    double value = va_arg(args, double);
+                    log_push(buffer, capacity, &size, &value, sizeof(value));
+                }
+                break;
+            }
+            case 's': {
+                const char* string = va_arg(args, const char*);
+                if (!string) string = "(null)";
+
+                //* Strings may not outlive the call, so they are copied (and cut if the record is full).
+                size_t length = strlen(string);
+                if (size + length + 1 > capacity) length = size < capacity ? capacity - size - 1 : 0;
+                if (size < capacity) {
+                    memcpy(buffer + size, string, length);
+                    buffer[size + length] = '\0';
+                    size += length + 1;
+                }
+                break;
+            }
+            case 'p': {
+                const void* pointer = va_arg(args, const void*);
+                log_push(buffer, capacity, &size, &pointer, sizeof(pointer));
+                break;
+            }
+            case 'n': {
+                va_arg(args, int*);
+                break;
+            }
+            case '%':
+            default: break;
+        }
+    }
+
+    return size;
+}
+
+/**
+ * @brief Take the next argument of the record.
+ */
+static const char* log_pop(const char** args, const char* args_end, void* value, size_t value_size) {
+    if (*args + value_size > args_end) {
+        memset(value, 0, value_size);
+        return NULL;
+    }
+
+    memcpy(value, *args, value_size);
+    *args += value_size;
+    return *args;
+}
+
+/**
+ * @brief Print single argument with the rebuilt conversion specification.
+ */
+static void log_print_arg(const char* spec, ...) {
     va_list args;
-    va_start(args, format);
+    va_start(args, spec);
+    vfprintf(logfile, spec, args);
+    va_end(args);
+}
+
+static void log_write(const LogRecord* record) {
+    if (record->file) {
+        log_prefix(record->tsc, record->tag);
+        fprintf(logfile, " ----- Called from %s:%d. -----\n", record->file, record->line);
+    }
+
+    log_prefix(record->tsc, record->tag);
+
+    const char* args = (const char*) (record + 1);
+    const char* args_end = (const char*) record + record->size;
+
+    const char* text = record->format;
+    for (const char* cur = strchr(text, '%'); cur; cur = strchr(text, '%')) {
+        fwrite(text, 1, (size_t) (cur - text), logfile);
+
+        LogSpec spec = log_parse_spec(cur);
+        text = spec.end;
+
+        if (spec.conversion == '%' || spec.conversion == 'n') {
+            if (spec.conversion == '%') fputc('%', logfile);
+            continue;
+        }
+
+        if (!spec.conversion) {
+            fwrite(cur, 1, (size_t) (spec.end - cur), logfile);
+            continue;
+        }
+
+        //* Specification is rebuilt with '*' replaced by the recorded values and the length matching the stored argument.
+        char rebuilt[64] = "";
+        size_t rebuilt_size = 0;
+
+        for (const char* spec_cur = cur; spec_cur < spec.end - 1 && rebuilt_size + 24 < sizeof(rebuilt); ++spec_cur) {
+            if (*spec_cur == '*') {
+                long long star = 0;
+                log_pop(&args, args_end, &star, sizeof(star));
+                rebuilt_size += (size_t) snprintf(rebuilt + rebuilt_size, sizeof(rebuilt) - rebuilt_size, "%d", (int) star);
+            } else if (!strchr("hlLqjzt", *spec_cur)) {
+                rebuilt[rebuilt_size++] = *spec_cur;
+            }
+        }
+
+        switch (spec.conversion) {
+            case 'd': case 'i': case 'o': case 'u': case 'x': case 'X': {
+                memcpy(rebuilt + rebuilt_size, "ll", 2);
+                rebuilt[rebuilt_size + 2] = spec.conversion;
+
+                long long integer = 0;
+                log_pop(&args, args_end, &integer, sizeof(integer));
+                log_print_arg(rebuilt, integer);
+                break;
+            }
+            case 'c': {
+                rebuilt[rebuilt_size] = spec.conversion;
+
+                long long integer = 0;
+                log_pop(&args, args_end, &integer, sizeof(integer));
+                log_print_arg(rebuilt, (int) integer);
+                break;
+            }
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A': {
+                if (spec.length == 'L') {
+                    rebuilt[rebuilt_size] = 'L';
+                    rebuilt[rebuilt_size + 1] = spec.conversion;
+
+                    long double value = 0;
+                    log_pop(&args, args_end, &value, sizeof(value));
+                    log_print_arg(rebuilt, value);
+                } else {
+                    rebuilt[rebuilt_size] = spec.conversion;
+
+                    double value = 0;
+                    log_pop(&args, args_end, &value, sizeof(value));
+                    log_print_arg(rebuilt, value);
+                }
+                break;
+            }
+            case 's': {
+                rebuilt[rebuilt_size] = spec.conversion;
+
+                const char* string = args < args_end ? args : "";
+                args += args < args_end ? strnlen(args, (size_t) (args_end - args)) + 1 : 0;
+                log_print_arg(rebuilt, string);
+                break;
+            }
+            case 'p': {
+                rebuilt[rebuilt_size] = spec.conversion;
 
-    if (importance >= log_threshold && logfile) {
-        log_prefix(tag, importance);
-        vfprintf(log_file(importance), format, args);
-        fflush(log_file(importance));
+                const void* pointer = NULL;
+                log_pop(&args, args_end, &pointer, sizeof(pointer));
+                log_print_arg(rebuilt, pointer);
+                break;
+            }
+            default: break;
+        }
     }
 
+    fputs(text, logfile);
+}
+
+/**
+ * @brief Copy bytes of the ring, wrapping around its end.
+ */
+static void log_peek(const LogRing* ring, size_t position, void* value, size_t size) {
+    for (size_t byte_id = 0; byte_id < size; ++byte_id) {
+        ((char*) value)[byte_id] = ring->buffer[(position + byte_id) % LOG_RING_SIZE];
+    }
+}
+
+static void log_drain() {
+    alignas(LogRecord) char record[LOG_RECORD_SIZE] = "";
+
+    pthread_mutex_lock(&log_lock);
+
+    for (LogRing* ring = log_rings; ring; ring = ring->next) {
+        ring->drain_tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    }
+
+    //* Records of different threads are merged in the order of their time stamps.
+    for (;;) {
+        LogRing* first = NULL;
+        uint64_t first_tsc = 0;
+
+        for (LogRing* ring = log_rings; ring; ring = ring->next) {
+            if (ring->head == ring->drain_tail) continue;
+
+            uint64_t tsc = 0;
+            log_peek(ring, ring->head + offsetof(LogRecord, tsc), &tsc, sizeof(tsc));
+
+            if (!first || tsc < first_tsc) {
+                first = ring;
+                first_tsc = tsc;
+            }
+        }
+
+        if (!first) break;
+
+        uint32_t size = 0;
+        log_peek(first, first->head, &size, sizeof(size));
+        log_peek(first, first->head, record, size);
+
+        log_write((const LogRecord*) record);
+
+        __atomic_store_n(&first->head, first->head + size, __ATOMIC_RELEASE);
+    }
+
+    pthread_mutex_unlock(&log_lock);
+
+    fflush(logfile);
+}
+
+static void* log_writer_loop(void* arg) {
+    SILENCE_UNUSED(arg);
+
+    pthread_mutex_lock(&log_lock);
+
+    while (!log_stop) {
+        pthread_mutex_unlock(&log_lock);
+        log_drain();
+        pthread_mutex_lock(&log_lock);
+
+        if (log_stop) break;
+
+        struct timespec deadline = {};
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += LOG_FLUSH_INTERVAL_NS;
+        if (deadline.tv_nsec >= 1000000000) {
+            deadline.tv_nsec -= 1000000000;
+            ++deadline.tv_sec;
+        }
+
+        pthread_cond_timedwait(&log_wakeup, &log_lock, &deadline);
+    }
+
+    pthread_mutex_unlock(&log_lock);
+
+    log_drain();
+
+    return NULL;
+}
+
+/**
+ * @brief Get the ring of the current thread, taking a ring of an exited thread or creating a new one
+ * 
+ * @return ring of the thread (NULL if failed)
+ */
+static LogRing* log_ring() {
+    if (log_thread_ring.ring) return log_thread_ring.ring;
+
+    pthread_mutex_lock(&log_lock);
+
+    LogRing* ring = log_rings;
+    while (ring && !(__atomic_load_n(&ring->released, __ATOMIC_ACQUIRE) &&
+                     __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) == ring->tail)) ring = ring->next;
+
+    if (ring) {
+        ring->released = false;
+    } else if ((ring = (LogRing*) calloc(1, sizeof(*ring)))) {
+        ring->next = log_rings;
+        log_rings = ring;
+    }
+
+    pthread_mutex_unlock(&log_lock);
+
+    log_thread_ring.ring = ring;
+    return ring;
+}
+
+/**
+ * @brief Put the record to the ring of the current thread, waiting for the writer thread if the ring is full
+ * 
+ * @param record record followed by its arguments
+ * @return false if the thread has no ring
+ */
+static bool log_enqueue(const LogRecord* record) {
+    LogRing* ring = log_ring();
+    if (!ring) return false;
+
+    size_t tail = ring->tail;
+    size_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+
+    while (LOG_RING_SIZE - (tail - head) < record->size) {
+        pthread_cond_signal(&log_wakeup);
+        sched_yield();
+        head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    }
+
+    size_t offset = tail % LOG_RING_SIZE;
+    size_t first_part = LOG_RING_SIZE - offset < record->size ? LOG_RING_SIZE - offset : record->size;
+    memcpy(ring->buffer + offset, record, first_part);
+    memcpy(ring->buffer, (const char*) record + first_part, record->size - first_part);
+
+    __atomic_store_n(&ring->tail, tail + record->size, __ATOMIC_RELEASE);
+
+    //* Half-full ring is written right away, otherwise the writer thread wakes up on its own.
+    if (tail + record->size - head > LOG_RING_SIZE / 2) pthread_cond_signal(&log_wakeup);
+
+    return true;
+}
+
+static void log_prefix(uint64_t tsc, const char* tag) {
+    //* Time stamp counter frequency is measured over the time passed since the log was opened.
+    struct timespec now = {};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    uint64_t now_tsc = __rdtsc();
+
+    double elapsed_ns = (double) (now.tv_sec - log_start_clock.tv_sec) * 1e9 + (double) (now.tv_nsec - log_start_clock.tv_nsec);
+    double ticks_per_ns = elapsed_ns > 1e6 ? (double) (now_tsc - log_start_tsc) / elapsed_ns : 0.0;
+
+    time_t raw_time = log_start_time.tv_sec;
+    if (ticks_per_ns > 0.0 && tsc > log_start_tsc) {
+        raw_time += (time_t) (((double) (tsc - log_start_tsc) / ticks_per_ns + (double) log_start_time.tv_nsec) / 1e9);
+    }
+
+    struct tm time_info = {};
+    localtime_r(&raw_time, &time_info);
+
+    char pc_timestamp[32] = "";
+    asctime_r(&time_info, pc_timestamp);
+    pc_timestamp[strlen(pc_timestamp) - 1] = '\0';
+
+    fprintf(logfile, "%-20s [%s]:  ", pc_timestamp, tag);
+}
+
+static void _log_vrecord(const unsigned int importance, const char* tag, const char* file, int line, const char* format, va_list args) {
+    if (importance < log_threshold || !__atomic_load_n(&log_active, __ATOMIC_ACQUIRE)) return;
+
+    alignas(LogRecord) char buffer[LOG_RECORD_SIZE] = "";
+    LogRecord* record = (LogRecord*) buffer;
+
+    record->importance = importance;
+    record->tsc = __rdtsc();
+    record->tag = tag;
+    record->file = file;
+    record->line = line;
+    record->format = format;
+
+    size_t size = sizeof(*record) + log_pack(format, args, buffer + sizeof(*record), sizeof(buffer) - sizeof(*record));
+    record->size = (uint32_t) ((size + 7) / 8 * 8);
+
+    if (log_async && log_enqueue(record)) return;
+
+    pthread_mutex_lock(&log_lock);
+    if (logfile) log_write(record);
+    pthread_mutex_unlock(&log_lock);
+}
+
+void _log_record(const unsigned int importance, const char* tag, const char* file, int line, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    _log_vrecord(importance, tag, file, line, format, args);
     va_end(args);
 }
 
-static FILE* log_file(const unsigned int importance) {
-    return importance >= log_threshold ? logfile : NULL;
+void _log_printf(const unsigned int importance, const char* tag, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    _log_vrecord(importance, tag, NULL, 0, format, args);
+    va_end(args);
 }
 
 void log_close(int* error_code) {
-    if (!log_file()) return;
+    if (!logfile) return;
     log_printf(ABSOLUTE_IMPORTANCE, "close", "Closing log file.\n\n");
-    fprintf(log_file(ABSOLUTE_IMPORTANCE), "</pre>");
+
+    //* Lines recorded after this point are dropped.
+    __atomic_store_n(&log_active, false, __ATOMIC_RELEASE);
+
+    if (log_async) {
+        pthread_mutex_lock(&log_lock);
+        log_stop = true;
+        pthread_cond_signal(&log_wakeup);
+        pthread_mutex_unlock(&log_lock);
+
+        pthread_join(log_writer, NULL);
+        log_async = false;
+    }
+
+    pthread_mutex_lock(&log_lock);
+    fprintf(logfile, "</pre>");
     if (!fclose(logfile) && error_code) *error_code = ENOENT;
-}
\ No newline at end of file
+    logfile = NULL;
+    pthread_mutex_unlock(&log_lock);
+}
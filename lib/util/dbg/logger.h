@@ -36,9 +36,8 @@ enum IMPORTANCES {
  * @param tag prefix of the message
  * @param __VA_ARGS__ arguments as if they were in printf()
  */
-#define log_printf(importance, tag, ...) do {                                                            \
-    _log_printf(importance, tag, " ----- Called from %s:%d. -----\n", __FILE__, __LINE__);  \
-    _log_printf(importance, tag, __VA_ARGS__);                                                           \
+#define log_printf(importance, tag, ...) do {                       \
+    _log_record(importance, tag, __FILE__, __LINE__, __VA_ARGS__);  \
 } while(0)
 #else
 /**
@@ -48,8 +47,8 @@ enum IMPORTANCES {
  * @param tag prefix of the message
  * @param __VA_ARGS__ arguments as if they were in printf()
  */
-#define log_printf(importance, tag, ...) do { \
-    _log_printf(importance, tag, __VA_ARGS__);\
+#define log_printf(importance, tag, ...) do {               \
+    _log_record(importance, tag, NULL, 0, __VA_ARGS__);     \
 } while(0)
 #endif
 
@@ -70,6 +69,10 @@ enum IMPORTANCES {
     log_printf(importance, tag, __VA_ARGS__);   \
 } while (0)
 
+//* Lines are recorded as binary records (time stamp counter value, format string and arguments) to the ring
+//* of the calling thread and formatted and written by the background writer thread, so tags and format strings
+//* have to be string literals (string arguments are copied). Lines recorded right before the program crashes may be lost.
+
 /**
  * @brief Open log file or creates empty one.
  * 
@@ -79,6 +82,19 @@ enum IMPORTANCES {
  */
 void log_init(const char* filename = "log", const unsigned int threshold = 0, int* const error_code = NULL);
 
+/**
+ * @brief Record line to logs with automatic prefix followed by call information.
+ * 
+ * @param importance importance of the message
+ * @param tag message tag (string literal)
+ * @param file file the message was recorded from (NULL to skip call information)
+ * @param line line the message was recorded from
+ * @param format format string for printf() (string literal)
+ * @param ... arguments for printf()
+ */
+void _log_record(const unsigned int importance, const char* tag, const char* file, int line, const char* format, ...)
+    __attribute__((format (printf, 5, 6)));
+
 /**
  * @brief Print line to logs with automatic prefix.
  * 
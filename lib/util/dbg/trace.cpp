@@ -0,0 +1,192 @@
+#include "trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+
+//* Every thread records its spans to chunks of this many events.
+static const size_t TRACE_CHUNK_EVENTS = 1 << 15;
+
+/**
+ * @brief Recorded span.
+ * 
+ * @param name name of the span
+ * @param id id argument of the span (TRACE_NO_ID if none)
+ * @param start time stamp counter value at the start of the span
+ * @param end time stamp counter value at the end of the span (0 for instant events)
+ */
+struct TraceEvent {
+    const char* name;
+    int64_t id;
+    uint64_t start;
+    uint64_t end;
+};
+
+struct TraceChunk {
+    TraceEvent events[TRACE_CHUNK_EVENTS];
+    size_t size;
+    TraceChunk* next;
+};
+
+/**
+ * @brief Spans of one thread.
+ * 
+ * @param last chunk events are recorded to
+ * @param first first chunk of the thread
+ * @param thread_id system id of the thread
+ * @param next next buffer of the list of all buffers
+ */
+struct TraceBuffer {
+    TraceChunk* last;
+    TraceChunk* first;
+    long thread_id;
+    TraceBuffer* next;
+};
+
+static FILE* trace_file = NULL;
+static bool trace_active = false;
+
+//* Buffers of the threads are kept until the trace is written, so that spans of finished threads are not lost.
+static TraceBuffer* trace_buffers = NULL;
+static pthread_mutex_t trace_lock = PTHREAD_MUTEX_INITIALIZER;
+
+//* Number of the trace, so that buffers of the closed trace are not reused by the threads.
+static unsigned trace_generation = 0;
+static thread_local TraceBuffer* trace_thread_buffer = NULL;
+static thread_local unsigned trace_thread_generation = 0;
+
+static uint64_t trace_start_tsc = 0;
+static struct timespec trace_start_time = {};
+
+/**
+ * @brief Allocate chunk for the buffer of the current thread, registering the buffer if needed.
+ * 
+ * @return buffer with free space (NULL if failed)
+ */
+static TraceBuffer* trace_grow() {
+    //* Chunk pages are faulted in at once, as page faults on the first touch would cost more than the span itself.
+    TraceChunk* chunk = (TraceChunk*) mmap(NULL, sizeof(*chunk), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+    if (chunk == MAP_FAILED) return NULL;
+
+    TraceBuffer* buffer = trace_thread_buffer;
+
+    if (!buffer || trace_thread_generation != trace_generation) {
+        buffer = (TraceBuffer*) calloc(1, sizeof(*buffer));
+        if (!buffer) {
+            munmap(chunk, sizeof(*chunk));
+            return NULL;
+        }
+
+        buffer->thread_id = syscall(SYS_gettid);
+        buffer->first = chunk;
+        buffer->last = chunk;
+
+        pthread_mutex_lock(&trace_lock);
+        buffer->next = trace_buffers;
+        trace_buffers = buffer;
+        pthread_mutex_unlock(&trace_lock);
+
+        trace_thread_buffer = buffer;
+        trace_thread_generation = trace_generation;
+
+        return buffer;
+    }
+
+    buffer->last->next = chunk;
+    buffer->last = chunk;
+
+    return buffer;
+}
+
+void trace_open(const char* file_name, err_anchor_t err_code) {
+    _LOG_FAIL_CHECK_(file_name && !trace_file, "error", ERROR_REPORTS, return, err_code, EINVAL);
+
+    trace_file = fopen(file_name, "w");
+    _LOG_FAIL_CHECK_(trace_file, "error", ERROR_REPORTS, return, err_code, ENOENT);
+
+    ++trace_generation;
+
+    clock_gettime(CLOCK_MONOTONIC_RAW, &trace_start_time);
+    trace_start_tsc = __rdtsc();
+
+    __atomic_store_n(&trace_active, true, __ATOMIC_RELEASE);
+
+    log_printf(STATUS_REPORTS, "status", "Recording trace to %s.\n", file_name);
+}
+
+void _trace_record(const char* name, int64_t id, uint64_t start, uint64_t end) {
+    if (!__atomic_load_n(&trace_active, __ATOMIC_RELAXED)) return;
+
+    TraceBuffer* buffer = trace_thread_buffer;
+
+    if (!buffer || trace_thread_generation != trace_generation || buffer->last->size == TRACE_CHUNK_EVENTS) {
+        buffer = trace_grow();
+        if (!buffer) return;
+    }
+
+    TraceChunk* chunk = buffer->last;
+    chunk->events[chunk->size++] = { .name = name, .id = id, .start = start, .end = end };
+}
+
+void trace_close() {
+    if (!__atomic_load_n(&trace_active, __ATOMIC_ACQUIRE)) return;
+
+    __atomic_store_n(&trace_active, false, __ATOMIC_RELEASE);
+
+    struct timespec end_time = {};
+    clock_gettime(CLOCK_MONOTONIC_RAW, &end_time);
+    uint64_t end_tsc = __rdtsc();
+
+    //* Time stamp counter is converted to microseconds of the trace format with the rate measured over the whole run.
+    double elapsed_us = (double) (end_time.tv_sec - trace_start_time.tv_sec) * 1e6 +
+                        (double) (end_time.tv_nsec - trace_start_time.tv_nsec) / 1e3;
+    double ticks_per_us = elapsed_us > 0.0 ? (double) (end_tsc - trace_start_tsc) / elapsed_us : 1.0;
+
+    long process_id = (long) getpid();
+    size_t event_count = 0;
+
+    fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n", trace_file);
+
+    pthread_mutex_lock(&trace_lock);
+
+    for (TraceBuffer* buffer = trace_buffers; buffer;) {
+        for (TraceChunk* chunk = buffer->first; chunk;) {
+            for (size_t event_id = 0; event_id < chunk->size; ++event_id) {
+                const TraceEvent* event = &chunk->events[event_id];
+
+                fprintf(trace_file, "%s{\"name\":\"%s\",\"cat\":\"hash\",\"pid\":%ld,\"tid\":%ld,\"ts\":%.3lf", event_count ? ",\n" : "",
+                        event->name, process_id, buffer->thread_id, (double) (event->start - trace_start_tsc) / ticks_per_us);
+
+                if (event->end) fprintf(trace_file, ",\"ph\":\"X\",\"dur\":%.3lf", (double) (event->end - event->start) / ticks_per_us);
+                else fputs(",\"ph\":\"i\",\"s\":\"t\"", trace_file);
+
+                if (event->id != TRACE_NO_ID) fprintf(trace_file, ",\"args\":{\"id\":%lld}", (long long) event->id);
+
+                fputc('}', trace_file);
+                ++event_count;
+            }
+
+            TraceChunk* next_chunk = chunk->next;
+            munmap(chunk, sizeof(*chunk));
+            chunk = next_chunk;
+        }
+
+        TraceBuffer* next_buffer = buffer->next;
+        free(buffer);
+        buffer = next_buffer;
+    }
+
+    trace_buffers = NULL;
+
+    pthread_mutex_unlock(&trace_lock);
+
+    fputs("\n]}\n", trace_file);
+    fclose(trace_file);
+    trace_file = NULL;
+
+    log_printf(STATUS_REPORTS, "status", "Trace of %lu events was written.\n", event_count);
+}
@@ -0,0 +1,104 @@
+/**
+ * @file trace.h
+ * @author Ilya Kudryashov (kudriashov.it@phystech.edu)
+ * @brief Scoped spans of program phases written as Chrome trace events.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2022
+ * 
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include <x86intrin.h>
+
+#include "debug.h"
+
+//* Span names are stored as pointers and printed after the program has finished, so they should be string literals.
+//* Spans are only recorded if the program is built with TRACE_SPANS defined.
+
+//* Id of the span that has no id argument.
+static const int64_t TRACE_NO_ID = INT64_MIN;
+
+/**
+ * @brief Start recording spans (trace_close() should be called to write them to the file).
+ * 
+ * @param file_name name of the trace file (opened with chrome://tracing or ui.perfetto.dev)
+ * @param err_code variable to use as errno
+ */
+void trace_open(const char* file_name, ERROR_MARKER);
+
+/**
+ * @brief Stop recording spans and write them to the trace file (other threads should not record spans at the moment).
+ */
+void trace_close();
+
+/**
+ * @brief [Should only be called by TRACE_ macros] Record the span of the current thread.
+ * 
+ * @param name name of the span
+ * @param id id argument of the span (TRACE_NO_ID if none)
+ * @param start time stamp counter value at the start of the span
+ * @param end time stamp counter value at the end of the span (0 for instant events)
+ */
+void _trace_record(const char* name, int64_t id, uint64_t start, uint64_t end);
+
+/**
+ * @brief Span recorded when the variable goes out of scope.
+ * 
+ * @param name name of the span
+ * @param id id argument of the span
+ * @param start time stamp counter value at the start of the span
+ */
+struct TraceSpan {
+    const char* name;
+    int64_t id;
+    uint64_t start;
+
+    TraceSpan(const char* span_name, int64_t span_id) : name(span_name), id(span_id), start(__rdtsc()) {}
+    ~TraceSpan() { _trace_record(name, id, start, __rdtsc()); }
+
+    TraceSpan(const TraceSpan& span) = delete;
+    TraceSpan& operator=(const TraceSpan& span) = delete;
+};
+
+#define _TRACE_CONCAT_(alpha, beta) alpha##beta
+#define _TRACE_VARIABLE_(line) _TRACE_CONCAT_(_trace_span_, line)
+
+#ifdef TRACE_SPANS
+
+/**
+ * @brief Record span from this line to the end of the scope.
+ * 
+ * @param name name of the span (string literal)
+ */
+#define TRACE_SPAN(name) TraceSpan _TRACE_VARIABLE_(__LINE__)(name, TRACE_NO_ID)
+
+/**
+ * @brief Record span from this line to the end of the scope with an id argument.
+ * 
+ * @param name name of the span (string literal)
+ * @param id integer id of the span (test number, bucket index, ...)
+ */
+#define TRACE_SPAN_ID(name, id) TraceSpan _TRACE_VARIABLE_(__LINE__)(name, (int64_t) (id))
+
+/**
+ * @brief Record instant event.
+ * 
+ * @param name name of the event (string literal)
+ * @param id integer id of the event
+ */
+#define TRACE_INSTANT(name, id) _trace_record(name, (int64_t) (id), __rdtsc(), 0)
+
+#else
+
+#define TRACE_SPAN(name)
+#define TRACE_SPAN_ID(name, id)
+#define TRACE_INSTANT(name, id) do { SILENCE_UNUSED(id); } while(0)
+
+#endif
+
+#endif
@@ -0,0 +1,208 @@
+#include "compare.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+static const size_t DFLT_RESULT_SET_CAPACITY = 8;
+static const size_t RESULT_LINE_LENGTH = 1024;
+static const size_t DFLT_SAMPLE_CAPACITY = 64;
+
+//* Names of the verdicts in the order of COMPARISON_VERDICT.
+static const char* const VERDICT_NAMES[] = { "noise", "faster", "slower" };
+
+void ResultSet_dtor(ResultSet* set) {
+    if (!set) return;
+
+    free(set->results);
+    *set = {};
+}
+
+void ResultSet_add(ResultSet* set, const char* name, const SampleSummary* summary, err_anchor_t err_code) {
+    _LOG_FAIL_CHECK_(set && name && summary, "error", ERROR_REPORTS, return, err_code, EINVAL);
+
+    if (set->size == set->capacity) {
+        size_t capacity = set->capacity ? set->capacity * 2 : DFLT_RESULT_SET_CAPACITY;
+
+        WorkloadResult* results = (WorkloadResult*) realloc(set->results, capacity * sizeof(*results));
+        _LOG_FAIL_CHECK_(results, "error", ERROR_REPORTS, return, err_code, ENOMEM);
+
+        set->results = results;
+        set->capacity = capacity;
+    }
+
+    WorkloadResult* result = &set->results[set->size++];
+    *result = {};
+    strncpy(result->name, name, RESULT_NAME_LENGTH - 1);
+    result->summary = *summary;
+}
+
+const WorkloadResult* ResultSet_find(const ResultSet* set, const char* name) {
+    _LOG_FAIL_CHECK_(set && name, "error", ERROR_REPORTS, return NULL, NULL, EINVAL);
+
+    for (size_t result_id = 0; result_id < set->size; ++result_id) {
+        if (strcmp(set->results[result_id].name, name) == 0) return &set->results[result_id];
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Read the "time" column of the per-test timetable and summarize it
+ * 
+ * @param file file positioned after the header
+ * @param set result set to add the summary to
+ * @param err_code variable to use as errno
+ * @return 0 on success, -1 otherwise
+ */
+static int read_timetable(FILE* file, ResultSet* set, err_anchor_t err_code) {
+    size_t count = 0, capacity = DFLT_SAMPLE_CAPACITY;
+    double* samples = (double*) calloc(capacity, sizeof(*samples));
+    _LOG_FAIL_CHECK_(samples, "error", ERROR_REPORTS, return -1, err_code, ENOMEM);
+
+    char line[RESULT_LINE_LENGTH] = "";
+    while (fgets(line, (int) sizeof(line), file)) {
+        unsigned test_id = 0;
+        double time = 0.0;
+        if (sscanf(line, "%u,%lf", &test_id, &time) != 2) continue;
+
+        if (count == capacity) {
+            double* new_samples = (double*) realloc(samples, capacity * 2 * sizeof(*samples));
+            _LOG_FAIL_CHECK_(new_samples, "error", ERROR_REPORTS, { free(samples); return -1; }, err_code, ENOMEM);
+
+            samples = new_samples;
+            capacity *= 2;
+        }
+
+        samples[count++] = time;
+    }
+
+    if (count) {
+        SampleSummary summary = summarize_samples(samples, count);
+        ResultSet_add(set, "bmark", &summary, err_code);
+    }
+
+    free(samples);
+
+    return count ? 0 : -1;
+}
+
+/**
+ * @brief Read rows of the benchmark runner summary
+ * 
+ * @param file file positioned after the header
+ * @param set result set to add the rows to
+ * @param err_code variable to use as errno
+ * @return 0 on success, -1 otherwise
+ */
+static int read_summary(FILE* file, ResultSet* set, err_anchor_t err_code) {
+    size_t initial_size = set->size;
+
+    char line[RESULT_LINE_LENGTH] = "";
+    while (fgets(line, (int) sizeof(line), file)) {
+        char name[RESULT_NAME_LENGTH] = "";
+        size_t operation_count = 0;
+        SampleSummary summary = {};
+
+        //* Names are limited by RESULT_NAME_LENGTH - 1 = 63 characters.
+        if (sscanf(line, "%63[^,],%lu,%lu,%lf,%lf,%lf,%lf,%lf,%lf", name, &summary.count, &operation_count,
+                   &summary.mean, &summary.stddev, &summary.ci_low, &summary.ci_high, &summary.min, &summary.max) != 9) continue;
+
+        ResultSet_add(set, name, &summary, err_code);
+    }
+
+    return set->size > initial_size ? 0 : -1;
+}
+
+int read_results(const char* file_name, ResultSet* set, err_anchor_t err_code) {
+    _LOG_FAIL_CHECK_(file_name && set, "error", ERROR_REPORTS, return -1, err_code, EINVAL);
+
+    FILE* file = fopen(file_name, "r");
+    _LOG_FAIL_CHECK_(file, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Failed to open result file %s.\n", file_name);
+        return -1;
+    }, err_code, ENOENT);
+
+    char header[RESULT_LINE_LENGTH] = "";
+    int status = -1;
+
+    if (fgets(header, (int) sizeof(header), file)) {
+        if (strncmp(header, "test_id,time", strlen("test_id,time")) == 0) status = read_timetable(file, set, err_code);
+        else if (strncmp(header, "workload,", strlen("workload,")) == 0) status = read_summary(file, set, err_code);
+    }
+
+    fclose(file);
+
+    _LOG_FAIL_CHECK_(status == 0, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "File %s does not contain benchmark results.\n", file_name);
+        return -1;
+    }, err_code, EINVAL);
+
+    return 0;
+}
+
+Comparison compare_summaries(const SampleSummary* baseline, const SampleSummary* candidate) {
+    Comparison comparison = {};
+    _LOG_FAIL_CHECK_(baseline && candidate, "error", ERROR_REPORTS, return comparison, NULL, EINVAL);
+    _LOG_FAIL_CHECK_(baseline->mean > 0.0 && candidate->mean > 0.0, "error", ERROR_REPORTS, return comparison, NULL, EINVAL);
+
+    double baseline_variance = baseline->count ? baseline->stddev * baseline->stddev / (double) baseline->count : 0.0;
+    double candidate_variance = candidate->count ? candidate->stddev * candidate->stddev / (double) candidate->count : 0.0;
+    double variance = baseline_variance + candidate_variance;
+
+    comparison.speedup = baseline->mean / candidate->mean;
+
+    //* Both results are exact (or single measurements), nothing to test.
+    if (variance <= 0.0 || baseline->count < 2 || candidate->count < 2) {
+        comparison.ci_low = comparison.ci_high = comparison.speedup;
+        return comparison;
+    }
+
+    comparison.t = (baseline->mean - candidate->mean) / sqrt(variance);
+    comparison.degrees_of_freedom = variance * variance /
+        (baseline_variance * baseline_variance / (double) (baseline->count - 1) +
+         candidate_variance * candidate_variance / (double) (candidate->count - 1));
+
+    double critical = student_t_critical(comparison.degrees_of_freedom);
+
+    //* Delta method estimate of the standard error of the ratio of means.
+    double ratio_error = comparison.speedup * sqrt(baseline_variance / (baseline->mean * baseline->mean) +
+                                                   candidate_variance / (candidate->mean * candidate->mean));
+    comparison.ci_low = comparison.speedup - critical * ratio_error;
+    comparison.ci_high = comparison.speedup + critical * ratio_error;
+
+    if (comparison.t > critical) comparison.verdict = VERDICT_FASTER;
+    else if (comparison.t < -critical) comparison.verdict = VERDICT_SLOWER;
+
+    return comparison;
+}
+
+size_t compare_results(const ResultSet* baseline, const ResultSet* candidate, double threshold, FILE* file) {
+    _LOG_FAIL_CHECK_(baseline && candidate && file, "error", ERROR_REPORTS, return 0, NULL, EINVAL);
+
+    size_t regression_count = 0;
+
+    fprintf(file, "workload,baseline_mean,candidate_mean,speedup,speedup_ci95_low,speedup_ci95_high,t,dof,verdict,regression\n");
+
+    for (size_t result_id = 0; result_id < candidate->size; ++result_id) {
+        const WorkloadResult* candidate_result = &candidate->results[result_id];
+        const WorkloadResult* baseline_result = ResultSet_find(baseline, candidate_result->name);
+
+        if (!baseline_result) {
+            log_printf(WARNINGS, "warning", "Workload %s is missing in the baseline.\n", candidate_result->name);
+            continue;
+        }
+
+        Comparison comparison = compare_summaries(&baseline_result->summary, &candidate_result->summary);
+
+        bool regression = comparison.verdict == VERDICT_SLOWER && comparison.speedup < 1.0 - threshold;
+        if (regression) ++regression_count;
+
+        fprintf(file, "%s,%lg,%lg,%lg,%lg,%lg,%lg,%lg,%s,%s\n", candidate_result->name,
+            baseline_result->summary.mean, candidate_result->summary.mean,
+            comparison.speedup, comparison.ci_low, comparison.ci_high, comparison.t, comparison.degrees_of_freedom,
+            VERDICT_NAMES[comparison.verdict], regression ? "yes" : "no");
+    }
+
+    return regression_count;
+}
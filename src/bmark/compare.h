@@ -0,0 +1,132 @@
+/**
+ * @file compare.h
+ * @author Kudryashov Ilya (kudriashov.it@phystech.edu)
+ * @brief Comparison of benchmark results with Welch's t-test.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2023
+ * 
+ */
+
+#ifndef BMARK_COMPARE_H
+#define BMARK_COMPARE_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+#include "lib/util/dbg/debug.h"
+
+#include "summary.h"
+
+static const size_t RESULT_NAME_LENGTH = 64;
+
+/**
+ * @brief Summary of measurements of one workload.
+ * 
+ * @param name name of the workload
+ * @param summary summary of the measurements
+ */
+struct WorkloadResult {
+    char name[RESULT_NAME_LENGTH] = "";
+    SampleSummary summary = {};
+};
+
+/**
+ * @brief Results of one benchmark run.
+ * 
+ * @param results array of workload results
+ * @param size number of results
+ * @param capacity capacity of the array
+ */
+struct ResultSet {
+    WorkloadResult* results = NULL;
+    size_t size = 0;
+    size_t capacity = 0;
+};
+
+enum COMPARISON_VERDICT {
+    VERDICT_NOISE,
+    VERDICT_FASTER,
+    VERDICT_SLOWER,
+};
+
+/**
+ * @brief Comparison of the candidate result with the baseline one (lower values are better).
+ * 
+ * @param speedup ratio of the baseline mean to the candidate mean
+ * @param ci_low lower bound of the 95% confidence interval of the speedup
+ * @param ci_high upper bound of the 95% confidence interval of the speedup
+ * @param t Welch's t statistic
+ * @param degrees_of_freedom Welch-Satterthwaite degrees of freedom
+ * @param verdict whether the difference is significant at the 95% level
+ */
+struct Comparison {
+    double speedup = 1.0;
+    double ci_low = 1.0;
+    double ci_high = 1.0;
+    double t = 0.0;
+    double degrees_of_freedom = 0.0;
+    COMPARISON_VERDICT verdict = VERDICT_NOISE;
+};
+
+/**
+ * @brief Destroy the result set.
+ * 
+ * @param set pointer to the result set
+ */
+void ResultSet_dtor(ResultSet* set);
+
+/**
+ * @brief Add workload result to the set.
+ * 
+ * @param set pointer to the result set
+ * @param name name of the workload (truncated to RESULT_NAME_LENGTH - 1 characters)
+ * @param summary summary of the measurements
+ * @param err_code variable to use as errno
+ */
+void ResultSet_add(ResultSet* set, const char* name, const SampleSummary* summary, ERROR_MARKER);
+
+/**
+ * @brief Find result of the workload.
+ * 
+ * @param set pointer to the result set
+ * @param name name of the workload
+ * @return pointer to the result (NULL if not found)
+ */
+const WorkloadResult* ResultSet_find(const ResultSet* set, const char* name);
+
+/**
+ * @brief Read benchmark results from the file.
+ * 
+ * Understands per-test timetables ("test_id,time" header, summarized as the workload "bmark")
+ * and CSV summaries printed by the benchmark runner (one row per workload, repeated headers are skipped).
+ * 
+ * @param file_name name of the file
+ * @param set result set to add results to
+ * @param err_code variable to use as errno
+ * @return 0 if the file was read, -1 otherwise
+ */
+int read_results(const char* file_name, ResultSet* set, ERROR_MARKER);
+
+/**
+ * @brief Compare two summaries with Welch's t-test.
+ * 
+ * @param baseline summary of the baseline measurements
+ * @param candidate summary of the candidate measurements
+ * @return comparison
+ */
+Comparison compare_summaries(const SampleSummary* baseline, const SampleSummary* candidate);
+
+/**
+ * @brief Compare results of every workload present in both sets and print the comparison as CSV.
+ * 
+ * @param baseline baseline results
+ * @param candidate candidate results
+ * @param threshold largest tolerated slowdown (0.05 tolerates candidates up to 5% slower)
+ * @param file file to print to
+ * @return number of workloads significantly slower than the baseline by more than the threshold
+ */
+size_t compare_results(const ResultSet* baseline, const ResultSet* candidate, double threshold, FILE* file);
+
+#endif
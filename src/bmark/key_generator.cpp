@@ -0,0 +1,191 @@
+#include "key_generator.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lib/util/dbg/debug.h"
+
+#include "src/utils/config.h"
+
+/**
+ * @brief State of the splitmix64 generator (rand() is too slow and too narrow for hundreds of millions of keys)
+ * 
+ * @param state current state
+ */
+struct KeyRandom {
+    uint64_t state = 0;
+};
+
+static uint64_t KeyRandom_next(KeyRandom* random) {
+    uint64_t value = (random->state += 0x9E3779B97F4A7C15ull);
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
+}
+
+static double KeyRandom_uniform(KeyRandom* random) {
+    return (double) (KeyRandom_next(random) >> 11) / (double) (1ull << 53);
+}
+
+/**
+ * @brief Generator state shared by word and token generation.
+ * 
+ * @param config generator parameters
+ * @param alphabet_size number of characters in the alphabet
+ * @param id_length number of characters needed to write any key index in the alphabet
+ * @param max_length largest key length
+ * @param random random generator
+ */
+struct KeyGenerator {
+    const KeyGeneratorConfig* config = NULL;
+    size_t alphabet_size = 0;
+    size_t id_length = 0;
+    size_t max_length = 0;
+    KeyRandom random = {};
+};
+
+/**
+ * @brief Prepare generator state
+ * 
+ * @param generator state to initialize
+ * @param config generator parameters
+ * @param length_limit largest supported key length
+ * @return true if the parameters are valid
+ */
+static bool KeyGenerator_ctor(KeyGenerator* generator, const KeyGeneratorConfig* config, size_t length_limit) {
+    _LOG_FAIL_CHECK_(config && config->alphabet && config->key_count, "error", ERROR_REPORTS, return false, NULL, EINVAL);
+
+    generator->config = config;
+    generator->alphabet_size = strlen(config->alphabet);
+    generator->random = { .state = config->seed };
+
+    _LOG_FAIL_CHECK_(generator->alphabet_size >= 2, "error", ERROR_REPORTS, return false, NULL, EINVAL);
+    _LOG_FAIL_CHECK_(config->min_length <= config->max_length, "error", ERROR_REPORTS, return false, NULL, EINVAL);
+
+    generator->id_length = 1;
+    for (size_t capacity = generator->alphabet_size; capacity < config->key_count; capacity *= generator->alphabet_size) {
+        ++generator->id_length;
+    }
+
+    generator->max_length = config->max_length < length_limit ? config->max_length : length_limit;
+
+    _LOG_FAIL_CHECK_(generator->id_length <= generator->max_length, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "%lu distinct keys need at least %lu characters.\n", config->key_count, generator->id_length);
+        return false;
+    }, NULL, EINVAL);
+
+    return true;
+}
+
+/**
+ * @brief Write the next distinct key
+ * 
+ * @param generator generator state
+ * @param key_id index of the key
+ * @param destination buffer of at least max_length bytes
+ * @return length of the key
+ */
+static size_t KeyGenerator_write(KeyGenerator* generator, size_t key_id, char* destination) {
+    const KeyGeneratorConfig* config = generator->config;
+
+    size_t length = config->min_length + KeyRandom_next(&generator->random) % (config->max_length - config->min_length + 1);
+    if (length > generator->max_length) length = generator->max_length;
+    if (length < generator->id_length) length = generator->id_length;
+
+    size_t random_length = length - generator->id_length;
+    for (size_t char_id = 0; char_id < random_length; ++char_id) {
+        destination[char_id] = config->alphabet[KeyRandom_next(&generator->random) % generator->alphabet_size];
+    }
+
+    for (size_t char_id = length; char_id > random_length; --char_id) {
+        destination[char_id - 1] = config->alphabet[key_id % generator->alphabet_size];
+        key_id /= generator->alphabet_size;
+    }
+
+    return length;
+}
+
+/**
+ * @brief Decide whether the key should repeat one of the previous keys
+ * 
+ * @param generator generator state
+ * @param key_id index of the key
+ * @return index of the repeated key (key_id if the key should be new)
+ */
+static size_t KeyGenerator_pick_duplicate(KeyGenerator* generator, size_t key_id) {
+    if (key_id == 0 || KeyRandom_uniform(&generator->random) >= generator->config->duplicate_rate) return key_id;
+
+    return KeyRandom_next(&generator->random) % key_id;
+}
+
+bool parse_length_range(const char* spec, KeyGeneratorConfig* config) {
+    _LOG_FAIL_CHECK_(spec && config, "error", ERROR_REPORTS, return false, NULL, EINVAL);
+
+    size_t min_length = 0, max_length = 0;
+    int parsed_length = 0;
+
+    if (sscanf(spec, "%lu:%lu%n", &min_length, &max_length, &parsed_length) != 2) return false;
+    if (spec[parsed_length] != '\0' || min_length == 0 || min_length > max_length) return false;
+
+    config->min_length = min_length;
+    config->max_length = max_length;
+
+    return true;
+}
+
+size_t generate_words(const KeyGeneratorConfig* config, const char** buffer_ptr) {
+    KeyGenerator generator = {};
+    if (!KeyGenerator_ctor(&generator, config, MAX_WORD_LENGTH - 1)) return 0;
+
+    char* words = (char*) aligned_alloc(MAX_WORD_LENGTH, config->key_count * MAX_WORD_LENGTH);
+    _LOG_FAIL_CHECK_(words, "error", ERROR_REPORTS, return 0, NULL, ENOMEM);
+
+    memset(words, 0, config->key_count * MAX_WORD_LENGTH);
+
+    for (size_t word_id = 0; word_id < config->key_count; ++word_id) {
+        char* word = words + word_id * MAX_WORD_LENGTH;
+        size_t original_id = KeyGenerator_pick_duplicate(&generator, word_id);
+
+        if (original_id != word_id) memcpy(word, words + original_id * MAX_WORD_LENGTH, MAX_WORD_LENGTH);
+        else KeyGenerator_write(&generator, word_id, word);
+    }
+
+    log_printf(STATUS_REPORTS, "status", "Generated %lu words.\n", config->key_count);
+
+    *buffer_ptr = words;
+
+    return config->key_count;
+}
+
+size_t generate_tokens(const KeyGeneratorConfig* config, StringKey** keys_ptr) {
+    KeyGenerator generator = {};
+    if (!KeyGenerator_ctor(&generator, config, SIZE_MAX)) return 0;
+
+    //* Storage is sized for the longest keys, the same layout as in read_tokens().
+    size_t slot_size = padded_token_length(generator.max_length);
+
+    StringKey* keys = (StringKey*) calloc(config->key_count * (sizeof(*keys) + slot_size), 1);
+    _LOG_FAIL_CHECK_(keys, "error", ERROR_REPORTS, return 0, NULL, ENOMEM);
+
+    char* storage = (char*) (keys + config->key_count);
+
+    for (size_t key_id = 0; key_id < config->key_count; ++key_id) {
+        size_t original_id = KeyGenerator_pick_duplicate(&generator, key_id);
+
+        if (original_id != key_id) {
+            keys[key_id] = keys[original_id];
+            continue;
+        }
+
+        size_t length = KeyGenerator_write(&generator, key_id, storage);
+        keys[key_id] = { .begin = storage, .length = length };
+        storage += padded_token_length(length);
+    }
+
+    log_printf(STATUS_REPORTS, "status", "Generated %lu keys.\n", config->key_count);
+
+    *keys_ptr = keys;
+
+    return config->key_count;
+}
@@ -0,0 +1,71 @@
+/**
+ * @file key_generator.h
+ * @author Kudryashov Ilya (kudriashov.it@phystech.edu)
+ * @brief Generator of synthetic word-like keys.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2023
+ * 
+ */
+
+#ifndef KEY_GENERATOR_H
+#define KEY_GENERATOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "src/utils/config.h"
+#include "src/text_parser/text_parser.h"
+
+/**
+ * @brief Parameters of generated keys.
+ * 
+ * @param key_count number of keys to generate
+ * @param min_length smallest key length
+ * @param max_length largest key length (lengths are distributed uniformly)
+ * @param alphabet characters keys consist of
+ * @param duplicate_rate share of keys repeating one of the previously generated keys
+ * @param seed seed of the random generator
+ */
+struct KeyGeneratorConfig {
+    size_t key_count = 0;
+    size_t min_length = DFLT_GENERATED_MIN_LENGTH;
+    size_t max_length = DFLT_GENERATED_MAX_LENGTH;
+    const char* alphabet = DFLT_GENERATED_ALPHABET;
+    double duplicate_rate = 0.0;
+    uint64_t seed = QUERY_SEED;
+};
+
+/**
+ * @brief Read key length range from the string of the form "min:max".
+ * 
+ * @param spec string to parse (for example, "3:12")
+ * @param config generator parameters to store the range to
+ * @return true if the string was valid
+ */
+bool parse_length_range(const char* spec, KeyGeneratorConfig* config);
+
+/**
+ * @brief Generate word list in the format of read_words(): keys are padded with zeros to MAX_WORD_LENGTH bytes.
+ * 
+ * Distinct keys are guaranteed to differ: every key ends with its index written in the alphabet.
+ * 
+ * @param config generator parameters (lengths are limited by MAX_WORD_LENGTH - 1)
+ * @param buffer_ptr variable to store the aligned word list to (should be freed by the caller)
+ * @return number of generated words (0 if failed)
+ */
+size_t generate_words(const KeyGeneratorConfig* config, const char** buffer_ptr);
+
+/**
+ * @brief Generate key list in the format of read_tokens().
+ * 
+ * Distinct keys are guaranteed to differ: every key ends with its index written in the alphabet.
+ * 
+ * @param config generator parameters
+ * @param keys_ptr variable to store the key array to (should be freed by the caller)
+ * @return number of generated keys (0 if failed)
+ */
+size_t generate_tokens(const KeyGeneratorConfig* config, StringKey** keys_ptr);
+
+#endif
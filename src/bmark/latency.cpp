@@ -0,0 +1,127 @@
+#include "latency.h"
+
+#include <sched.h>
+#include <time.h>
+
+#include "lib/util/dbg/debug.h"
+
+//* Calibration spins for this long, so that the error of the clock readings is negligible.
+static const uint64_t TSC_CALIBRATION_NS = 50000000;
+static const unsigned TSC_OVERHEAD_SAMPLES = 1000;
+
+static uint64_t monotonic_ns() {
+    struct timespec time_point = {};
+    clock_gettime(CLOCK_MONOTONIC_RAW, &time_point);
+    return (uint64_t) time_point.tv_sec * 1000000000ull + (uint64_t) time_point.tv_nsec;
+}
+
+double tsc_calibrate() {
+    uint64_t start_ns = monotonic_ns();
+    uint64_t start_ticks = tsc_begin();
+
+    uint64_t end_ns = start_ns;
+    while (end_ns - start_ns < TSC_CALIBRATION_NS) end_ns = monotonic_ns();
+
+    uint64_t end_ticks = tsc_end();
+
+    double ticks_per_ns = (double) (end_ticks - start_ticks) / (double) (end_ns - start_ns);
+
+    log_printf(STATUS_REPORTS, "status", "TSC runs at %lg ticks per nanosecond.\n", ticks_per_ns);
+
+    return ticks_per_ns;
+}
+
+uint64_t tsc_overhead() {
+    uint64_t overhead = UINT64_MAX;
+
+    for (unsigned sample_id = 0; sample_id < TSC_OVERHEAD_SAMPLES; ++sample_id) {
+        uint64_t start = tsc_begin();
+        uint64_t end = tsc_end();
+        if (end - start < overhead) overhead = end - start;
+    }
+
+    log_printf(STATUS_REPORTS, "status", "TSC read overhead is %lu ticks.\n", overhead);
+
+    return overhead;
+}
+
+int pin_thread(int cpu_id) {
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET((unsigned) cpu_id, &cpu_set);
+
+    _LOG_FAIL_CHECK_(sched_setaffinity(0, sizeof(cpu_set), &cpu_set) == 0, "warning", WARNINGS, return -1, NULL, 0);
+
+    log_printf(STATUS_REPORTS, "status", "Thread was pinned to processor %d.\n", cpu_id);
+
+    return 0;
+}
+
+/**
+ * @brief Get index of the histogram bin for the value
+ * 
+ * @param ticks value
+ * @return bin index
+ */
+static size_t latency_bin(uint64_t ticks) {
+    if (ticks < LATENCY_SUB_BUCKET_COUNT) return ticks;
+
+    unsigned magnitude = 63u - (unsigned) __builtin_clzll(ticks);
+    unsigned shift = magnitude - LATENCY_SUB_BUCKET_BITS;
+
+    return (shift + 1) * LATENCY_SUB_BUCKET_COUNT + ((ticks >> shift) & (LATENCY_SUB_BUCKET_COUNT - 1));
+}
+
+/**
+ * @brief Get the largest value falling into the bin
+ * 
+ * @param bin bin index
+ * @return upper bound of the bin
+ */
+static uint64_t latency_bin_upper(size_t bin) {
+    if (bin < LATENCY_SUB_BUCKET_COUNT) return bin;
+
+    uint64_t shift = bin / LATENCY_SUB_BUCKET_COUNT - 1;
+    uint64_t lower = (LATENCY_SUB_BUCKET_COUNT + bin % LATENCY_SUB_BUCKET_COUNT) << shift;
+
+    return lower + (1ull << shift) - 1;
+}
+
+void LatencyHistogram_record(LatencyHistogram* histogram, uint64_t ticks) {
+    ++histogram->counts[latency_bin(ticks)];
+    ++histogram->total;
+
+    if (ticks < histogram->min) histogram->min = ticks;
+    if (ticks > histogram->max) histogram->max = ticks;
+}
+
+uint64_t LatencyHistogram_percentile(const LatencyHistogram* histogram, double quantile) {
+    _LOG_FAIL_CHECK_(histogram, "error", ERROR_REPORTS, return 0, NULL, EINVAL);
+
+    if (histogram->total == 0) return 0;
+
+    uint64_t rank = (uint64_t) (quantile * (double) histogram->total);
+    if (rank >= histogram->total) rank = histogram->total - 1;
+
+    uint64_t passed = 0;
+    for (size_t bin = 0; bin < LATENCY_BIN_COUNT; ++bin) {
+        passed += histogram->counts[bin];
+        if (passed > rank) {
+            uint64_t upper = latency_bin_upper(bin);
+            return upper < histogram->max ? upper : histogram->max;
+        }
+    }
+
+    return histogram->max;
+}
+
+void LatencyHistogram_print(const LatencyHistogram* histogram, FILE* file, const char* operation, double ticks_per_ns) {
+    _LOG_FAIL_CHECK_(histogram && file && operation, "error", ERROR_REPORTS, return, NULL, EINVAL);
+
+    fprintf(file, "%s,%lu,%.1lf,%.1lf,%.1lf,%.1lf,%.1lf\n", operation, histogram->total,
+        (double) (histogram->total ? histogram->min : 0) / ticks_per_ns,
+        (double) LatencyHistogram_percentile(histogram, 0.5) / ticks_per_ns,
+        (double) LatencyHistogram_percentile(histogram, 0.99) / ticks_per_ns,
+        (double) LatencyHistogram_percentile(histogram, 0.999) / ticks_per_ns,
+        (double) histogram->max / ticks_per_ns);
+}
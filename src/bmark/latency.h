@@ -0,0 +1,124 @@
+/**
+ * @file latency.h
+ * @author Kudryashov Ilya (kudriashov.it@phystech.edu)
+ * @brief Per-operation latency measurement with the time stamp counter.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2023
+ * 
+ */
+
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <x86intrin.h>
+
+//* Every power of two is split into 2^LATENCY_SUB_BUCKET_BITS bins, so the relative error of a percentile is below 1/16.
+static const unsigned LATENCY_SUB_BUCKET_BITS = 4;
+static const uint64_t LATENCY_SUB_BUCKET_COUNT = 1ull << LATENCY_SUB_BUCKET_BITS;
+static const size_t LATENCY_BIN_COUNT = (64 - LATENCY_SUB_BUCKET_BITS + 1) * LATENCY_SUB_BUCKET_COUNT;
+
+/**
+ * @brief Log-bucketed histogram of latencies measured in TSC ticks.
+ * 
+ * @param counts number of samples in each bin
+ * @param total number of samples
+ * @param min smallest sample
+ * @param max largest sample
+ */
+struct LatencyHistogram {
+    uint64_t counts[LATENCY_BIN_COUNT] = {};
+    uint64_t total = 0;
+    uint64_t min = UINT64_MAX;
+    uint64_t max = 0;
+};
+
+/**
+ * @brief Read the time stamp counter before the measured operation.
+ * 
+ * @return counter value
+ */
+static inline uint64_t tsc_begin() {
+    _mm_lfence();
+    uint64_t ticks = __rdtsc();
+    _mm_lfence();
+    return ticks;
+}
+
+/**
+ * @brief Read the time stamp counter after the measured operation has finished.
+ * 
+ * @return counter value
+ */
+static inline uint64_t tsc_end() {
+    unsigned processor_id = 0;
+    uint64_t ticks = __rdtscp(&processor_id);
+    _mm_lfence();
+    return ticks;
+}
+
+/**
+ * @brief Get number of ticks spent by the operation, excluding the timer overhead.
+ * 
+ * @param start value returned by tsc_begin()
+ * @param end value returned by tsc_end()
+ * @param overhead value returned by tsc_overhead()
+ * @return duration of the operation in ticks
+ */
+static inline uint64_t tsc_elapsed(uint64_t start, uint64_t end, uint64_t overhead) {
+    return end - start > overhead ? end - start - overhead : 0;
+}
+
+/**
+ * @brief Measure the number of TSC ticks per nanosecond against the monotonic clock.
+ * 
+ * @return ticks per nanosecond
+ */
+double tsc_calibrate();
+
+/**
+ * @brief Measure the smallest number of ticks between tsc_begin() and tsc_end() with nothing in between.
+ * 
+ * @return timer overhead in ticks
+ */
+uint64_t tsc_overhead();
+
+/**
+ * @brief Bind the calling thread to the specified processor.
+ * 
+ * @param cpu_id index of the processor
+ * @return 0 if the thread was pinned, -1 otherwise
+ */
+int pin_thread(int cpu_id);
+
+/**
+ * @brief Put the sample into the histogram.
+ * 
+ * @param histogram pointer to the histogram
+ * @param ticks measured latency
+ */
+void LatencyHistogram_record(LatencyHistogram* histogram, uint64_t ticks);
+
+/**
+ * @brief Get the value below which the specified share of samples lies.
+ * 
+ * @param histogram pointer to the histogram
+ * @param quantile share of samples (from 0 to 1)
+ * @return upper bound of the bin containing the quantile (clamped to the largest sample)
+ */
+uint64_t LatencyHistogram_percentile(const LatencyHistogram* histogram, double quantile);
+
+/**
+ * @brief Print percentiles of the histogram as a CSV row (operation,samples,min_ns,p50_ns,p99_ns,p999_ns,max_ns).
+ * 
+ * @param histogram pointer to the histogram
+ * @param file file to print to
+ * @param operation name of the measured operation
+ * @param ticks_per_ns TSC frequency in ticks per nanosecond
+ */
+void LatencyHistogram_print(const LatencyHistogram* histogram, FILE* file, const char* operation, double ticks_per_ns);
+
+#endif
@@ -0,0 +1,75 @@
+#include "matrix.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "lib/util/dbg/debug.h"
+
+/**
+ * @brief Read comma-separated values of one dimension
+ * 
+ * @param dimension name of the dimension
+ * @param values values to parse (modified by tokenization)
+ * @param matrix matrix to store the values to
+ * @return true if the values were valid
+ */
+static bool parse_dimension(const char* dimension, char* values, MatrixSpec* matrix) {
+    size_t count = 0;
+    char* state = NULL;
+
+    for (char* value = strtok_r(values, ",", &state); value; value = strtok_r(NULL, ",", &state), ++count) {
+        if (count == MATRIX_MAX_VALUES) return false;
+
+        if (strcmp(dimension, "engine") == 0) {
+            matrix->engines[count] = value;
+        } else if (strcmp(dimension, "hash") == 0) {
+            matrix->hashes[count] = find_hash_function(value);
+            if (!matrix->hashes[count]) return false;
+        } else if (strcmp(dimension, "buckets") == 0) {
+            char* end = NULL;
+            matrix->bucket_counts[count] = strtoul(value, &end, 10);
+            if (*end != '\0' || *value == '-' || matrix->bucket_counts[count] == 0) return false;
+        } else return false;
+    }
+
+    if (count == 0) return false;
+
+    size_t* count_ptr = strcmp(dimension, "engine") == 0 ? &matrix->engine_count :
+                        strcmp(dimension, "hash") == 0 ? &matrix->hash_count : &matrix->bucket_option_count;
+
+    //* Dimension repeated in the spec would silently drop the first list.
+    if (*count_ptr) return false;
+    *count_ptr = count;
+
+    return true;
+}
+
+bool parse_matrix_spec(const char* spec, MatrixSpec* matrix) {
+    _LOG_FAIL_CHECK_(spec && matrix, "error", ERROR_REPORTS, return false, NULL, EINVAL);
+
+    *matrix = {};
+
+    if (strlen(spec) >= MATRIX_SPEC_LENGTH) return false;
+    strcpy(matrix->text, spec);
+
+    char* state = NULL;
+
+    for (char* dimension = strtok_r(matrix->text, ";", &state); dimension; dimension = strtok_r(NULL, ";", &state)) {
+        char* values = strchr(dimension, '=');
+        if (!values) return false;
+
+        *values++ = '\0';
+
+        if (!parse_dimension(dimension, values, matrix)) return false;
+    }
+
+    return matrix->engine_count || matrix->hash_count || matrix->bucket_option_count;
+}
+
+size_t MatrixSpec_size(const MatrixSpec* matrix) {
+    _LOG_FAIL_CHECK_(matrix, "error", ERROR_REPORTS, return 0, NULL, EINVAL);
+
+    return (matrix->engine_count ? matrix->engine_count : 1) *
+           (matrix->hash_count ? matrix->hash_count : 1) *
+           (matrix->bucket_option_count ? matrix->bucket_option_count : 1);
+}
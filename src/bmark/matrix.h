@@ -0,0 +1,62 @@
+/**
+ * @file matrix.h
+ * @author Kudryashov Ilya (kudriashov.it@phystech.edu)
+ * @brief Matrix of table variants benchmarked in one run.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2023
+ * 
+ */
+
+#ifndef BMARK_MATRIX_H
+#define BMARK_MATRIX_H
+
+#include <stddef.h>
+
+#include "src/hash/hash_functions.h"
+
+static const size_t MATRIX_MAX_VALUES = 8;
+static const size_t MATRIX_SPEC_LENGTH = 256;
+
+/**
+ * @brief Values of the runtime parameters every combination of which is benchmarked.
+ * 
+ * Dimensions without values keep the value of the tested variant.
+ * 
+ * @param engines names of the table engines (not checked, point into text)
+ * @param engine_count number of engines
+ * @param hashes hash functions
+ * @param hash_count number of hash functions
+ * @param bucket_counts bucket counts
+ * @param bucket_option_count number of bucket counts
+ * @param text copy of the spec
+ */
+struct MatrixSpec {
+    const char* engines[MATRIX_MAX_VALUES] = {};
+    size_t engine_count = 0;
+    const HashFunctionInfo* hashes[MATRIX_MAX_VALUES] = {};
+    size_t hash_count = 0;
+    size_t bucket_counts[MATRIX_MAX_VALUES] = {};
+    size_t bucket_option_count = 0;
+    char text[MATRIX_SPEC_LENGTH] = "";
+};
+
+/**
+ * @brief Read the matrix from the string of the form "engine=A,B;hash=x,y;buckets=n,m" (dimensions in any order, each at most once).
+ * 
+ * @param spec string to parse (for example, "engine=HashTable,RobinHoodTable;hash=murmur,sum;buckets=1021,4099")
+ * @param matrix variable to store the matrix to
+ * @return true if the string was valid
+ */
+bool parse_matrix_spec(const char* spec, MatrixSpec* matrix);
+
+/**
+ * @brief Get number of variants in the matrix.
+ * 
+ * @param matrix matrix
+ * @return product of the numbers of values of the dimensions (dimensions without values count as one)
+ */
+size_t MatrixSpec_size(const MatrixSpec* matrix);
+
+#endif
@@ -0,0 +1,218 @@
+#include "perf_counters.h"
+
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+//* Names of the counters in the order of PERF_COUNTER_ID.
+static const char* const PERF_COUNTER_NAMES[PERF_COUNTER_COUNT] = {
+    "cycles", "instructions", "l1d_misses", "llc_misses", "dtlb_misses", "branch_misses",
+};
+
+/**
+ * @brief Get config value of the hardware cache event
+ * 
+ * @param cache cache to observe
+ * @return perf_event_attr config of read misses in the cache
+ */
+static uint64_t cache_miss_event(uint64_t cache) {
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+/**
+ * @brief Fill event description of the counter
+ * 
+ * @param counter_id counter identifier
+ * @param attributes event description to fill
+ */
+static void fill_event(PERF_COUNTER_ID counter_id, perf_event_attr* attributes) {
+    memset(attributes, 0, sizeof(*attributes));
+    attributes->size = sizeof(*attributes);
+    attributes->exclude_kernel = 1;
+    attributes->exclude_hv = 1;
+    attributes->read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    switch (counter_id) {
+        case PERF_CYCLES:
+            attributes->type = PERF_TYPE_HARDWARE;
+            attributes->config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case PERF_INSTRUCTIONS:
+            attributes->type = PERF_TYPE_HARDWARE;
+            attributes->config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case PERF_L1D_MISSES:
+            attributes->type = PERF_TYPE_HW_CACHE;
+            attributes->config = cache_miss_event(PERF_COUNT_HW_CACHE_L1D);
+            break;
+        case PERF_LLC_MISSES:
+            attributes->type = PERF_TYPE_HW_CACHE;
+            attributes->config = cache_miss_event(PERF_COUNT_HW_CACHE_LL);
+            break;
+        case PERF_DTLB_MISSES:
+            attributes->type = PERF_TYPE_HW_CACHE;
+            attributes->config = cache_miss_event(PERF_COUNT_HW_CACHE_DTLB);
+            break;
+        case PERF_BRANCH_MISSES:
+            attributes->type = PERF_TYPE_HARDWARE;
+            attributes->config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        case PERF_COUNTER_COUNT:
+        default: break;
+    }
+}
+
+//* Group read: number of counters, time enabled, time running, then values in the order the counters were opened.
+struct PerfGroupReading {
+    uint64_t counter_count;
+    uint64_t time_enabled;
+    uint64_t time_running;
+    uint64_t values[PERF_COUNTER_COUNT];
+};
+
+/**
+ * @brief Get descriptor of the group leader
+ * 
+ * @param counters pointer to the counter set
+ * @return descriptor of the first opened counter (-1 if no counter is open)
+ */
+static int group_leader(const PerfCounters* counters) {
+    for (int counter_id = 0; counter_id < PERF_COUNTER_COUNT; ++counter_id) {
+        if (counters->descriptors[counter_id] >= 0) return counters->descriptors[counter_id];
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Read the group
+ * 
+ * @param counters pointer to the counter set
+ * @param reading variable to store the reading to
+ * @return true if the group was read
+ */
+static bool read_group(const PerfCounters* counters, PerfGroupReading* reading) {
+    ssize_t size = read(group_leader(counters), reading, sizeof(*reading));
+    return size >= (ssize_t) (3 * sizeof(uint64_t)) && size == (ssize_t) ((3 + reading->counter_count) * sizeof(uint64_t));
+}
+
+/**
+ * @brief Check if the group is ever scheduled on the hardware as a whole
+ * 
+ * @param counters pointer to the counter set
+ * @return false if the group has more counters than the processor can count at once
+ */
+static bool group_fits(PerfCounters* counters) {
+    PerfCounters_start(counters);
+
+    volatile unsigned spin = 0;
+    for (unsigned step = 0; step < 100000; ++step) spin = spin + step;
+
+    int leader = group_leader(counters);
+    ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    PerfGroupReading reading = {};
+    return read_group(counters, &reading) && (reading.time_running > 0 || reading.time_enabled == 0);
+}
+
+unsigned PerfCounters_ctor(PerfCounters* counters, err_anchor_t err_code) {
+    _LOG_FAIL_CHECK_(counters, "error", ERROR_REPORTS, return 0, err_code, EFAULT);
+
+    unsigned open_count = 0;
+    int saved_errno = errno;
+
+    for (int counter_id = 0; counter_id < PERF_COUNTER_COUNT; ++counter_id) counters->descriptors[counter_id] = -1;
+
+    for (int counter_id = 0; counter_id < PERF_COUNTER_COUNT; ++counter_id) {
+        perf_event_attr attributes = {};
+        fill_event((PERF_COUNTER_ID) counter_id, &attributes);
+
+        //* Members follow the leader, so only the leader starts disabled.
+        int leader = group_leader(counters);
+        attributes.disabled = leader < 0;
+
+        counters->descriptors[counter_id] = (int) syscall(SYS_perf_event_open, &attributes, 0, -1, leader, 0);
+        counters->values[counter_id] = 0;
+
+        if (counters->descriptors[counter_id] < 0) {
+            counters->descriptors[counter_id] = -1;
+            log_printf(WARNINGS, "warning", "Counter %s is not available on this system.\n", PERF_COUNTER_NAMES[counter_id]);
+            continue;
+        }
+
+        //* Group that does not fit into the hardware counters is never scheduled, so the last counter is dropped.
+        if (leader >= 0 && !group_fits(counters)) {
+            close(counters->descriptors[counter_id]);
+            counters->descriptors[counter_id] = -1;
+            log_printf(WARNINGS, "warning", "Counter %s does not fit into the group with the previous ones.\n", PERF_COUNTER_NAMES[counter_id]);
+            continue;
+        }
+
+        ++open_count;
+    }
+
+    //* Missing counters are common on virtual machines and should not fail the program.
+    errno = saved_errno;
+
+    return open_count;
+}
+
+void PerfCounters_dtor(PerfCounters* counters) {
+    if (!counters) return;
+
+    //* Members are closed before the leader.
+    for (int counter_id = PERF_COUNTER_COUNT - 1; counter_id >= 0; --counter_id) {
+        if (counters->descriptors[counter_id] >= 0) close(counters->descriptors[counter_id]);
+        counters->descriptors[counter_id] = -1;
+    }
+}
+
+void PerfCounters_start(PerfCounters* counters) {
+    int leader = group_leader(counters);
+    if (leader < 0) return;
+
+    ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+void PerfCounters_stop(PerfCounters* counters) {
+    int leader = group_leader(counters);
+    if (leader < 0) return;
+
+    ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    PerfGroupReading reading = {};
+    bool read_success = read_group(counters, &reading);
+
+    //* The kernel multiplexes the whole group at once, so every counter is extrapolated by the same ratio.
+    double scale = read_success && reading.time_running ? (double) reading.time_enabled / (double) reading.time_running : 0.0;
+
+    size_t member_id = 0;
+    for (int counter_id = 0; counter_id < PERF_COUNTER_COUNT; ++counter_id) {
+        if (counters->descriptors[counter_id] < 0) continue;
+
+        counters->values[counter_id] = member_id < reading.counter_count ? (uint64_t) ((double) reading.values[member_id] * scale) : 0;
+        ++member_id;
+    }
+}
+
+void PerfCounters_print_header(FILE* file) {
+    for (int counter_id = 0; counter_id < PERF_COUNTER_COUNT; ++counter_id) {
+        fprintf(file, ",%s_per_op", PERF_COUNTER_NAMES[counter_id]);
+    }
+}
+
+void PerfCounters_print(const PerfCounters* counters, FILE* file, size_t operation_count) {
+    _LOG_FAIL_CHECK_(counters && file, "error", ERROR_REPORTS, return, NULL, EINVAL);
+
+    for (int counter_id = 0; counter_id < PERF_COUNTER_COUNT; ++counter_id) {
+        if (counters->descriptors[counter_id] < 0 || operation_count == 0) {
+            fputc(',', file);
+            continue;
+        }
+
+        fprintf(file, ",%lg", (double) counters->values[counter_id] / (double) operation_count);
+    }
+}
@@ -0,0 +1,91 @@
+/**
+ * @file perf_counters.h
+ * @author Kudryashov Ilya (kudriashov.it@phystech.edu)
+ * @brief Hardware performance counters read through perf_event_open.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2023
+ * 
+ */
+
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "lib/util/dbg/debug.h"
+
+enum PERF_COUNTER_ID {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_L1D_MISSES,
+    PERF_LLC_MISSES,
+    PERF_DTLB_MISSES,
+    PERF_BRANCH_MISSES,
+    PERF_COUNTER_COUNT,
+};
+
+/**
+ * @brief Set of performance counters of the calling thread.
+ * 
+ * Counters are opened as one group led by the first available counter, so that all of them are scheduled together
+ * and ratios between them (instructions per cycle, misses per operation) describe the same interval.
+ * 
+ * @param descriptors file descriptors of the counters (-1 if the counter is not supported)
+ * @param values counter values of the last measured phase, scaled if the group was multiplexed
+ */
+struct PerfCounters {
+    int descriptors[PERF_COUNTER_COUNT] = {};
+    uint64_t values[PERF_COUNTER_COUNT] = {};
+};
+
+/**
+ * @brief Open the counters. Counters unavailable on this system or not fitting into the group are skipped.
+ * 
+ * @param counters pointer to the counter set
+ * @param err_code variable to use as errno
+ * @return number of opened counters
+ */
+unsigned PerfCounters_ctor(PerfCounters* counters, ERROR_MARKER);
+
+/**
+ * @brief Close the counters.
+ * 
+ * @param counters pointer to the counter set
+ */
+void PerfCounters_dtor(PerfCounters* counters);
+
+/**
+ * @brief Reset the counters and start counting.
+ * 
+ * @param counters pointer to the counter set
+ */
+void PerfCounters_start(PerfCounters* counters);
+
+/**
+ * @brief Stop counting and read counter values.
+ * 
+ * @param counters pointer to the counter set
+ */
+void PerfCounters_stop(PerfCounters* counters);
+
+/**
+ * @brief Print names of the counters as CSV columns (each prefixed with a comma).
+ * 
+ * @param file file to print to
+ */
+void PerfCounters_print_header(FILE* file);
+
+/**
+ * @brief Print counter values divided by the number of operations as CSV columns (each prefixed with a comma).
+ *      Unavailable counters are printed as empty cells.
+ * 
+ * @param counters pointer to the counter set
+ * @param file file to print to
+ * @param operation_count number of operations performed during the measured phase
+ */
+void PerfCounters_print(const PerfCounters* counters, FILE* file, size_t operation_count);
+
+#endif
@@ -0,0 +1,657 @@
+/**
+ * @file runner.hpp
+ * @author Kudryashov Ilya (kudriashov.it@phystech.edu)
+ * @brief Benchmark of the tested table under the workload selected at runtime.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2023
+ * 
+ */
+
+#ifndef BMARK_RUNNER_HPP
+#define BMARK_RUNNER_HPP
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "lib/util/dbg/debug.h"
+
+#include "table_adapter.h"
+#include "workload.h"
+#include "summary.h"
+#include "key_generator.h"
+#include "compare.h"
+#include "matrix.h"
+
+#include "src/text_parser/word_stream.h"
+#include "src/text_parser/shard_loader.h"
+
+/**
+ * @brief Make the compiler believe the value is used, so that the computation producing it is not eliminated.
+ * 
+ * @param value value to keep
+ */
+static inline void bmark_keep(const void* value) {
+    asm volatile("" : : "g"(value) : "memory");
+}
+
+
+//* DECLARATIONS
+
+//* Benchmarks are templates of the table type, instantiated for every engine of TABLE_ENGINES,
+//* those hashing the keys in the measured loops are also templates of the hash function (see with_table_variant()).
+
+/**
+ * @brief Measure the tested table under the workload and print the summary of time per operation.
+ * 
+ * @param config benchmark parameters
+ * @param table filled table to run lookup workloads on
+ * @param word_list list of words the table was filled with
+ * @param word_count number of words in the list
+ * @param output file to print the summary to (NULL to print nothing)
+ * @param summary_ptr variable to store the summary to (can be NULL)
+ * @param err_code variable to use as errno
+ * @return 0 if the benchmark succeeded, -1 otherwise
+ */
+template <typename Table, hash_fn_t* Hash>
+int run_benchmark(const BenchmarkConfig* config, const Table* table, word_list_t word_list, size_t word_count,
+                  FILE* output, SampleSummary* summary_ptr, ERROR_MARKER);
+
+/**
+ * @brief Build tables of generated keys of sizes from SWEEP_MIN_KEYS up to the specified one (multiplying it by 10)
+ *      and print build and lookup throughput and memory taken by the table at every size as CSV.
+ * 
+ * @param config benchmark parameters (Bloom filter usage; non-zero key count hint makes tables presized for every step)
+ * @param generator parameters of generated keys (key count is ignored)
+ * @param max_keys largest number of keys
+ * @param output file to print results to
+ * @param err_code variable to use as errno
+ * @return 0 if the sweep succeeded, -1 otherwise
+ */
+template <typename Table, hash_fn_t* Hash>
+int run_size_sweep(const BenchmarkConfig* config, const KeyGeneratorConfig* generator, size_t max_keys, FILE* output, ERROR_MARKER);
+
+/**
+ * @brief Stream the word list file into a new table with overlapped reading, hashing and insertion
+ *      and print ingest throughput and the table memory as CSV.
+ * 
+ * Memory taken by the words in flight is bounded by STREAM_WINDOW_COUNT * STREAM_WINDOW_SIZE regardless of the file size,
+ * so the table has to copy the keys (32-byte keys of OPTIMIZATION_LEVEL >= 1).
+ * 
+ * @param config benchmark parameters (Bloom filter usage and key count hint, which also sizes the filter)
+ * @param file_name name of the word list file
+ * @param output file to print results to
+ * @param err_code variable to use as errno
+ * @return 0 if the table was built, -1 otherwise
+ */
+template <typename Table>
+int run_stream_ingest(const BenchmarkConfig* config, const char* file_name, FILE* output, ERROR_MARKER);
+
+/**
+ * @brief Load the compact word list file (see write_compact_words()) into a new table
+ *      and print load throughput, bytes read and the table memory as CSV.
+ * 
+ * Keys are passed to the table straight from the mapped file, precomputed hashes are used
+ * if they were computed with the tested hash function, otherwise the keys are rehashed.
+ * 
+ * @param config benchmark parameters (Bloom filter usage and key count hint)
+ * @param file_name name of the compact word list file
+ * @param output file to print results to
+ * @param err_code variable to use as errno
+ * @return 0 if the table was built, -1 otherwise
+ */
+template <typename Table, hash_fn_t* Hash>
+int run_compact_ingest(const BenchmarkConfig* config, const char* file_name, FILE* output, ERROR_MARKER);
+
+/**
+ * @brief Load every word list file of the directory into a new table with many reads in flight
+ *      and print ingest throughput, the reading engine and the table memory as CSV.
+ * 
+ * Read buffers are reused once consumed, so the table has to copy the keys (32-byte keys of OPTIMIZATION_LEVEL >= 1).
+ * 
+ * @param config benchmark parameters (Bloom filter usage and key count hint, which also sizes the filter)
+ * @param directory directory of word list files
+ * @param thread_count number of reading threads if io_uring is not available (0 to use every online processor)
+ * @param output file to print results to
+ * @param err_code variable to use as errno
+ * @return 0 if the table was built, -1 otherwise
+ */
+template <typename Table>
+int run_shard_ingest(const BenchmarkConfig* config, const char* directory, unsigned thread_count, FILE* output, ERROR_MARKER);
+
+/**
+ * @brief Build and benchmark a table of every variant of the matrix and print the combined results table as CSV.
+ * 
+ * Rows have the format of the benchmark summary (so the table can be compared with -C), the workload column holds
+ * the name of the variant (engine/hash/buckets/workload). Engines that do not take the bucket count are run once per hash.
+ * 
+ * @param matrix variants to run (dimensions without values keep the value of tested_variant)
+ * @param config benchmark parameters
+ * @param word_list list of words to fill the tables with
+ * @param word_count number of words in the list
+ * @param output file to print the table to
+ * @param results result set to add results of the variants to (can be NULL)
+ * @param err_code variable to use as errno
+ * @return number of benchmarked variants (-1 if failed)
+ */
+int run_matrix(const MatrixSpec* matrix, const BenchmarkConfig* config, word_list_t word_list, size_t word_count,
+               FILE* output, ResultSet* results, ERROR_MARKER);
+
+
+//* IMPLEMENTATIONS ==============================
+
+/**
+ * @brief Construct the table the way the benchmarked one was constructed
+ * 
+ * @param table table to construct
+ * @param config benchmark parameters
+ * @param word_count number of words the table will be filled with
+ * @param err_code variable to use as errno
+ * @return true if the table was constructed
+ */
+template <typename Table>
+static bool _bmark_table_ctor(Table* table, const BenchmarkConfig* config, size_t word_count, err_anchor_t err_code) {
+    *table = {};
+    TABLE_FN(ctor)(table, config->expected_keys, err_code);
+    _LOG_FAIL_CHECK_(TABLE_FN(status)(table) == 0, "error", ERROR_REPORTS, return false, err_code, ENOMEM);
+
+    if (config->use_bloom) TABLE_FN(enable_filter)(table, word_count, err_code);
+
+    return true;
+}
+
+/**
+ * @brief Run one measurement of the workload
+ * 
+ * @param config benchmark parameters
+ * @param table table to run lookups on
+ * @param word_list list of words the table was filled with
+ * @param query_list list of queries
+ * @param word_count number of words in the lists
+ * @param order order of queries (NULL for sequential order)
+ * @param operations sequence of operations of the mix workload
+ * @param err_code variable to use as errno
+ * @return number of nanoseconds per operation (negative if failed)
+ */
+template <typename Table, hash_fn_t* Hash>
+static double _bmark_measure(const BenchmarkConfig* config, const Table* table, word_list_t word_list, word_list_t query_list,
+                             size_t word_count, const size_t* order, const BMARK_OPERATION* operations, err_anchor_t err_code) {
+    Table scratch_table = {};
+    uint64_t start_time = 0;
+    size_t operation_count = 0;
+
+    switch (config->workload) {
+        case WORKLOAD_HIT:
+        case WORKLOAD_MISS:
+        case WORKLOAD_ZIPF: {
+            start_time = bmark_now_ns();
+
+            for (unsigned repetition_id = 0; repetition_id < config->repetition; ++repetition_id)
+            for (size_t query_id = 0; query_id < word_count; ++query_id) {
+                size_t word_id = order ? order[query_id] : query_id;
+                bmark_keep(TABLE_FN(find_value)(table, WORD_HASH(Hash, WORD_AT(query_list, word_id)), WORD_KEY(WORD_AT(query_list, word_id))));
+            }
+
+            operation_count = (size_t) config->repetition * word_count;
+            break;
+        }
+        case WORKLOAD_MIX: {
+            if (!_bmark_table_ctor(&scratch_table, config, word_count, err_code)) return -1.0;
+
+            for (size_t word_id = 0; word_id < word_count; ++word_id) {
+                TABLE_FN(insert)(&scratch_table, WORD_HASH(Hash, WORD_AT(word_list, word_id)), WORD_KEY(WORD_AT(word_list, word_id)));
+            }
+
+            start_time = bmark_now_ns();
+
+            for (unsigned repetition_id = 0; repetition_id < config->repetition; ++repetition_id)
+            for (size_t query_id = 0; query_id < word_count; ++query_id) {
+                hash_t hash = WORD_HASH(Hash, WORD_AT(query_list, query_id));
+
+                switch (operations[query_id]) {
+                    case OPERATION_INSERT:
+                        TABLE_FN(insert)(&scratch_table, hash, WORD_KEY(WORD_AT(query_list, query_id)));
+                        break;
+                    case OPERATION_REMOVE:
+                        TABLE_FN(remove)(&scratch_table, hash, WORD_KEY(WORD_AT(query_list, query_id)));
+                        break;
+                    case OPERATION_FIND:
+                    default:
+                        bmark_keep(TABLE_FN(find_value)(&scratch_table, hash, WORD_KEY(WORD_AT(query_list, query_id))));
+                        break;
+                }
+            }
+
+            operation_count = (size_t) config->repetition * word_count;
+            break;
+        }
+        case WORKLOAD_BUILD: {
+            start_time = bmark_now_ns();
+
+            if (!_bmark_table_ctor(&scratch_table, config, word_count, err_code)) return -1.0;
+
+            for (size_t word_id = 0; word_id < word_count; ++word_id) {
+                TABLE_FN(insert)(&scratch_table, WORD_HASH(Hash, WORD_AT(word_list, word_id)), WORD_KEY(WORD_AT(word_list, word_id)));
+            }
+
+            operation_count = word_count;
+            break;
+        }
+        case WORKLOAD_UNKNOWN:
+        default: return -1.0;
+    }
+
+    uint64_t end_time = bmark_now_ns();
+
+    if (config->workload == WORKLOAD_MIX || config->workload == WORKLOAD_BUILD) TABLE_FN(dtor)(&scratch_table);
+
+    return operation_count ? (double) (end_time - start_time) / (double) operation_count : -1.0;
+}
+
+template <typename Table, hash_fn_t* Hash>
+int run_benchmark(const BenchmarkConfig* config, const Table* table, word_list_t word_list, size_t word_count,
+                  FILE* output, SampleSummary* summary_ptr, err_anchor_t err_code) {
+    _LOG_FAIL_CHECK_(config && table && word_list, "error", ERROR_REPORTS, return -1, err_code, EINVAL);
+    _LOG_FAIL_CHECK_(config->workload < WORKLOAD_UNKNOWN, "error", ERROR_REPORTS, return -1, err_code, EINVAL);
+    _LOG_FAIL_CHECK_(config->test_count && word_count, "error", ERROR_REPORTS, return -1, err_code, EINVAL);
+
+    log_printf(STATUS_REPORTS, "status", "Running %s workload: %u tests of %u passes over %lu keys.\n",
+        workload_name(config->workload), config->test_count, config->repetition, word_count);
+
+    double miss_ratio = config->workload == WORKLOAD_HIT ? 0.0 : config->miss_ratio;
+
+    word_list_t query_list = BUILD_QUERY_LIST(word_list, word_count, miss_ratio, NULL);
+    size_t* order = config->workload == WORKLOAD_ZIPF ? build_zipf_order(word_count, config->zipf_exponent) : NULL;
+    BMARK_OPERATION* operations = config->workload == WORKLOAD_MIX ?
+        build_operation_mix(word_count, config->insert_share, config->remove_share) : NULL;
+    double* samples = (double*) calloc(config->test_count, sizeof(*samples));
+
+    int status = 0;
+
+    if (!query_list || !samples || (config->workload == WORKLOAD_ZIPF && !order) || (config->workload == WORKLOAD_MIX && !operations)) {
+        log_printf(ERROR_REPORTS, "error", "Failed to allocate benchmark queries.\n");
+        if (err_code) *err_code = ENOMEM;
+        status = -1;
+    }
+
+    for (unsigned test_id = 0; status == 0 && test_id < config->test_count; ++test_id) {
+        TRACE_SPAN_ID(workload_name(config->workload), test_id);
+        samples[test_id] = _bmark_measure<Table, Hash>(config, table, word_list, query_list, word_count, order, operations, err_code);
+        if (samples[test_id] < 0.0) status = -1;
+    }
+
+    if (status == 0) {
+        SampleSummary summary = summarize_samples(samples, config->test_count);
+        size_t operation_count = config->workload == WORKLOAD_BUILD ? word_count : (size_t) config->repetition * word_count;
+        if (output) print_summary(output, config->format, workload_name(config->workload), operation_count, &summary);
+
+        if (summary_ptr) *summary_ptr = summary;
+    }
+
+    free((void*) query_list);
+    free(order);
+    free(operations);
+    free(samples);
+
+    return status;
+}
+
+template <typename Table, hash_fn_t* Hash>
+int run_size_sweep(const BenchmarkConfig* config, const KeyGeneratorConfig* generator, size_t max_keys, FILE* output, err_anchor_t err_code) {
+    _LOG_FAIL_CHECK_(config && generator && output, "error", ERROR_REPORTS, return -1, err_code, EINVAL);
+    _LOG_FAIL_CHECK_(max_keys >= SWEEP_MIN_KEYS, "error", ERROR_REPORTS, return -1, err_code, EINVAL);
+
+    fprintf(output, "keys,distinct_keys,build_ns,build_mops,lookup_ns,lookup_mops,bytes_allocated,bytes_per_key\n");
+
+    for (size_t key_count = SWEEP_MIN_KEYS; key_count <= max_keys; key_count *= 10) {
+        log_printf(STATUS_REPORTS, "status", "Sweep step of %lu keys.\n", key_count);
+
+        KeyGeneratorConfig step_generator = *generator;
+        step_generator.key_count = key_count;
+
+        word_list_t key_list = NULL;
+        _LOG_FAIL_CHECK_(GENERATE_SAMPLE(&step_generator, &key_list) == key_count, "error", ERROR_REPORTS, return -1, err_code, ENOMEM);
+
+        //* Key count hint, if requested, follows the size of the step.
+        BenchmarkConfig step_config = *config;
+        if (step_config.expected_keys) step_config.expected_keys = key_count;
+
+        Table table = {};
+        if (!_bmark_table_ctor(&table, &step_config, key_count, err_code)) {
+            free((void*) key_list);
+            return -1;
+        }
+
+        uint64_t build_start = bmark_now_ns();
+        for (size_t key_id = 0; key_id < key_count; ++key_id) {
+            TABLE_FN(insert)(&table, WORD_HASH(Hash, WORD_AT(key_list, key_id)), WORD_KEY(WORD_AT(key_list, key_id)));
+        }
+        uint64_t build_time = bmark_now_ns() - build_start;
+
+        size_t pass_count = (SWEEP_MIN_LOOKUPS + key_count - 1) / key_count;
+
+        uint64_t lookup_start = bmark_now_ns();
+        for (size_t pass_id = 0; pass_id < pass_count; ++pass_id)
+        for (size_t key_id = 0; key_id < key_count; ++key_id) {
+            bmark_keep(TABLE_FN(find_value)(&table, WORD_HASH(Hash, WORD_AT(key_list, key_id)), WORD_KEY(WORD_AT(key_list, key_id))));
+        }
+        uint64_t lookup_time = bmark_now_ns() - lookup_start;
+
+        TableStats stats = {};
+        TABLE_FN(stats)(&table, &stats);
+
+        double build_ns = (double) build_time / (double) key_count;
+        double lookup_ns = (double) lookup_time / (double) (pass_count * key_count);
+
+        fprintf(output, "%lu,%lu,%lg,%lg,%lg,%lg,%lu,%lg\n", key_count, stats.key_count,
+            build_ns, 1000.0 / build_ns, lookup_ns, 1000.0 / lookup_ns,
+            stats.bytes_allocated, (double) stats.bytes_allocated / (double) (stats.key_count ? stats.key_count : 1));
+        fflush(output);
+
+        TABLE_FN(dtor)(&table);
+        free((void*) key_list);
+
+        if (key_count > max_keys / 10) break;
+    }
+
+    return 0;
+}
+
+#if OPTIMIZATION_LEVEL >= 1 && !defined(STRING_KEYS)
+/**
+ * @brief Insert the window of streamed words into the table
+ * 
+ * @param table_ptr pointer to the table
+ * @param words streamed words
+ * @param hashes hashes of the words
+ * @param word_count number of words
+ */
+template <typename Table>
+static void _bmark_stream_insert(void* table_ptr, const char* words, const hash_t* hashes, size_t word_count) {
+    Table* table = (Table*) table_ptr;
+
+    for (size_t word_id = 0; word_id < word_count; ++word_id) {
+        TABLE_FN(insert)(table, hashes[word_id], WORD_KEY(WORD_AT(words, word_id)));
+    }
+}
+#endif
+
+template <typename Table>
+int run_stream_ingest(const BenchmarkConfig* config, const char* file_name, FILE* output, err_anchor_t err_code) {
+    _LOG_FAIL_CHECK_(config && file_name && output, "error", ERROR_REPORTS, return -1, err_code, EINVAL);
+
+    #if OPTIMIZATION_LEVEL < 1 || defined(STRING_KEYS)
+    log_printf(ERROR_REPORTS, "error", "Streamed words are only valid until inserted, "
+                                       "so streaming needs tables copying 32-byte keys (OPTIMIZATION_LEVEL >= 1).\n");
+    _LOG_FAIL_CHECK_(false, "error", ERROR_REPORTS, return -1, err_code, EINVAL);
+    #else
+    Table table = {};
+    if (!_bmark_table_ctor(&table, config, config->expected_keys, err_code)) return -1;
+
+    WordStreamConfig stream = {};
+    stream.hash = tested_variant.hash.function;
+
+    uint64_t start = bmark_now_ns();
+    size_t word_count = stream_words(file_name, &stream, _bmark_stream_insert<Table>, &table, err_code);
+    uint64_t ingest_time = bmark_now_ns() - start;
+
+    _LOG_FAIL_CHECK_(word_count > 0, "error", ERROR_REPORTS, {
+        TABLE_FN(dtor)(&table);
+        return -1;
+    }, err_code, EIO);
+
+    TableStats stats = {};
+    TABLE_FN(stats)(&table, &stats);
+
+    double seconds = (double) ingest_time / 1e9;
+
+    fprintf(output, "words,distinct_keys,bytes_read,seconds,mops,mb_per_s,buffer_bytes,bytes_allocated\n");
+    fprintf(output, "%lu,%lu,%lu,%lg,%lg,%lg,%lu,%lu\n", word_count, stats.key_count, word_count * MAX_WORD_LENGTH, seconds,
+        (double) word_count / seconds / 1e6, (double) (word_count * MAX_WORD_LENGTH) / seconds / 1e6,
+        stream.window_count * (stream.window_size + stream.window_size / MAX_WORD_LENGTH * sizeof(hash_t)), stats.bytes_allocated);
+
+    TABLE_FN(dtor)(&table);
+    #endif
+
+    return 0;
+}
+
+template <typename Table>
+int run_shard_ingest(const BenchmarkConfig* config, const char* directory, unsigned thread_count, FILE* output, err_anchor_t err_code) {
+    _LOG_FAIL_CHECK_(config && directory && output, "error", ERROR_REPORTS, return -1, err_code, EINVAL);
+
+    #if OPTIMIZATION_LEVEL < 1 || defined(STRING_KEYS)
+    SILENCE_UNUSED(thread_count);
+    log_printf(ERROR_REPORTS, "error", "Read buffers are reused once inserted, "
+                                       "so loading shards needs tables copying 32-byte keys (OPTIMIZATION_LEVEL >= 1).\n");
+    _LOG_FAIL_CHECK_(false, "error", ERROR_REPORTS, return -1, err_code, EINVAL);
+    #else
+    char** file_names = NULL;
+    size_t file_count = list_shard_files(directory, &file_names, err_code);
+    _LOG_FAIL_CHECK_(file_count > 0, "error", ERROR_REPORTS, return -1, err_code, ENOENT);
+
+    Table table = {};
+    if (!_bmark_table_ctor(&table, config, config->expected_keys, err_code)) {
+        free_shard_files(file_names, file_count);
+        return -1;
+    }
+
+    ShardLoaderConfig loader = {};
+    loader.thread_count = thread_count;
+    loader.hash = tested_variant.hash.function;
+
+    ShardLoaderStats loaded = {};
+
+    uint64_t start = bmark_now_ns();
+    int status = load_shards(file_names, file_count, &loader, _bmark_stream_insert<Table>, &table, &loaded, err_code);
+    uint64_t ingest_time = bmark_now_ns() - start;
+
+    free_shard_files(file_names, file_count);
+
+    _LOG_FAIL_CHECK_(status == 0, "error", ERROR_REPORTS, {
+        TABLE_FN(dtor)(&table);
+        return -1;
+    }, err_code, EIO);
+
+    TableStats stats = {};
+    TABLE_FN(stats)(&table, &stats);
+
+    double seconds = (double) ingest_time / 1e9;
+
+    fprintf(output, "files,words,distinct_keys,bytes_read,seconds,mops,mb_per_s,engine,bytes_allocated\n");
+    fprintf(output, "%lu,%lu,%lu,%lu,%lg,%lg,%lg,%s,%lu\n", loaded.file_count, loaded.word_count, stats.key_count, loaded.bytes_read,
+        seconds, (double) loaded.word_count / seconds / 1e6, (double) loaded.bytes_read / seconds / 1e6,
+        loaded.used_uring ? "io_uring" : "pread", stats.bytes_allocated);
+
+    TABLE_FN(dtor)(&table);
+    #endif
+
+    return 0;
+}
+
+#ifndef STRING_KEYS
+/**
+ * @brief Insert every word of the compact list into the table
+ * 
+ * @param table table to fill
+ * @param list compact word list
+ * @param use_hashes true if precomputed hashes of the list should be used
+ */
+template <typename Table, hash_fn_t* Hash>
+static void _bmark_compact_fill(Table* table, const CompactWordList* list, bool use_hashes) {
+    const char* key = list->keys;
+    //* Zero-padded copy of the word, only made for rehashing.
+    alignas(MAX_WORD_LENGTH) char word[MAX_WORD_LENGTH] = "";
+
+    for (size_t word_id = 0; word_id < list->word_count; ++word_id) {
+        size_t length = list->lengths[word_id];
+
+        #if OPTIMIZATION_LEVEL >= 1
+        __m256i elem = CompactWordList_vector(list, key, length);
+        if (!use_hashes) _mm256_store_si256((__m256i*) word, elem);
+        #else
+        //* Keys of the list are zero-terminated, so the table can point to them.
+        const char* elem = key;
+        if (!use_hashes) {
+            memset(word, 0, MAX_WORD_LENGTH);
+            memcpy(word, key, length);
+        }
+        #endif
+
+        hash_t hash = use_hashes ? list->hashes[word_id] : Hash(word, word + MAX_WORD_LENGTH);
+        TABLE_FN(insert)(table, hash, elem, WORD_COMPARATOR);
+
+        key += length + 1;
+    }
+}
+#endif
+
+template <typename Table, hash_fn_t* Hash>
+int run_compact_ingest(const BenchmarkConfig* config, const char* file_name, FILE* output, err_anchor_t err_code) {
+    _LOG_FAIL_CHECK_(config && file_name && output, "error", ERROR_REPORTS, return -1, err_code, EINVAL);
+
+    #ifdef STRING_KEYS
+    log_printf(ERROR_REPORTS, "error", "Compact word lists hold words of at most MAX_WORD_LENGTH bytes, "
+                                       "tables of arbitrary-length keys are filled from token lists.\n");
+    _LOG_FAIL_CHECK_(false, "error", ERROR_REPORTS, return -1, err_code, EINVAL);
+    #else
+    uint64_t start = bmark_now_ns();
+
+    CompactWordList list = {};
+    size_t word_count = read_compact_words(file_name, &list, err_code);
+    _LOG_FAIL_CHECK_(word_count > 0, "error", ERROR_REPORTS, return -1, err_code, EIO);
+
+    bool use_hashes = list.hashes && strcmp(list.hash_name, TESTED_HASH_NAME) == 0;
+    if (list.hashes && !use_hashes) {
+        log_printf(WARNINGS, "warning", "Hashes of %s were computed with %s, rehashing the keys with %s.\n",
+            file_name, list.hash_name, TESTED_HASH_NAME);
+    }
+
+    Table table = {};
+    if (!_bmark_table_ctor(&table, config, word_count, err_code)) {
+        CompactWordList_dtor(&list);
+        return -1;
+    }
+
+    _bmark_compact_fill<Table, Hash>(&table, &list, use_hashes);
+
+    uint64_t load_time = bmark_now_ns() - start;
+
+    TableStats stats = {};
+    TABLE_FN(stats)(&table, &stats);
+
+    double seconds = (double) load_time / 1e9;
+
+    fprintf(output, "words,distinct_keys,bytes_read,padded_bytes,stored_hashes,seconds,mops,bytes_allocated\n");
+    fprintf(output, "%lu,%lu,%lu,%lu,%d,%lg,%lg,%lu\n", word_count, stats.key_count, list.file_size, word_count * MAX_WORD_LENGTH,
+        use_hashes, seconds, (double) word_count / seconds / 1e6, stats.bytes_allocated);
+
+    //* Keys of OPTIMIZATION_LEVEL 0 tables point to the mapped file.
+    TABLE_FN(dtor)(&table);
+    CompactWordList_dtor(&list);
+    #endif
+
+    return 0;
+}
+
+/**
+ * @brief Build the table of the tested variant from the word list and run the benchmark on it
+ * 
+ * @param config benchmark parameters
+ * @param word_list list of words to fill the table with
+ * @param word_count number of words in the list
+ * @param summary variable to store the summary to
+ * @param err_code variable to use as errno
+ * @return 0 if the benchmark succeeded, -1 otherwise
+ */
+template <typename Table, hash_fn_t* Hash>
+static int _bmark_matrix_cell(const BenchmarkConfig* config, word_list_t word_list, size_t word_count, SampleSummary* summary, err_anchor_t err_code) {
+    Table table = {};
+    if (!_bmark_table_ctor(&table, config, word_count, err_code)) return -1;
+
+    int insert_error = 0;
+    for (size_t word_id = 0; word_id < word_count && !insert_error; ++word_id) {
+        TABLE_FN(insert)(&table, WORD_HASH(Hash, WORD_AT(word_list, word_id)), WORD_KEY(WORD_AT(word_list, word_id)), &insert_error);
+    }
+
+    _LOG_FAIL_CHECK_(!insert_error, "error", ERROR_REPORTS, {
+        TABLE_FN(dtor)(&table);
+        return -1;
+    }, err_code, insert_error);
+
+    int status = run_benchmark<Table, Hash>(config, &table, word_list, word_count, NULL, summary, err_code);
+
+    TABLE_FN(dtor)(&table);
+
+    return status;
+}
+
+int run_matrix(const MatrixSpec* matrix, const BenchmarkConfig* config, word_list_t word_list, size_t word_count,
+               FILE* output, ResultSet* results, err_anchor_t err_code) {
+    _LOG_FAIL_CHECK_(matrix && config && word_list && output, "error", ERROR_REPORTS, return -1, err_code, EINVAL);
+
+    for (size_t engine_id = 0; engine_id < matrix->engine_count; ++engine_id) {
+        _LOG_FAIL_CHECK_(is_table_engine(matrix->engines[engine_id]), "error", ERROR_REPORTS, {
+            log_printf(ERROR_REPORTS, "error", "Unknown table engine \"%s\".\n", matrix->engines[engine_id]);
+            return -1;
+        }, err_code, EINVAL);
+    }
+
+    //* Variants are set one by one, the tested one is restored at the end.
+    TableVariant base_variant = tested_variant;
+
+    size_t engine_count = matrix->engine_count ? matrix->engine_count : 1;
+    size_t hash_count = matrix->hash_count ? matrix->hash_count : 1;
+    size_t bucket_option_count = matrix->bucket_option_count ? matrix->bucket_option_count : 1;
+
+    size_t operation_count = config->workload == WORKLOAD_BUILD ? word_count : (size_t) config->repetition * word_count;
+
+    fprintf(output, "workload,tests,operations,mean_ns,stddev_ns,ci95_low_ns,ci95_high_ns,min_ns,max_ns,mops,engine,hash,buckets\n");
+
+    int status = 0;
+    int variant_count = 0;
+
+    for (size_t engine_id = 0; status == 0 && engine_id < engine_count; ++engine_id)
+    for (size_t hash_id = 0; status == 0 && hash_id < hash_count; ++hash_id)
+    for (size_t bucket_id = 0; status == 0 && bucket_id < bucket_option_count; ++bucket_id) {
+        tested_variant = base_variant;
+        if (matrix->engine_count) tested_variant.engine = matrix->engines[engine_id];
+        if (matrix->hash_count) tested_variant.hash = *matrix->hashes[hash_id];
+        if (matrix->bucket_option_count) tested_variant.bucket_count = matrix->bucket_counts[bucket_id];
+
+        bool takes_bucket_count = table_takes_bucket_count(tested_variant.engine);
+        if (!takes_bucket_count && bucket_id > 0) continue;
+
+        char buckets[32] = "-";
+        if (takes_bucket_count) snprintf(buckets, sizeof(buckets), "%lu", tested_variant.bucket_count);
+
+        char name[RESULT_NAME_LENGTH] = "";
+        snprintf(name, sizeof(name), "%s/%s/%s/%s", tested_variant.engine, tested_variant.hash.name, buckets, workload_name(config->workload));
+
+        log_printf(STATUS_REPORTS, "status", "Benchmarking variant %s.\n", name);
+
+        SampleSummary summary = {};
+        status = with_table_variant(&tested_variant, [&]<typename Table, hash_fn_t* Hash>(Table*, HashFunction<Hash>) {
+            return _bmark_matrix_cell<Table, Hash>(config, word_list, word_count, &summary, err_code);
+        });
+
+        if (status != 0) break;
+
+        fprintf(output, "%s,%lu,%lu,%lg,%lg,%lg,%lg,%lg,%lg,%lg,%s,%s,%s\n", name, summary.count, operation_count,
+            summary.mean, summary.stddev, summary.ci_low, summary.ci_high, summary.min, summary.max,
+            summary.mean > 0.0 ? 1000.0 / summary.mean : 0.0, tested_variant.engine, tested_variant.hash.name, buckets);
+        fflush(output);
+
+        if (results) ResultSet_add(results, name, &summary, err_code);
+        ++variant_count;
+    }
+
+    tested_variant = base_variant;
+
+    _LOG_FAIL_CHECK_(status == 0, "error", ERROR_REPORTS, return -1, err_code, EFAULT);
+
+    return variant_count;
+}
+
+#endif
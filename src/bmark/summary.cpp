@@ -0,0 +1,88 @@
+#include "summary.h"
+
+#include <math.h>
+#include <time.h>
+
+#include "lib/util/dbg/debug.h"
+
+//* Two-sided 95% critical values of Student's t-distribution for 1 ... 30 degrees of freedom.
+static const double STUDENT_T_95[] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042,
+};
+
+uint64_t bmark_now_ns() {
+    struct timespec time_point = {};
+    clock_gettime(CLOCK_MONOTONIC, &time_point);
+    return (uint64_t) time_point.tv_sec * 1000000000ull + (uint64_t) time_point.tv_nsec;
+}
+
+double student_t_critical(double degrees_of_freedom) {
+    if (degrees_of_freedom < 1.0) return STUDENT_T_95[0];
+
+    size_t table_size = sizeof(STUDENT_T_95) / sizeof(*STUDENT_T_95);
+    if (degrees_of_freedom <= (double) table_size) return STUDENT_T_95[(size_t) degrees_of_freedom - 1];
+
+    if (degrees_of_freedom <= 40.0) return 2.021;
+    if (degrees_of_freedom <= 60.0) return 2.000;
+    if (degrees_of_freedom <= 120.0) return 1.980;
+    return 1.960;
+}
+
+SampleSummary summarize_samples(const double* samples, size_t count) {
+    SampleSummary summary = {};
+    _LOG_FAIL_CHECK_(samples && count, "error", ERROR_REPORTS, return summary, NULL, EINVAL);
+
+    summary.count = count;
+    summary.min = samples[0];
+    summary.max = samples[0];
+
+    double sum = 0.0;
+    for (size_t sample_id = 0; sample_id < count; ++sample_id) {
+        sum += samples[sample_id];
+        if (samples[sample_id] < summary.min) summary.min = samples[sample_id];
+        if (samples[sample_id] > summary.max) summary.max = samples[sample_id];
+    }
+    summary.mean = sum / (double) count;
+
+    if (count < 2) {
+        summary.ci_low = summary.ci_high = summary.mean;
+        return summary;
+    }
+
+    double square_sum = 0.0;
+    for (size_t sample_id = 0; sample_id < count; ++sample_id) {
+        square_sum += (samples[sample_id] - summary.mean) * (samples[sample_id] - summary.mean);
+    }
+    summary.stddev = sqrt(square_sum / (double) (count - 1));
+
+    double margin = student_t_critical((double) (count - 1)) * summary.stddev / sqrt((double) count);
+    summary.ci_low = summary.mean - margin;
+    summary.ci_high = summary.mean + margin;
+
+    return summary;
+}
+
+void print_summary(FILE* file, SUMMARY_FORMAT format, const char* workload, size_t operation_count, const SampleSummary* summary) {
+    _LOG_FAIL_CHECK_(file && workload && summary, "error", ERROR_REPORTS, return, NULL, EINVAL);
+
+    double mops = summary->mean > 0.0 ? 1000.0 / summary->mean : 0.0;
+
+    switch (format) {
+        case SUMMARY_CSV: {
+            fprintf(file, "workload,tests,operations,mean_ns,stddev_ns,ci95_low_ns,ci95_high_ns,min_ns,max_ns,mops\n");
+            fprintf(file, "%s,%lu,%lu,%lg,%lg,%lg,%lg,%lg,%lg,%lg\n", workload, summary->count, operation_count,
+                summary->mean, summary->stddev, summary->ci_low, summary->ci_high, summary->min, summary->max, mops);
+            break;
+        }
+        case SUMMARY_JSON: {
+            fprintf(file, "{\"workload\": \"%s\", \"tests\": %lu, \"operations\": %lu, \"mean_ns\": %lg, \"stddev_ns\": %lg, "
+                          "\"ci95_low_ns\": %lg, \"ci95_high_ns\": %lg, \"min_ns\": %lg, \"max_ns\": %lg, \"mops\": %lg}\n",
+                workload, summary->count, operation_count, summary->mean, summary->stddev,
+                summary->ci_low, summary->ci_high, summary->min, summary->max, mops);
+            break;
+        }
+        default: break;
+    }
+}
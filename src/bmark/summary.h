@@ -0,0 +1,80 @@
+/**
+ * @file summary.h
+ * @author Kudryashov Ilya (kudriashov.it@phystech.edu)
+ * @brief Statistical summary of repeated benchmark measurements.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2023
+ * 
+ */
+
+#ifndef BMARK_SUMMARY_H
+#define BMARK_SUMMARY_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+
+enum SUMMARY_FORMAT {
+    SUMMARY_CSV,
+    SUMMARY_JSON,
+};
+
+/**
+ * @brief Summary of the sample.
+ * 
+ * @param count number of measurements
+ * @param mean sample mean
+ * @param stddev corrected sample standard deviation
+ * @param ci_low lower bound of the 95% confidence interval of the mean
+ * @param ci_high upper bound of the 95% confidence interval of the mean
+ * @param min smallest measurement
+ * @param max largest measurement
+ */
+struct SampleSummary {
+    size_t count = 0;
+    double mean = 0.0;
+    double stddev = 0.0;
+    double ci_low = 0.0;
+    double ci_high = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+};
+
+/**
+ * @brief Get current value of the monotonic clock.
+ * 
+ * @return time in nanoseconds
+ */
+uint64_t bmark_now_ns();
+
+/**
+ * @brief Get two-sided 95% critical value of Student's t-distribution.
+ * 
+ * @param degrees_of_freedom number of degrees of freedom
+ * @return critical value
+ */
+double student_t_critical(double degrees_of_freedom);
+
+/**
+ * @brief Calculate summary of the sample.
+ * 
+ * @param samples array of measurements
+ * @param count number of measurements
+ * @return sample summary
+ */
+SampleSummary summarize_samples(const double* samples, size_t count);
+
+/**
+ * @brief Print summary of the benchmark (time per operation in nanoseconds).
+ * 
+ * @param file file to print to
+ * @param format output format
+ * @param workload name of the workload
+ * @param operation_count number of operations in every test
+ * @param summary summary of nanoseconds per operation
+ */
+void print_summary(FILE* file, SUMMARY_FORMAT format, const char* workload, size_t operation_count, const SampleSummary* summary);
+
+#endif
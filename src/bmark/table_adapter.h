@@ -0,0 +1,255 @@
+/**
+ * @file table_adapter.h
+ * @author Kudryashov Ilya (kudriashov.it@phystech.edu)
+ * @brief Uniform access to the table engines, the tested variant selected at runtime and the key list selected at compile time.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2023
+ * 
+ */
+
+#ifndef BMARK_TABLE_ADAPTER_H
+#define BMARK_TABLE_ADAPTER_H
+
+#include <cstring>
+#include <type_traits>
+#include <x86intrin.h>
+
+#include "src/utils/config.h"
+#include "src/utils/main_utils.h"
+
+#include "src/hash/hash_functions.h"
+#include "src/hash/hash_table.hpp"
+#include "src/hash/cuckoo_table.hpp"
+#include "src/hash/robin_hood_table.hpp"
+#include "src/hash/string_table.hpp"
+#include "src/hash/tiered_table.hpp"
+
+#include "src/text_parser/text_parser.h"
+#include "src/text_parser/tokenizer.h"
+#include "src/text_parser/compact_wordlist.h"
+
+#include "key_generator.h"
+
+#if OPTIMIZATION_LEVEL >= 1
+static inline int simd_comparison_placeholder(__m256i alpha, __m256i beta) { return 0; }
+#endif
+
+#define __STRINGIFY_IMPL(name) #name
+#define __STRINGIFY(name) __STRINGIFY_IMPL(name)
+
+//* Engines valid for the keys of the build, every one of them can be selected at runtime.
+#ifdef STRING_KEYS
+#define TABLE_ENGINES(ENGINE) ENGINE(StringTable) ENGINE(TieredTable)
+#else
+#define TABLE_ENGINES(ENGINE) ENGINE(HashTable) ENGINE(CuckooTable) ENGINE(RobinHoodTable)
+#endif
+
+/**
+ * @brief Variant of the tested table selected at runtime.
+ * 
+ * @param engine name of the table engine (one of TABLE_ENGINES)
+ * @param hash hash function of the keys
+ * @param bucket_count number of buckets of HashTable and initial number of cells of RobinHoodTable
+ */
+struct TableVariant {
+    const char* engine = __STRINGIFY(TESTED_TABLE);
+    HashFunctionInfo hash = { __STRINGIFY(TESTED_HASH), TESTED_HASH };
+    size_t bucket_count = BUCKET_COUNT;
+};
+
+//* Variant every table of the run is built with (compile-time defaults, changed by the command line and by the matrix).
+inline TableVariant tested_variant = {};
+
+//* Name of the tested hash function, stored next to precomputed hashes.
+#define TESTED_HASH_NAME (tested_variant.hash.name)
+
+//* Function of the table engine, resolved by the type of the table (TABLE_FN(insert)(&table, ...) -> HashTable_insert for HashTable table).
+#define TABLE_FN(name) table_##name
+
+#define __TABLE_OVERLOAD(table, name)                                                                                           \
+    template <typename... Args> static inline auto table_##name(table* tbl, Args... args) -> decltype(table##_##name(tbl, args...)) { \
+        return table##_##name(tbl, args...);                                                                                    \
+    }                                                                                                                           \
+    template <typename... Args> static inline auto table_##name(const table* tbl, Args... args) -> decltype(table##_##name(tbl, args...)) { \
+        return table##_##name(tbl, args...);                                                                                    \
+    }
+
+#define __TABLE_OVERLOADS(table)                \
+    static inline void table_dtor(table* tbl) { table##_dtor(tbl); } \
+    __TABLE_OVERLOAD(table, status)             \
+    __TABLE_OVERLOAD(table, enable_filter)      \
+    __TABLE_OVERLOAD(table, insert)             \
+    __TABLE_OVERLOAD(table, find_value)         \
+    __TABLE_OVERLOAD(table, remove)             \
+    __TABLE_OVERLOAD(table, bucket_count)       \
+    __TABLE_OVERLOAD(table, bucket_size)        \
+    __TABLE_OVERLOAD(table, stats)
+
+TABLE_ENGINES(__TABLE_OVERLOADS)
+
+//* Constructors take the bucket count of the variant if the engine has one.
+static inline void table_ctor(HashTable* table, size_t expected_size, err_anchor_t err_code) {
+    HashTable_ctor(table, expected_size, err_code, tested_variant.bucket_count);
+}
+
+static inline void table_ctor(RobinHoodTable* table, size_t expected_size, err_anchor_t err_code) {
+    RobinHoodTable_ctor(table, expected_size, err_code, tested_variant.bucket_count);
+}
+
+/**
+ * @brief Check if tables of the engine are shaped by the bucket count of the variant.
+ * 
+ * @param engine name of the engine
+ * @return true if the constructor of the engine takes the bucket count
+ */
+static inline bool table_takes_bucket_count(const char* engine) {
+    return strcmp(engine, "HashTable") == 0 || strcmp(engine, "RobinHoodTable") == 0;
+}
+
+static inline void table_ctor(CuckooTable* table, size_t expected_size, err_anchor_t err_code) { CuckooTable_ctor(table, expected_size, err_code); }
+static inline void table_ctor(StringTable* table, size_t expected_size, err_anchor_t err_code) { StringTable_ctor(table, expected_size, err_code); }
+static inline void table_ctor(TieredTable* table, size_t expected_size, err_anchor_t err_code) { TieredTable_ctor(table, expected_size, err_code); }
+
+/**
+ * @brief Check if the engine can be selected in this build.
+ * 
+ * @param engine name of the engine
+ * @return true if the engine is one of TABLE_ENGINES
+ */
+static bool is_table_engine(const char* engine) {
+    #define __TABLE_ENGINE_MATCH(table) if (strcmp(engine, #table) == 0) return true;
+    TABLE_ENGINES(__TABLE_ENGINE_MATCH)
+    #undef __TABLE_ENGINE_MATCH
+    return false;
+}
+
+/**
+ * @brief Run the action with the table type of the engine.
+ * 
+ * @param engine name of the engine (should be checked with is_table_engine())
+ * @param action generic callable taking null pointer to the table type (for example, [&]<typename Table>(Table*) { ... })
+ * @return result of the action (-1 if the engine is unknown)
+ */
+template <typename Action> static int with_table_engine(const char* engine, Action action) {
+    #define __TABLE_ENGINE_CALL(table) if (strcmp(engine, #table) == 0) return action((table*) NULL);
+    TABLE_ENGINES(__TABLE_ENGINE_CALL)
+    #undef __TABLE_ENGINE_CALL
+    return -1;
+}
+
+//* Hash function passed as a type, so the templates measuring the table call it directly.
+template <hash_fn_t* Function> using HashFunction = std::integral_constant<hash_fn_t*, Function>;
+
+/**
+ * @brief Run the action with the hash function as a template argument.
+ * 
+ * @param hash hash function (one of HASH_FUNCTION_LIST)
+ * @param action generic callable taking the function type (for example, [&]<hash_fn_t* Hash>(HashFunction<Hash>) { ... })
+ * @return result of the action (-1 if the function is unknown)
+ */
+template <typename Action> static int with_hash_function(const HashFunctionInfo* hash, Action action) {
+    #define __HASH_FUNCTION_CALL(fn) if (hash->function == fn) return action(HashFunction<fn>{});
+    HASH_FUNCTION_LIST(__HASH_FUNCTION_CALL)
+    #undef __HASH_FUNCTION_CALL
+    return -1;
+}
+
+/**
+ * @brief Run the action with the table type and the hash function of the variant.
+ * 
+ * @param variant variant of the table (its engine should be checked with is_table_engine())
+ * @param action generic callable taking null pointer to the table type and the function type
+ *      (for example, [&]<typename Table, hash_fn_t* Hash>(Table*, HashFunction<Hash>) { ... })
+ * @return result of the action (-1 if the engine or the function is unknown)
+ */
+template <typename Action> static int with_table_variant(const TableVariant* variant, Action action) {
+    return with_table_engine(variant->engine, [&]<typename Table>(Table* table) {
+        return with_hash_function(&variant->hash, [&]<hash_fn_t* Hash>(HashFunction<Hash> hash) { return action(table, hash); });
+    });
+}
+
+#if OPTIMIZATION_LEVEL < 1
+#define WORD_ELEM(word_ptr) (word_ptr)
+#define WORD_COMPARATOR strcmp
+#else
+#define WORD_ELEM(word_ptr) _mm256_load_si256((const __m256i*) (word_ptr))
+#define WORD_COMPARATOR simd_comparison_placeholder
+#endif
+
+#ifdef STRING_KEYS
+typedef StringKey* word_list_t;
+#define READ_SAMPLE read_tokens
+#define GENERATE_SAMPLE generate_tokens
+#define TOKENIZE_SAMPLE tokenize_tokens
+#define BUILD_QUERY_LIST build_token_query_list
+//* Word of the list (WORD_AT(list, id) -> StringKey).
+#define WORD_AT(list, id) ((list)[id])
+//* Hash of the word (WORD_HASH(Hash, word), Hash is the hash function template argument).
+#define WORD_HASH(hash, word) (hash)((word).begin, (word).begin + (word).length)
+//* Key arguments of the table functions.
+#define WORD_KEY(word) (word).begin, (word).length
+#else
+typedef const char* word_list_t;
+#define READ_SAMPLE read_words
+#define GENERATE_SAMPLE generate_words
+#define TOKENIZE_SAMPLE tokenize_words
+#define BUILD_QUERY_LIST build_query_list
+#define WORD_AT(list, id) ((list) + (id) * MAX_WORD_LENGTH)
+#define WORD_HASH(hash, word) (hash)((word), (word) + MAX_WORD_LENGTH)
+#define WORD_KEY(word) WORD_ELEM(word), WORD_COMPARATOR
+#endif
+
+/**
+ * @brief Insert words known to be distinct (for example, generated keys without duplicates).
+ * 
+ * @param table table to fill
+ * @param words list of words
+ * @param count number of words in the list
+ * @param err_code variable to use as errno
+ */
+template <hash_fn_t* Hash, typename Table>
+static void table_insert_distinct(Table* table, word_list_t words, size_t count, err_anchor_t err_code) {
+    for (size_t word_id = 0; word_id < count; ++word_id) {
+        TABLE_FN(insert)(table, WORD_HASH(Hash, WORD_AT(words, word_id)), WORD_KEY(WORD_AT(words, word_id)), err_code);
+    }
+}
+
+#ifndef STRING_KEYS
+//* HashTable skips the duplicate checks and fills every overflow list with one bulk push.
+template <hash_fn_t* Hash>
+static void table_insert_distinct(HashTable* table, word_list_t words, size_t count, err_anchor_t err_code) {
+    hash_t* hashes = (hash_t*) calloc(count, sizeof(*hashes));
+    #if OPTIMIZATION_LEVEL < 1
+    HT_ELEM_T* values = (HT_ELEM_T*) calloc(count, sizeof(*values));
+    #else
+    //* Words of the list are aligned 32-byte vectors already.
+    const HT_ELEM_T* values = (const HT_ELEM_T*) (const void*) words;
+    #endif
+
+    _LOG_FAIL_CHECK_(hashes && values, "error", ERROR_REPORTS, {
+        free(hashes);
+        #if OPTIMIZATION_LEVEL < 1
+        free(values);
+        #endif
+        return;
+    }, err_code, ENOMEM);
+
+    for (size_t word_id = 0; word_id < count; ++word_id) {
+        hashes[word_id] = WORD_HASH(Hash, WORD_AT(words, word_id));
+        #if OPTIMIZATION_LEVEL < 1
+        values[word_id] = WORD_AT(words, word_id);
+        #endif
+    }
+
+    HashTable_insert_distinct(table, hashes, values, count, err_code);
+
+    free(hashes);
+    #if OPTIMIZATION_LEVEL < 1
+    free(values);
+    #endif
+}
+#endif
+
+#endif
@@ -0,0 +1,104 @@
+#include "workload.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "lib/util/dbg/debug.h"
+
+//* Names of the workloads in the order of BMARK_WORKLOAD.
+static const char* const WORKLOAD_NAMES[] = { "hit", "miss", "zipf", "mix", "build" };
+
+BMARK_WORKLOAD parse_workload(const char* name) {
+    _LOG_FAIL_CHECK_(name, "error", ERROR_REPORTS, return WORKLOAD_UNKNOWN, NULL, EINVAL);
+
+    for (int workload = 0; workload < WORKLOAD_UNKNOWN; ++workload) {
+        if (strcmp(name, WORKLOAD_NAMES[workload]) == 0) return (BMARK_WORKLOAD) workload;
+    }
+
+    return WORKLOAD_UNKNOWN;
+}
+
+const char* workload_name(BMARK_WORKLOAD workload) {
+    return workload < WORKLOAD_UNKNOWN ? WORKLOAD_NAMES[workload] : "unknown";
+}
+
+bool parse_operation_mix(const char* spec, double* insert_share, double* remove_share) {
+    _LOG_FAIL_CHECK_(spec && insert_share && remove_share, "error", ERROR_REPORTS, return false, NULL, EINVAL);
+
+    double insert_percent = 0.0, remove_percent = 0.0;
+    int parsed_length = 0;
+
+    if (sscanf(spec, "%lf:%lf%n", &insert_percent, &remove_percent, &parsed_length) != 2) return false;
+    if (spec[parsed_length] != '\0') return false;
+    if (insert_percent < 0.0 || remove_percent < 0.0 || insert_percent + remove_percent > 100.0) return false;
+
+    *insert_share = insert_percent / 100.0;
+    *remove_share = remove_percent / 100.0;
+
+    return true;
+}
+
+size_t* build_zipf_order(size_t count, double exponent) {
+    _LOG_FAIL_CHECK_(count, "error", ERROR_REPORTS, return NULL, NULL, EINVAL);
+
+    double* distribution = (double*) calloc(count, sizeof(*distribution));
+    size_t* ranked_keys = (size_t*) calloc(count, sizeof(*ranked_keys));
+    size_t* order = (size_t*) calloc(count, sizeof(*order));
+
+    _LOG_FAIL_CHECK_(distribution && ranked_keys && order, "error", ERROR_REPORTS, {
+        free(distribution);
+        free(ranked_keys);
+        free(order);
+        return NULL;
+    }, NULL, ENOMEM);
+
+    srand(QUERY_SEED);
+
+    double total_weight = 0.0;
+    for (size_t rank = 0; rank < count; ++rank) {
+        total_weight += 1.0 / pow((double) (rank + 1), exponent);
+        distribution[rank] = total_weight;
+
+        //* Fisher-Yates shuffle, so that the most popular keys are not the first words of the text.
+        size_t swap_id = (size_t) rand() % (rank + 1);
+        ranked_keys[rank] = ranked_keys[swap_id];
+        ranked_keys[swap_id] = rank;
+    }
+
+    for (size_t query_id = 0; query_id < count; ++query_id) {
+        double point = (double) rand() / RAND_MAX * total_weight;
+
+        size_t left = 0, right = count - 1;
+        while (left < right) {
+            size_t middle = left + (right - left) / 2;
+            if (distribution[middle] < point) left = middle + 1;
+            else right = middle;
+        }
+
+        order[query_id] = ranked_keys[left];
+    }
+
+    free(distribution);
+    free(ranked_keys);
+
+    return order;
+}
+
+BMARK_OPERATION* build_operation_mix(size_t count, double insert_share, double remove_share) {
+    BMARK_OPERATION* operations = (BMARK_OPERATION*) calloc(count, sizeof(*operations));
+    _LOG_FAIL_CHECK_(operations, "error", ERROR_REPORTS, return NULL, NULL, ENOMEM);
+
+    srand(QUERY_SEED);
+
+    for (size_t operation_id = 0; operation_id < count; ++operation_id) {
+        double point = (double) rand() / RAND_MAX;
+
+        if (point < insert_share) operations[operation_id] = OPERATION_INSERT;
+        else if (point < insert_share + remove_share) operations[operation_id] = OPERATION_REMOVE;
+        else operations[operation_id] = OPERATION_FIND;
+    }
+
+    return operations;
+}
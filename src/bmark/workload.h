@@ -0,0 +1,110 @@
+/**
+ * @file workload.h
+ * @author Kudryashov Ilya (kudriashov.it@phystech.edu)
+ * @brief Description and generation of benchmark workloads.
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2023
+ * 
+ */
+
+#ifndef BMARK_WORKLOAD_H
+#define BMARK_WORKLOAD_H
+
+#include <stddef.h>
+
+#include "src/utils/config.h"
+
+#include "summary.h"
+
+enum BMARK_WORKLOAD {
+    WORKLOAD_HIT,       //* lookups of stored keys only
+    WORKLOAD_MISS,      //* lookups with the share of absent keys set by the miss ratio
+    WORKLOAD_ZIPF,      //* lookups of keys drawn from Zipf distribution
+    WORKLOAD_MIX,       //* mix of insertions, lookups and removals
+    WORKLOAD_BUILD,     //* construction of the table from scratch
+    WORKLOAD_UNKNOWN,
+};
+
+enum BMARK_OPERATION {
+    OPERATION_FIND,
+    OPERATION_INSERT,
+    OPERATION_REMOVE,
+};
+
+/**
+ * @brief Parameters of the benchmark.
+ * 
+ * @param workload measured workload
+ * @param format output format of the summary
+ * @param test_count number of measurements
+ * @param repetition number of passes over the query list in one measurement
+ * @param miss_ratio share of absent keys among queries
+ * @param zipf_exponent exponent of Zipf distribution of queries
+ * @param insert_share share of insertions in the mix workload
+ * @param remove_share share of removals in the mix workload
+ * @param expected_keys key count hint passed to the constructors of new tables
+ * @param use_bloom whether new tables should have Bloom filter attached
+ */
+struct BenchmarkConfig {
+    BMARK_WORKLOAD workload = WORKLOAD_HIT;
+    SUMMARY_FORMAT format = SUMMARY_CSV;
+    unsigned test_count = TEST_COUNT;
+    unsigned repetition = TEST_REPETITION;
+    double miss_ratio = 0.0;
+    double zipf_exponent = DFLT_ZIPF_EXPONENT;
+    double insert_share = DFLT_MIX_INSERT_SHARE;
+    double remove_share = DFLT_MIX_REMOVE_SHARE;
+    size_t expected_keys = 0;
+    bool use_bloom = false;
+};
+
+/**
+ * @brief Get workload by its name.
+ * 
+ * @param name name of the workload (hit, miss, zipf, mix or build)
+ * @return workload (WORKLOAD_UNKNOWN if the name is not recognized)
+ */
+BMARK_WORKLOAD parse_workload(const char* name);
+
+/**
+ * @brief Get name of the workload.
+ * 
+ * @param workload workload
+ * @return name of the workload
+ */
+const char* workload_name(BMARK_WORKLOAD workload);
+
+/**
+ * @brief Read shares of insertions and removals from the string of the form "insert%:remove%".
+ * 
+ * @param spec string to parse (for example, "10:5")
+ * @param insert_share variable to store the share of insertions to
+ * @param remove_share variable to store the share of removals to
+ * @return true if the string was valid
+ */
+bool parse_operation_mix(const char* spec, double* insert_share, double* remove_share);
+
+/**
+ * @brief Build sequence of key indices following Zipf distribution, so that the key of rank r is queried with probability proportional to 1/r^exponent.
+ * 
+ * Ranks are assigned to the keys in random order.
+ * 
+ * @param count number of keys and length of the sequence
+ * @param exponent exponent of the distribution
+ * @return array of count indices (NULL if failed), should be freed by the caller
+ */
+size_t* build_zipf_order(size_t count, double exponent);
+
+/**
+ * @brief Build random sequence of operations.
+ * 
+ * @param count length of the sequence
+ * @param insert_share share of insertions
+ * @param remove_share share of removals
+ * @return array of count operations (NULL if failed), should be freed by the caller
+ */
+BMARK_OPERATION* build_operation_mix(size_t count, double insert_share, double remove_share);
+
+#endif
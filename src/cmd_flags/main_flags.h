@@ -10,3 +10,108 @@
  */
 
 #include "common_flags.h"
+
+{ {'B', "bloom"}, { GET_WRAPPER(use_bloom), 1, edit_flag },
+    "put Bloom filter in front of the hash table." },
+
+{ {'K', ""}, { GET_WRAPPER(expected_keys), 1, edit_int },
+    "size the table for the specified number of distinct keys.\n"
+    "\tBy default tables start small and grow on demand. Example: -K2500" },
+
+{ {'S', ""}, { GET_WRAPPER(stats_format), 1, edit_string },
+    "print memory, load factor and chain length statistics of the filled table.\n"
+    "\tFormat is either csv or json. Example: -Sjson" },
+
+{ {'M', ""}, { GET_WRAPPER(miss_ratio), 1, edit_double },
+    "set share of absent words among benchmark queries (0 by default).\n"
+    "\tExample: -M0.75" },
+
+{ {'W', ""}, { GET_WRAPPER(workload), 1, edit_string },
+    "run benchmark of the filled table and print mean time per operation with its 95% confidence interval.\n"
+    "\tWorkload is one of hit, miss (uses -M), zipf (uses -Z), mix (uses -X) or build. Example: -Wzipf" },
+
+{ {'F', ""}, { GET_WRAPPER(summary_format), 1, edit_string },
+    "set format of the benchmark summary, either csv (default) or json. Example: -Fjson" },
+
+{ {'T', ""}, { GET_WRAPPER(test_count), 1, edit_int },
+    "set number of benchmark measurements (TEST_COUNT by default). Example: -T10" },
+
+{ {'R', ""}, { GET_WRAPPER(test_repetition), 1, edit_int },
+    "set number of passes over the queries in one measurement (TEST_REPETITION by default). Example: -R100" },
+
+{ {'Z', ""}, { GET_WRAPPER(zipf_exponent), 1, edit_double },
+    "set exponent of Zipf distribution of queries in the zipf workload (0.99 by default). Example: -Z1.2" },
+
+{ {'X', ""}, { GET_WRAPPER(operation_mix), 1, edit_string },
+    "set percentages of insertions and removals in the mix workload, the rest are lookups (10:10 by default).\n"
+    "\tExample: -X20:5" },
+
+{ {'G', ""}, { GET_WRAPPER(generated_keys), 1, edit_int },
+    "fill the table with the specified number of generated keys instead of reading the input file.\n"
+    "\tExample: -G1000000" },
+
+{ {'N', ""}, { GET_WRAPPER(sweep_keys), 1, edit_int },
+    "build tables of 10^3, 10^4, ... generated keys up to the specified number and print\n"
+    "\tbuild and lookup throughput and memory per key for every size. Example: -N100000000" },
+
+{ {'L', ""}, { GET_WRAPPER(length_range), 1, edit_string },
+    "set range of generated key lengths (4:12 by default). Example: -L3:20" },
+
+{ {'A', ""}, { GET_WRAPPER(key_alphabet), 1, edit_string },
+    "set characters generated keys consist of (lowercase latin letters by default). Example: -Aacgt" },
+
+{ {'D', ""}, { GET_WRAPPER(duplicate_rate), 1, edit_double },
+    "set share of generated keys repeating previous ones (0 by default). Example: -D0.3" },
+
+{ {'C', ""}, { GET_WRAPPER(baseline_file), 1, edit_string },
+    "compare results of the -W benchmark or of the -V file with the baseline file (bmark.csv or -W summary)\n"
+    "\tusing Welch's t-test. The program fails if the candidate is significantly slower than allowed by -Q.\n"
+    "\tExample: -Cbaseline.csv" },
+
+{ {'V', ""}, { GET_WRAPPER(candidate_file), 1, edit_string },
+    "compare the specified result file with the baseline (-C) without running the benchmark. Example: -Vnew.csv" },
+
+{ {'Q', ""}, { GET_WRAPPER(regression_threshold), 1, edit_double },
+    "set largest tolerated slowdown of the candidate (0.05 by default). Example: -Q0.1" },
+
+{ {'P', ""}, { GET_WRAPPER(text_file), 1, edit_string },
+    "fill the table with lowercase words of the raw text file instead of reading the input file.\n"
+    "\tWords are runs of latin letters and non-ASCII UTF-8 characters. Example: -Pcomedy_of_errors.txt" },
+
+{ {'E', ""}, { GET_WRAPPER(wordlist_output), 1, edit_string },
+    "write words of the -P text file to the specified word list file and exit. Example: -Esample.wordlist" },
+
+{ {'J', ""}, { GET_WRAPPER(thread_count), 1, edit_int },
+    "set number of threads tokenizing the -P text file (all processors by default). Example: -J4" },
+
+{ {'U', ""}, { GET_WRAPPER(stream_file), 1, edit_string },
+    "stream the word list file into the table with reading, hashing and insertion overlapped in separate threads\n"
+    "\tand bounded memory, then print ingest throughput and exit (OPTIMIZATION_LEVEL >= 1). Example: -Uhuge.wordlist" },
+
+{ {'Y', ""}, { GET_WRAPPER(compact_output), 1, edit_string },
+    "convert the input word list to the compact word list file with hashes of the tested hash function and exit.\n"
+    "\tExample: -Ysample.cwl sample.wordlist" },
+
+{ {'c', ""}, { GET_WRAPPER(compact_file), 1, edit_string },
+    "load the compact word list file into the table, reusing its hashes if they were computed with the tested hash function,\n"
+    "\tthen print load throughput and exit. Example: -csample.cwl" },
+
+{ {'u', ""}, { GET_WRAPPER(shard_directory), 1, edit_string },
+    "load every word list file of the directory into the table with many reads in flight (io_uring,\n"
+    "\tor -J threads if it is not available), then print ingest throughput and exit (OPTIMIZATION_LEVEL >= 1).\n"
+    "\tExample: -ushards" },
+
+{ {'e', "engine"}, { GET_WRAPPER(engine_name), 1, edit_string },
+    "set table engine to test (one of the engines compiled in for the key type, TESTED_TABLE by default).\n"
+    "\tExample: --engine=RobinHoodTable" },
+
+{ {'f', "hash"}, { GET_WRAPPER(hash_name), 1, edit_string },
+    "set hash function to test (TESTED_HASH by default). Example: --hash=murmur" },
+
+{ {'b', "buckets"}, { GET_WRAPPER(bucket_count), 1, edit_int },
+    "set number of buckets of HashTable and initial capacity of RobinHoodTable (BUCKET_COUNT by default). Example: --buckets=4099" },
+
+{ {'m', "matrix"}, { GET_WRAPPER(matrix_spec), 1, edit_string },
+    "benchmark the -W workload on every combination of the listed engines, hash functions and bucket counts,\n"
+    "\twrite the results to matrix.csv (comparable with -V and -C) and exit.\n"
+    "\tExample: --matrix=\"engine=HashTable,RobinHoodTable;hash=murmur,sum;buckets=1021,4099\"" },
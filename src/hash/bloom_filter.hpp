@@ -0,0 +1,138 @@
+/**
+ * @file bloom_filter.hpp
+ * @author Kudryashov Ilya (kudriashov.it@phystech.edu)
+ * @brief Cache-line-blocked Bloom filter working on precomputed hashes.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef BLOOM_FILTER_HPP
+#define BLOOM_FILTER_HPP
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "lib/util/dbg/debug.h"
+
+#include "hash.h"
+
+//* Every key only touches one 64-byte block, so a check costs one cache miss at most.
+static const size_t BLOOM_BLOCK_BITS = 512;
+static const size_t BLOOM_BLOCK_WORDS = BLOOM_BLOCK_BITS / 64;
+
+static const size_t BLOOM_BITS_PER_KEY = 10;
+static const unsigned BLOOM_HASH_COUNT = 6;
+
+//* Multipliers used to derive block index and bit positions from the already computed hash.
+static const hash_t BLOOM_BLOCK_MIX = 0x9E3779B97F4A7C15;
+static const hash_t BLOOM_BIT_MIX = 0xC2B2AE3D27D4EB4F;
+
+struct BloomFilter {
+    uint64_t* blocks = NULL;
+    size_t block_count = 0;
+};
+
+
+//* DECLARATIONS
+
+/**
+ * @brief Construct the filter sized for the specified number of keys
+ *
+ * @param filter pointer to the filter
+ * @param key_count expected number of keys
+ * @param err_code pointer to the errno-functioning variable
+ */
+void BloomFilter_ctor(BloomFilter* filter, size_t key_count, ERROR_MARKER);
+
+/**
+ * @brief Destroy the filter
+ *
+ * @param filter pointer to the filter
+ */
+void BloomFilter_dtor(BloomFilter* filter);
+
+/**
+ * @brief Mark the hash as present in the filter
+ *
+ * @param filter pointer to the filter
+ * @param hash hash of the element
+ */
+void BloomFilter_insert(BloomFilter* filter, hash_t hash);
+
+/**
+ * @brief Check if the element with the specified hash may be present
+ *
+ * @param filter pointer to the filter
+ * @param hash hash of the element
+ * @return false if the element is definitely absent, true otherwise
+ */
+bool BloomFilter_check(const BloomFilter* filter, hash_t hash);
+
+/**
+ * @brief Get the number of bytes taken by the filter
+ *
+ * @param filter pointer to the filter
+ * @return size of the bit array (0 if the filter was not constructed)
+ */
+size_t BloomFilter_memory(const BloomFilter* filter);
+
+
+//* IMPLEMENTATIONS ==============================
+
+void BloomFilter_ctor(BloomFilter* filter, size_t key_count, err_anchor_t err_code) {
+    _LOG_FAIL_CHECK_(filter, "error", ERROR_REPORTS, return, err_code, EINVAL);
+
+    size_t block_count = (key_count * BLOOM_BITS_PER_KEY + BLOOM_BLOCK_BITS - 1) / BLOOM_BLOCK_BITS;
+    if (block_count == 0) block_count = 1;
+
+    filter->blocks = NULL;
+    int alloc_status = posix_memalign((void**)&filter->blocks, 64, block_count * BLOOM_BLOCK_WORDS * sizeof(*filter->blocks));
+    _LOG_FAIL_CHECK_(alloc_status == 0 && filter->blocks, "error", ERROR_REPORTS, {
+        *filter = {};
+        return;
+    }, err_code, ENOMEM);
+
+    for (size_t id = 0; id < block_count * BLOOM_BLOCK_WORDS; ++id) filter->blocks[id] = 0;
+
+    filter->block_count = block_count;
+
+    log_printf(STATUS_REPORTS, "status", "Bloom filter of %lu blocks was built for %lu keys.\n", block_count, key_count);
+}
+
+void BloomFilter_dtor(BloomFilter* filter) {
+    _LOG_FAIL_CHECK_(filter, "error", ERROR_REPORTS, return, NULL, EINVAL);
+
+    free(filter->blocks);
+    *filter = {};
+}
+
+void BloomFilter_insert(BloomFilter* filter, hash_t hash) {
+    uint64_t* block = filter->blocks + ((hash * BLOOM_BLOCK_MIX) >> 32) % filter->block_count * BLOOM_BLOCK_WORDS;
+    hash_t bits = (hash ^ (hash >> 29)) * BLOOM_BIT_MIX;
+
+    for (unsigned bit_id = 0; bit_id < BLOOM_HASH_COUNT; ++bit_id, bits >>= 9) {
+        unsigned position = (unsigned) (bits & (BLOOM_BLOCK_BITS - 1));
+        block[position / 64] |= 1ull << (position % 64);
+    }
+}
+
+bool BloomFilter_check(const BloomFilter* filter, hash_t hash) {
+    const uint64_t* block = filter->blocks + ((hash * BLOOM_BLOCK_MIX) >> 32) % filter->block_count * BLOOM_BLOCK_WORDS;
+    hash_t bits = (hash ^ (hash >> 29)) * BLOOM_BIT_MIX;
+
+    for (unsigned bit_id = 0; bit_id < BLOOM_HASH_COUNT; ++bit_id, bits >>= 9) {
+        unsigned position = (unsigned) (bits & (BLOOM_BLOCK_BITS - 1));
+        if (!(block[position / 64] & (1ull << (position % 64)))) return false;
+    }
+
+    return true;
+}
+
+size_t BloomFilter_memory(const BloomFilter* filter) {
+    return filter->block_count * BLOOM_BLOCK_WORDS * sizeof(*filter->blocks);
+}
+
+#endif
@@ -0,0 +1,613 @@
+/**
+ * @file cuckoo_table.hpp
+ * @author Kudryashov Ilya (kudriashov.it@phystech.edu)
+ * @brief Bucketized cuckoo hash table with bounded lookup cost.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef CUCKOO_TABLE_HPP
+#define CUCKOO_TABLE_HPP
+
+#include <x86intrin.h>
+
+#include "hash_table.hpp"
+
+//* Element can only live in one of its two buckets or in the stash of at most CUCKOO_STASH_SIZE elements, and each bucket
+//* is a single line of elements, so any lookup reads at most two bucket lines (plus the stash hashes if the stash is not empty).
+#if OPTIMIZATION_LEVEL < 1
+static const unsigned CUCKOO_SLOT_COUNT = 4;
+#else
+static const unsigned CUCKOO_SLOT_COUNT = 2;
+#endif
+
+//* Number of elements the stash takes before the table is rebuilt instead (their hashes fill one cache line).
+static const unsigned CUCKOO_STASH_SIZE = 8;
+static const unsigned CUCKOO_MAX_KICKS = 256;
+//* Number of seeds the grown table is tried with before the insertion fails.
+static const unsigned CUCKOO_MAX_REHASHES = 4;
+
+static const size_t DFLT_CUCKOO_BUCKET_COUNT = 1024;
+static const double CUCKOO_HINT_LOAD = 0.8;
+
+static const hash_t CUCKOO_ALT_MIX = 0xFF51AFD7ED558CCD;
+
+enum CUCKOO_STATUS {
+    CT_NULL         = 1 << 0,
+    CT_NO_CONTENT   = 1 << 1,
+    CT_INV_SIZE     = 1 << 2,
+    CT_BIG_STASH    = 1 << 3,
+};
+
+/**
+ * @brief One cache line of elements, empty slots hold HT_ELEM_POISON.
+ *
+ * Pointers to keys leave room for their full hashes in the same line. Vector keys fill the whole line and are compared
+ * directly, their hashes are only needed to move them and are kept in the parallel array of the table.
+ *
+ * @param hashes full hashes of the elements (OPTIMIZATION_LEVEL 0 only)
+ * @param slots elements
+ */
+struct CuckooBucket {
+    #if OPTIMIZATION_LEVEL < 1
+    hash_t hashes[CUCKOO_SLOT_COUNT];
+    #endif
+    HT_ELEM_T slots[CUCKOO_SLOT_COUNT];
+} __attribute__((__aligned__(64)));
+
+static_assert(sizeof(CuckooBucket) == 64, "Lookup reads exactly one line per bucket.");
+
+/**
+ * @brief Bucketized cuckoo table.
+ *
+ * @param size number of elements
+ * @param bucket_count number of buckets (power of 2)
+ * @param buckets bucket lines
+ * @param hashes hashes of the bucket elements, slot by slot (OPTIMIZATION_LEVEL >= 1 only)
+ * @param seed seed the buckets of the elements are mixed with (0 until a rebuild failed with the previous seed)
+ * @param stash_size number of elements in the stash (at most CUCKOO_STASH_SIZE)
+ * @param stash_hashes hashes of the stash elements
+ * @param stash elements that could not be placed into their buckets (poison element is always stored here)
+ * @param filter Bloom filter in front of the table
+ */
+struct CuckooTable {
+    size_t size = 0;
+    size_t bucket_count = 0;
+    CuckooBucket* buckets = NULL;
+    #if OPTIMIZATION_LEVEL >= 1
+    hash_t* hashes = NULL;
+    #endif
+    hash_t seed = 0;
+    size_t stash_size = 0;
+    hash_t* stash_hashes = NULL;
+    HT_ELEM_T* stash = NULL;
+    BloomFilter filter = {};
+};
+
+
+//* DECLARATIONS
+
+/**
+ * @brief Construct cuckoo table
+ *
+ * @param table pointer to the table
+ * @param expected_size expected number of keys used to size the table (0 if unknown)
+ * @param err_code pointer to the errno-functioning variable
+ */
+void CuckooTable_ctor(CuckooTable* table, size_t expected_size, ERROR_MARKER);
+
+/**
+ * @brief Destroy the table
+ *
+ * @param table pointer to the table to destroy
+ */
+void CuckooTable_dtor(CuckooTable* table);
+
+/**
+ * @brief Get status of the table
+ *
+ * @param table pointer to the table
+ * @return ht_status_t
+ */
+ht_status_t CuckooTable_status(const CuckooTable* table);
+
+/**
+ * @brief Put Bloom filter in front of the table
+ *
+ * @param table pointer to the empty table
+ * @param key_count expected number of keys
+ * @param err_code pointer to the errno-functioning variable
+ */
+void CuckooTable_enable_filter(CuckooTable* table, size_t key_count, ERROR_MARKER);
+
+/**
+ * @brief Insert an element, kicking other elements to their alternative buckets if needed
+ *
+ * Element that finds no place in its buckets or in the stash makes the table rebuild with twice as many buckets and a new seed.
+ * If no seed helps (too many elements share the same hash), the element is not inserted, err_code is set to ENOSPC
+ * and the table is left as it was.
+ *
+ * @param table pointer to the table
+ * @param hash hash of the new element
+ * @param value value of the element
+ * @param comparator comparator function between elements (should return 0 on equality)
+ * @param err_code pointer to the errno-functioning variable
+ */
+void CuckooTable_insert(CuckooTable* table, hash_t hash, HT_ELEM_T value, ht_compar_fn_t* comparator, ERROR_MARKER);
+
+/**
+ * @brief Find element in the table by its hash and value
+ *
+ * @param table table to search in
+ * @param hash hash of the element
+ * @param value exact value of the element
+ * @param comparator comparator function between elements (should return 0 on equality)
+ * @return pointer to the element cell in table (NULL if the element was not found)
+ */
+HT_ELEM_T* CuckooTable_find_value(const CuckooTable* table, hash_t hash, HT_ELEM_T value, ht_compar_fn_t* comparator);
+
+/**
+ * @brief Remove element from the table
+ *
+ * @param table pointer to the table
+ * @param hash hash of the element
+ * @param value exact value of the element
+ * @param comparator comparator function between elements (should return 0 on equality)
+ * @param err_code pointer to the errno-functioning variable
+ */
+void CuckooTable_remove(CuckooTable* table, hash_t hash, HT_ELEM_T value, ht_compar_fn_t* comparator, ERROR_MARKER);
+
+/**
+ * @brief Get the number of buckets in the table
+ *
+ * @param table pointer to the table
+ * @return number of buckets
+ */
+size_t CuckooTable_bucket_count(const CuckooTable* table);
+
+/**
+ * @brief Get the number of elements stored in the bucket
+ *
+ * @param table pointer to the table
+ * @param bucket_id index of the bucket
+ * @return number of elements in the bucket
+ */
+size_t CuckooTable_bucket_size(const CuckooTable* table, size_t bucket_id);
+
+/**
+ * @brief Collect memory and bucket occupancy statistics of the table (probes are counted in bucket reads)
+ *
+ * @param table pointer to the table
+ * @param stats variable to store statistics to
+ */
+void CuckooTable_stats(const CuckooTable* table, TableStats* stats);
+
+
+//* IMPLEMENTATIONS ==============================
+
+static inline bool _cuckoo_slot_empty(HT_ELEM_T element) {
+    #if OPTIMIZATION_LEVEL < 1
+    return element == HT_ELEM_POISON;
+    #else
+    return _mm256_testz_si256(element, element);
+    #endif
+}
+
+static inline hash_t* _CuckooTable_hash(const CuckooTable* table, size_t bucket_id, size_t slot_id) {
+    #if OPTIMIZATION_LEVEL < 1
+    return &table->buckets[bucket_id].hashes[slot_id];
+    #else
+    return &table->hashes[bucket_id * CUCKOO_SLOT_COUNT + slot_id];
+    #endif
+}
+
+static inline size_t _CuckooBucket_size(const CuckooBucket* bucket) {
+    size_t size = 0;
+    for (size_t slot_id = 0; slot_id < CUCKOO_SLOT_COUNT; ++slot_id) size += !_cuckoo_slot_empty(bucket->slots[slot_id]);
+    return size;
+}
+
+/**
+ * @brief Free buckets and the stash of the table
+ *
+ * @param table pointer to the table
+ */
+static void _CuckooTable_free(CuckooTable* table) {
+    free(table->buckets);
+    #if OPTIMIZATION_LEVEL >= 1
+    free(table->hashes);
+    #endif
+    free(table->stash_hashes);
+    free(table->stash);
+}
+
+/**
+ * @brief Allocate empty buckets and the empty stash of the table
+ *
+ * @param table pointer to the table
+ * @param bucket_count number of buckets (should be a power of 2)
+ * @param seed seed of the buckets
+ * @return 0 if allocation was successful, 1 otherwise
+ */
+static int _CuckooTable_alloc(CuckooTable* table, size_t bucket_count, hash_t seed) {
+    *table = {};
+
+    if (posix_memalign((void**)&table->buckets, 64, bucket_count * sizeof(*table->buckets)) != 0) table->buckets = NULL;
+    if (posix_memalign((void**)&table->stash, 64, CUCKOO_STASH_SIZE * sizeof(*table->stash)) != 0) table->stash = NULL;
+    table->stash_hashes = (hash_t*) calloc(CUCKOO_STASH_SIZE, sizeof(*table->stash_hashes));
+    bool allocated = table->buckets && table->stash && table->stash_hashes;
+
+    #if OPTIMIZATION_LEVEL >= 1
+    table->hashes = (hash_t*) calloc(bucket_count * CUCKOO_SLOT_COUNT, sizeof(*table->hashes));
+    allocated = allocated && table->hashes;
+    #endif
+
+    if (!allocated) {
+        _CuckooTable_free(table);
+        *table = {};
+        return 1;
+    }
+
+    for (size_t id = 0; id < bucket_count; ++id) table->buckets[id] = {};
+
+    table->bucket_count = bucket_count;
+    table->seed = seed;
+
+    return 0;
+}
+
+/**
+ * @brief Add the element to the stash
+ *
+ * @param table pointer to the table
+ * @param hash hash of the element
+ * @param value element
+ * @return false if the stash is full
+ */
+static bool _CuckooTable_stash_push(CuckooTable* table, hash_t hash, HT_ELEM_T value) {
+    if (table->stash_size == CUCKOO_STASH_SIZE) return false;
+
+    table->stash_hashes[table->stash_size] = hash;
+    table->stash[table->stash_size] = value;
+    ++table->stash_size;
+
+    return true;
+}
+
+//* Hash the buckets are taken from, remixed only once a rebuild changed the seed.
+static inline hash_t _CuckooTable_mix(const CuckooTable* table, hash_t hash) {
+    if (!table->seed) return hash;
+
+    hash ^= table->seed;
+    hash ^= hash >> 33;
+    hash *= CUCKOO_ALT_MIX;
+    hash ^= hash >> 33;
+
+    return hash;
+}
+
+static inline size_t _CuckooTable_first_bucket(const CuckooTable* table, hash_t hash) {
+    return (size_t) _CuckooTable_mix(table, hash) & (table->bucket_count - 1);
+}
+
+static inline size_t _CuckooTable_second_bucket(const CuckooTable* table, hash_t hash) {
+    hash = _CuckooTable_mix(table, hash);
+
+    size_t mask = table->bucket_count - 1;
+    size_t offset = (size_t) ((hash * CUCKOO_ALT_MIX) >> 32) & mask;
+
+    return ((size_t) hash & mask) ^ (offset ? offset : 1);
+}
+
+static inline size_t _CuckooTable_alternative(const CuckooTable* table, size_t bucket_id, hash_t hash) {
+    size_t first = _CuckooTable_first_bucket(table, hash);
+    return bucket_id == first ? _CuckooTable_second_bucket(table, hash) : first;
+}
+
+static inline bool _CuckooTable_put(CuckooTable* table, size_t bucket_id, hash_t hash, HT_ELEM_T value) {
+    CuckooBucket* bucket = table->buckets + bucket_id;
+
+    for (size_t slot_id = 0; slot_id < CUCKOO_SLOT_COUNT; ++slot_id) {
+        if (!_cuckoo_slot_empty(bucket->slots[slot_id])) continue;
+
+        bucket->slots[slot_id] = value;
+        *_CuckooTable_hash(table, bucket_id, slot_id) = hash;
+
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Place the element into the buckets or into the not yet full stash without checking for duplicates
+ *
+ * Kicks move other elements, so on failure some element of the table may be the homeless one.
+ *
+ * @param table pointer to the table
+ * @param hash [in/out] hash of the element, hash of the homeless element on failure
+ * @param value [in/out] element to place (not HT_ELEM_POISON), homeless element on failure
+ * @return true if all elements found their place
+ */
+static bool _CuckooTable_place(CuckooTable* table, hash_t* hash, HT_ELEM_T* value) {
+    size_t bucket_id = _CuckooTable_first_bucket(table, *hash);
+    if (_CuckooTable_put(table, bucket_id, *hash, *value)) return true;
+
+    bucket_id = _CuckooTable_second_bucket(table, *hash);
+    if (_CuckooTable_put(table, bucket_id, *hash, *value)) return true;
+
+    for (unsigned kick_id = 0; kick_id < CUCKOO_MAX_KICKS; ++kick_id) {
+        size_t slot_id = (size_t) (*hash + kick_id) % CUCKOO_SLOT_COUNT;
+
+        hash_t* victim_hash = _CuckooTable_hash(table, bucket_id, slot_id);
+        HT_ELEM_T* victim = &table->buckets[bucket_id].slots[slot_id];
+
+        hash_t hash_copy = *victim_hash;
+        *victim_hash = *hash;
+        *hash = hash_copy;
+
+        HT_ELEM_T value_copy = *victim;
+        *victim = *value;
+        *value = value_copy;
+
+        bucket_id = _CuckooTable_alternative(table, bucket_id, *hash);
+        if (_CuckooTable_put(table, bucket_id, *hash, *value)) return true;
+    }
+
+    return _CuckooTable_stash_push(table, *hash, *value);
+}
+
+/**
+ * @brief Place the element into the new table
+ *
+ * @return true if the element was placed (the new table is discarded otherwise, so nothing is lost)
+ */
+static bool _CuckooTable_relocate(CuckooTable* table, hash_t hash, HT_ELEM_T value) {
+    if (_cuckoo_slot_empty(value)) return _CuckooTable_stash_push(table, hash, value);
+
+    return _CuckooTable_place(table, &hash, &value);
+}
+
+/**
+ * @brief Rebuild the table with the new element, new number of buckets and new seed
+ *
+ * @param table pointer to the table (left as it was on failure)
+ * @param bucket_count new number of buckets
+ * @param seed new seed
+ * @param hash hash of the new element
+ * @param value new element
+ * @return 0 if relocation was successful, 1 otherwise
+ */
+static int _CuckooTable_rebuild(CuckooTable* table, size_t bucket_count, hash_t seed, hash_t hash, HT_ELEM_T value) {
+    TRACE_SPAN_ID("CuckooTable_rebuild", bucket_count);
+
+    CuckooTable new_table = {};
+    if (_CuckooTable_alloc(&new_table, bucket_count, seed)) return 1;
+
+    bool success = _CuckooTable_relocate(&new_table, hash, value);
+
+    for (size_t bucket_id = 0; bucket_id < table->bucket_count && success; ++bucket_id) {
+        for (size_t slot_id = 0; slot_id < CUCKOO_SLOT_COUNT && success; ++slot_id) {
+            HT_ELEM_T element = table->buckets[bucket_id].slots[slot_id];
+            if (_cuckoo_slot_empty(element)) continue;
+
+            success = _CuckooTable_relocate(&new_table, *_CuckooTable_hash(table, bucket_id, slot_id), element);
+        }
+    }
+
+    for (size_t stash_id = 0; stash_id < table->stash_size && success; ++stash_id) {
+        success = _CuckooTable_relocate(&new_table, table->stash_hashes[stash_id], table->stash[stash_id]);
+    }
+
+    if (!success) {
+        _CuckooTable_free(&new_table);
+        return 1;
+    }
+
+    log_printf(STATUS_REPORTS, "status", "Cuckoo table was rebuilt with %lu buckets.\n", bucket_count);
+
+    _CuckooTable_free(table);
+
+    new_table.size = table->size + 1;
+    new_table.filter = table->filter;
+    *table = new_table;
+
+    return 0;
+}
+
+void CuckooTable_ctor(CuckooTable* table, size_t expected_size, err_anchor_t err_code) {
+    TRACE_SPAN("CuckooTable_ctor");
+
+    _LOG_FAIL_CHECK_(table, "error", ERROR_REPORTS, return, err_code, EINVAL);
+
+    *table = {};
+
+    size_t bucket_count = DFLT_CUCKOO_BUCKET_COUNT;
+    //* Two buckets at least, so that the alternative bucket is never the first one.
+    if (expected_size) {
+        for (bucket_count = 2; (double) (bucket_count * CUCKOO_SLOT_COUNT) * CUCKOO_HINT_LOAD < (double) expected_size;)
+            bucket_count *= 2;
+    }
+
+    _LOG_FAIL_CHECK_(_CuckooTable_alloc(table, bucket_count, 0) == 0, "error", ERROR_REPORTS, {
+        *table = {};
+        return;
+    }, err_code, ENOMEM);
+}
+
+void CuckooTable_dtor(CuckooTable* table) {
+    _LOG_FAIL_CHECK_(CuckooTable_status(table) == 0, "error", ERROR_REPORTS, return, NULL, EINVAL);
+
+    _CuckooTable_free(table);
+
+    if (table->filter.blocks) BloomFilter_dtor(&table->filter);
+
+    *table = {};
+}
+
+ht_status_t CuckooTable_status(const CuckooTable* table) {
+    if (!table) return CT_NULL;
+    if (!table->buckets) return CT_NO_CONTENT;
+    #if OPTIMIZATION_LEVEL >= 1
+    if (!table->hashes) return CT_NO_CONTENT;
+    #endif
+    if (!table->stash || !table->stash_hashes) return CT_NO_CONTENT;
+    if (table->stash_size > CUCKOO_STASH_SIZE) return CT_BIG_STASH;
+
+    #ifdef _DEBUG
+    size_t element_count = table->stash_size;
+    for (size_t id = 0; id < table->bucket_count; ++id) element_count += _CuckooBucket_size(&table->buckets[id]);
+    if (element_count != table->size) return CT_INV_SIZE;
+    #endif
+
+    return 0;
+}
+
+void CuckooTable_enable_filter(CuckooTable* table, size_t key_count, err_anchor_t err_code) {
+    _LOG_FAIL_CHECK_(CuckooTable_status(table) == 0, "error", ERROR_REPORTS, return, err_code, EINVAL);
+    _LOG_FAIL_CHECK_(table->size == 0, "error", ERROR_REPORTS, return, err_code, EINVAL);
+    _LOG_FAIL_CHECK_(!table->filter.blocks, "error", ERROR_REPORTS, return, err_code, EINVAL);
+
+    BloomFilter_ctor(&table->filter, key_count, err_code);
+}
+
+void CuckooTable_insert(CuckooTable* table, hash_t hash, HT_ELEM_T value, ht_compar_fn_t* comparator, err_anchor_t err_code) {
+    _API_CHECK_(CuckooTable_status(table) == 0, return, err_code, EINVAL);
+
+    if (CuckooTable_find_value(table, hash, value, comparator)) return;
+
+    bool placed = false;
+
+    //* Poison element would look like an empty slot, so it can only be stored in the stash.
+    if (_cuckoo_slot_empty(value)) {
+        placed = _CuckooTable_stash_push(table, hash, value);
+    } else if (table->stash_size < CUCKOO_STASH_SIZE) {
+        //* Element left homeless by the kicks still fits into the stash.
+        hash_t homeless_hash = hash;
+        HT_ELEM_T homeless = value;
+        placed = _CuckooTable_place(table, &homeless_hash, &homeless);
+    } else {
+        //* Kicks are only run on a copy of the table once the stash is full, so that no stored element is dropped.
+        placed = _CuckooTable_put(table, _CuckooTable_first_bucket(table, hash), hash, value) ||
+                 _CuckooTable_put(table, _CuckooTable_second_bucket(table, hash), hash, value);
+    }
+
+    if (placed) {
+        ++table->size;
+    } else {
+        //* The table is grown even if it is half-empty, the new seed may also split elements crowding the same buckets.
+        for (unsigned rehash_id = 1; !placed && rehash_id <= CUCKOO_MAX_REHASHES; ++rehash_id) {
+            placed = _CuckooTable_rebuild(table, table->bucket_count * 2, table->seed + rehash_id, hash, value) == 0;
+        }
+
+        _LOG_FAIL_CHECK_(placed, "error", ERROR_REPORTS, {
+            log_printf(ERROR_REPORTS, "error", "No place was found for the element with hash %llu, too many elements share its hash.\n", hash);
+            return;
+        }, err_code, ENOSPC);
+    }
+
+    if (table->filter.blocks) BloomFilter_insert(&table->filter, hash);
+}
+
+HT_ELEM_T* CuckooTable_find_value(const CuckooTable* table, hash_t hash, HT_ELEM_T value, ht_compar_fn_t* comparator) {
+    _API_CHECK_(CuckooTable_status(table) == 0, return NULL, NULL, EINVAL);
+
+    if (table->filter.blocks && !BloomFilter_check(&table->filter, hash)) return NULL;
+
+    if (!_cuckoo_slot_empty(value)) {
+        size_t bucket_ids[2] = { _CuckooTable_first_bucket(table, hash), _CuckooTable_second_bucket(table, hash) };
+
+        //* Request both lines at once so that a miss costs one memory round trip instead of two.
+        _mm_prefetch((const char*) (table->buckets + bucket_ids[1]), _MM_HINT_T0);
+
+        for (size_t bucket_id : bucket_ids) {
+            CuckooBucket* bucket = table->buckets + bucket_id;
+
+            for (size_t slot_id = 0; slot_id < CUCKOO_SLOT_COUNT; ++slot_id) {
+                #if OPTIMIZATION_LEVEL < 1
+                if (bucket->hashes[slot_id] != hash || _cuckoo_slot_empty(bucket->slots[slot_id])) continue;
+                #endif
+                if (ht_elem_equal(bucket->slots[slot_id], value, comparator)) return &bucket->slots[slot_id];
+            }
+        }
+    }
+
+    for (size_t stash_id = 0; stash_id < table->stash_size; ++stash_id) {
+        if (table->stash_hashes[stash_id] == hash && ht_elem_equal(table->stash[stash_id], value, comparator))
+            return &table->stash[stash_id];
+    }
+
+    return NULL;
+}
+
+void CuckooTable_remove(CuckooTable* table, hash_t hash, HT_ELEM_T value, ht_compar_fn_t* comparator, err_anchor_t err_code) {
+    _API_CHECK_(CuckooTable_status(table) == 0, return, err_code, EINVAL);
+
+    HT_ELEM_T* element = CuckooTable_find_value(table, hash, value, comparator);
+    if (!element) return;
+
+    //* Last element of the stash takes place of the removed one, bucket slots are simply emptied.
+    if (element >= table->stash && element < table->stash + table->stash_size) {
+        size_t stash_id = (size_t) (element - table->stash);
+        --table->stash_size;
+
+        table->stash_hashes[stash_id] = table->stash_hashes[table->stash_size];
+        table->stash[stash_id] = table->stash[table->stash_size];
+    } else {
+        *element = HT_ELEM_POISON;
+    }
+
+    --table->size;
+}
+
+size_t CuckooTable_bucket_count(const CuckooTable* table) {
+    return table->bucket_count;
+}
+
+size_t CuckooTable_bucket_size(const CuckooTable* table, size_t bucket_id) {
+    return _CuckooBucket_size(&table->buckets[bucket_id]);
+}
+
+void CuckooTable_stats(const CuckooTable* table, TableStats* stats) {
+    _LOG_FAIL_CHECK_(CuckooTable_status(table) == 0 && stats, "error", ERROR_REPORTS, return, NULL, EINVAL);
+
+    *stats = {};
+
+    stats->key_count = table->size;
+    stats->bucket_count = table->bucket_count;
+    stats->bytes_allocated = sizeof(*table) + table->bucket_count * sizeof(*table->buckets)
+                           + CUCKOO_STASH_SIZE * (sizeof(*table->stash_hashes) + sizeof(*table->stash))
+                           + BloomFilter_memory(&table->filter);
+    #if OPTIMIZATION_LEVEL >= 1
+    stats->bytes_allocated += table->bucket_count * CUCKOO_SLOT_COUNT * sizeof(*table->hashes);
+    #endif
+    stats->bytes_used = table->size * sizeof(HT_ELEM_T);
+
+    //* Stash hashes are scanned after both buckets, and only when the stash is not empty.
+    size_t stash_reads = table->stash_size ? 1 : 0;
+
+    for (size_t bucket_id = 0; bucket_id < table->bucket_count; ++bucket_id) {
+        const CuckooBucket* bucket = &table->buckets[bucket_id];
+
+        TableStats_add_chain(stats, _CuckooBucket_size(bucket));
+
+        for (size_t slot_id = 0; slot_id < CUCKOO_SLOT_COUNT; ++slot_id) {
+            if (_cuckoo_slot_empty(bucket->slots[slot_id])) continue;
+
+            hash_t hash = *_CuckooTable_hash(table, bucket_id, slot_id);
+            stats->hit_probe_total += _CuckooTable_first_bucket(table, hash) == bucket_id ? 1lu : 2lu;
+        }
+
+        stats->miss_probe_total += 2 + stash_reads;
+    }
+
+    stats->hit_probe_total += table->stash_size * (2 + stash_reads);
+    stats->overflowing_buckets = table->stash_size;
+
+    TableStats_finish(stats);
+}
+
+#endif
@@ -5,6 +5,7 @@
 #include <x86intrin.h>
 
 #include "lib/util/dbg/debug.h"
+#include "lib/util/util.h"
 #include "src/utils/config.h"
 
 static hash_t cycle_left(hash_t num, unsigned short shift) {
@@ -88,3 +89,22 @@ asm(R"(  jb      .LBB0_2)"                      "\n");
 asm(R"(.LBB0_3:"                                "\n");
 asm(R"(  retq)"                                 "\n");
 #endif
+
+#define __HASH_FUNCTION_INFO(function) { #function, function },
+static const HashFunctionInfo HASH_FUNCTIONS[] = { HASH_FUNCTION_LIST(__HASH_FUNCTION_INFO) };
+#undef __HASH_FUNCTION_INFO
+
+const HashFunctionInfo* find_hash_function(const char* name) {
+    _LOG_FAIL_CHECK_(name, "error", ERROR_REPORTS, return NULL, NULL, EINVAL);
+
+    size_t length = strlen(name);
+
+    for (size_t function_id = 0; function_id < ARR_SIZE(HASH_FUNCTIONS); ++function_id) {
+        const char* function_name = HASH_FUNCTIONS[function_id].name;
+
+        if (strcmp(function_name, name) == 0) return &HASH_FUNCTIONS[function_id];
+        if (strncmp(function_name, name, length) == 0 && strcmp(function_name + length, "_hash") == 0) return &HASH_FUNCTIONS[function_id];
+    }
+
+    return NULL;
+}
@@ -12,6 +12,10 @@
 #ifndef HASH_FUNCTIONS_H
 #define HASH_FUNCTIONS_H
 
+#include <stddef.h>
+
+#include "src/utils/config.h"
+
 #include "hash.h"
 
 hash_t constant_hash    (const void* begin, const void* end);
@@ -27,4 +31,33 @@ hash_t murmur_hash      (const void* begin, const void* end);
 extern hash_t murmur_hash(const void* begin, const void* end);
 #endif
 
+//* Functions selectable by name (HASH_FUNCTION_LIST(FUNCTION) -> FUNCTION(constant_hash) FUNCTION(first_char_hash) ...).
+#define HASH_FUNCTION_LIST(FUNCTION)    \
+    FUNCTION(constant_hash)             \
+    FUNCTION(first_char_hash)           \
+    FUNCTION(length_hash)               \
+    FUNCTION(sum_hash)                  \
+    FUNCTION(left_shift_hash)           \
+    FUNCTION(right_shift_hash)          \
+    FUNCTION(murmur_hash)
+
+/**
+ * @brief Hash function selectable by name.
+ * 
+ * @param name name of the function
+ * @param function the function
+ */
+struct HashFunctionInfo {
+    const char* name = "";
+    hash_fn_t* function = NULL;
+};
+
+/**
+ * @brief Find hash function by its name.
+ * 
+ * @param name name of the function with or without the "_hash" suffix (for example, murmur_hash or murmur)
+ * @return description of the function (NULL if there is no such function)
+ */
+const HashFunctionInfo* find_hash_function(const char* name);
+
 #endif
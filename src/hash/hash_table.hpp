@@ -24,39 +24,92 @@ typedef HT_ELEM_T list_elem_t;
 typedef __m256i HT_ELEM_T __attribute__((__aligned__(32)));
 const HT_ELEM_T HT_ELEM_POISON = _mm256_set1_epi8(0);
 typedef HT_ELEM_T list_elem_t __attribute__((__aligned__(32)));
+//* Overflow keys are packed densely apart from the links, so that bucket scans read only key memory.
+#define LIST_SPLIT_STORAGE
 #endif
 
 static const list_elem_t LIST_ELEM_POISON = HT_ELEM_POISON;
 
 #include "lib/list/listworks.h"
+#include "lib/util/dbg/trace.h"
 
-static const size_t DFLT_HT_CELL_SIZE = 256;
+#include "bloom_filter.hpp"
+#include "table_stats.hpp"
+
+//* Overflow lists are allocated on first spill with this many cells (one of them is the list sentinel)
+//* and double when full, unless the table was given an expected number of keys.
+static const size_t HT_MIN_BUCKET_CAPACITY = 4;
+
+static const size_t HT_BUCKET_ALIGNMENT = 64;
 
 typedef unsigned ht_status_t;
 
 typedef int ht_compar_fn_t(HT_ELEM_T alpha, HT_ELEM_T beta);
 
+/**
+ * @brief Check if two table elements are equal
+ * 
+ * @param alpha
+ * @param beta
+ * @param comparator comparator function between elements (ignored if elements are compared with SIMD)
+ * @return true if elements are equal
+ */
+static inline bool ht_elem_equal(HT_ELEM_T alpha, HT_ELEM_T beta, ht_compar_fn_t* comparator) {
+    #if OPTIMIZATION_LEVEL < 1
+    return comparator(alpha, beta) == 0;
+    #else
+    SILENCE_UNUSED(comparator);
+    __m256i difference = _mm256_xor_si256(alpha, beta);
+    return _mm256_testz_si256(difference, difference);
+    #endif
+}
+
 enum HT_STATUS {
     HT_NULL         = 1 << 0,
     HT_NO_CONTENT   = 1 << 1,
     HT_BROKEN_CELL  = 1 << 3,
 };
 
+//* Number of elements stored right in the bucket header (1 for SIMD words, 6 for string pointers).
+static const size_t HT_INLINE_COUNT = (HT_BUCKET_ALIGNMENT - sizeof(size_t) - sizeof(List*)) / sizeof(HT_ELEM_T);
+
+/**
+ * @brief Cache-line-sized bucket header, so that lookups in short buckets cost a single cache miss.
+ * 
+ * @param inline_values first HT_INLINE_COUNT elements of the bucket
+ * @param size total number of elements in the bucket
+ * @param overflow list of the elements that did not fit in the header (NULL until the first spill)
+ */
+struct HashBucket {
+    HT_ELEM_T inline_values[HT_INLINE_COUNT];
+    size_t size = 0;
+    List* overflow = NULL;
+} __attribute__((__aligned__(HT_BUCKET_ALIGNMENT)));
+
 struct HashTable {
     size_t size = 0;
-    List* contents = NULL;
+    size_t bucket_count = BUCKET_COUNT;
+    size_t bucket_capacity = HT_MIN_BUCKET_CAPACITY;
+    HashBucket* contents = NULL;
+    BloomFilter filter = {};
+#ifdef TABLE_ARENA
+    //* Buckets and overflow lists are drawn from the arena and freed all at once with the table.
+    Arena arena = {};
+#endif
 };
 
 
 //* DECLARATIONS
 
 /**
- * @brief Construct hash table data structure
+ * @brief Construct hash table data structure (overflow lists are allocated on first spill)
  * 
  * @param table pointer to the table
+ * @param expected_size expected number of keys used to size the buckets (0 if unknown)
  * @param err_code pointer to the errno-functioning variable 
+ * @param bucket_count number of buckets
  */
-void HashTable_ctor(HashTable* table, ERROR_MARKER);
+void HashTable_ctor(HashTable* table, size_t expected_size, ERROR_MARKER, size_t bucket_count = BUCKET_COUNT);
 
 /**
  * @brief Destroy the table
@@ -73,6 +126,15 @@ void HashTable_dtor(HashTable* table);
  */
 ht_status_t HashTable_status(const HashTable* table);
 
+/**
+ * @brief Put Bloom filter in front of the table to reject absent elements without scanning buckets
+ * 
+ * @param table pointer to the empty table
+ * @param key_count expected number of keys
+ * @param err_code pointer to the errno-functioning variable
+ */
+void HashTable_enable_filter(HashTable* table, size_t key_count, ERROR_MARKER);
+
 /**
  * @brief Insert an element 
  * 
@@ -84,13 +146,37 @@ ht_status_t HashTable_status(const HashTable* table);
 void HashTable_insert(HashTable* table, hash_t hash, HT_ELEM_T value, ht_compar_fn_t comparator, ERROR_MARKER);
 
 /**
- * @brief Get the list of elements matching specified hash from the table
+ * @brief Insert an element without validating the table
+ * 
+ * @param table pointer to the valid table
+ * @param hash hash of the new element
+ * @param value value of the element
+ * @param err_code pointer to the errno-functioning variable (only set if the bucket could not grow)
+ */
+void HashTable_insert_unchecked(HashTable* table, hash_t hash, HT_ELEM_T value, ht_compar_fn_t comparator, ERROR_MARKER);
+
+/**
+ * @brief Insert elements known to be distinct and absent from the table (for example, generated keys without duplicates)
+ * 
+ * Elements are not checked for duplicates. They are grouped by bucket, so that every overflow list
+ * is reserved once and filled with a single bulk push instead of growing element by element.
+ * 
+ * @param table pointer to the table
+ * @param hashes hashes of the elements
+ * @param values elements
+ * @param count number of elements
+ * @param err_code pointer to the errno-functioning variable
+ */
+void HashTable_insert_distinct(HashTable* table, const hash_t* hashes, const HT_ELEM_T* values, size_t count, ERROR_MARKER);
+
+/**
+ * @brief Get the bucket of elements matching specified hash from the table
  * 
  * @param table pointer to the tables
  * @param hash hash to search for
- * @return pointer to the list where all elements match specified hash
+ * @return pointer to the bucket where all elements match specified hash
  */
-List* HashTable_find(const HashTable* table, hash_t hash);
+HashBucket* HashTable_find(const HashTable* table, hash_t hash);
 
 /**
  * @brief Find element in hash table by its hash and value
@@ -103,41 +189,143 @@ List* HashTable_find(const HashTable* table, hash_t hash);
  */
 HT_ELEM_T* HashTable_find_value(const HashTable* table, hash_t hash, HT_ELEM_T value, ht_compar_fn_t* comparator);
 
+/**
+ * @brief Find element in hash table by its hash and value without validating the table
+ * 
+ * @param table valid hash table to search in
+ * @param hash hash of the element
+ * @param value exact value of the element
+ * @param comparator comparator function between elements (should return 0 on equality)
+ * @return pointer to the element cell in table (NULL if the element was not found)
+ */
+HT_ELEM_T* HashTable_find_value_unchecked(const HashTable* table, hash_t hash, HT_ELEM_T value, ht_compar_fn_t* comparator);
+
+/**
+ * @brief Remove element from the table (the Bloom filter, if present, keeps reporting it as possibly present)
+ * 
+ * @param table pointer to the table
+ * @param hash hash of the element
+ * @param value exact value of the element
+ * @param comparator comparator function between elements (should return 0 on equality)
+ * @param err_code pointer to the errno-functioning variable
+ */
+void HashTable_remove(HashTable* table, hash_t hash, HT_ELEM_T value, ht_compar_fn_t* comparator, ERROR_MARKER);
+
+/**
+ * @brief Remove element from the table without validating the table
+ * 
+ * @param table pointer to the valid table
+ * @param hash hash of the element
+ * @param value exact value of the element
+ * @param comparator comparator function between elements (should return 0 on equality)
+ */
+void HashTable_remove_unchecked(HashTable* table, hash_t hash, HT_ELEM_T value, ht_compar_fn_t* comparator);
+
+/**
+ * @brief Get the number of buckets in the table
+ * 
+ * @param table pointer to the table
+ * @return number of buckets
+ */
+size_t HashTable_bucket_count(const HashTable* table);
+
+/**
+ * @brief Get the number of elements stored in the bucket
+ * 
+ * @param table pointer to the table
+ * @param bucket_id index of the bucket
+ * @return number of elements in the bucket
+ */
+size_t HashTable_bucket_size(const HashTable* table, size_t bucket_id);
+
+/**
+ * @brief Collect memory and chain length statistics of the table
+ * 
+ * @param table pointer to the table
+ * @param stats variable to store statistics to
+ */
+void HashTable_stats(const HashTable* table, TableStats* stats);
+
 
 //* IMPLEMENTATIONS ==============================
 
-void HashTable_ctor(HashTable* table, err_anchor_t err_code) {
-    _LOG_FAIL_CHECK_(table, "error", ERROR_REPORTS, return, err_code, EINVAL);
+/**
+ * @brief Get pointer to the element of the bucket by its index
+ * 
+ * @param bucket pointer to the bucket
+ * @param index index of the element (should be less than bucket size)
+ * @return pointer to the element
+ */
+static inline HT_ELEM_T* _HashBucket_at(HashBucket* bucket, size_t index) {
+    if (index < HT_INLINE_COUNT) return &bucket->inline_values[index];
+    //* Overflow list is only pushed to and popped from the back, so it stays linear.
+    return &bucket->overflow->buffer[index - HT_INLINE_COUNT + 1].content;
+}
 
-    table->contents = (List*) calloc(BUCKET_COUNT, sizeof(*table->contents));
+/**
+ * @brief Get index of the bucket the hash belongs to.
+ * 
+ * @param table pointer to the table
+ * @param hash hash of the element
+ * @return index of the bucket
+ */
+static inline size_t _HashTable_bucket_id(const HashTable* table, hash_t hash) {
+    //* Division by the compile-time bucket count is replaced by multiplication, other counts pay for the division.
+    if (table->bucket_count == BUCKET_COUNT) return hash % BUCKET_COUNT;
+    return hash % table->bucket_count;
+}
 
-    if (!table->contents) {
-        *err_code = ENOMEM;
-        return;
-    }
+void HashTable_ctor(HashTable* table, size_t expected_size, err_anchor_t err_code, size_t bucket_count) {
+    TRACE_SPAN("HashTable_ctor");
 
-    table->size = 0;
+    _LOG_FAIL_CHECK_(table && bucket_count, "error", ERROR_REPORTS, return, err_code, EINVAL);
 
-    for (size_t id = 0; id < BUCKET_COUNT; ++id) {
+    *table = {};
+    table->bucket_count = bucket_count;
+
+    #ifdef TABLE_ARENA
+    Arena_ctor(&table->arena, TABLE_ARENA_PAGES, err_code);
+    table->contents = (HashBucket*) Arena_alloc(&table->arena, bucket_count * sizeof(*table->contents), HT_BUCKET_ALIGNMENT);
+    int alloc_status = 0;
+    #else
+    int alloc_status = posix_memalign((void**)&table->contents, HT_BUCKET_ALIGNMENT, bucket_count * sizeof(*table->contents));
+    #endif
+
+    _LOG_FAIL_CHECK_(alloc_status == 0 && table->contents, "error", ERROR_REPORTS, {
+        table->contents = NULL;
+        return;
+    }, err_code, ENOMEM);
+
+    for (size_t id = 0; id < bucket_count; ++id) {
         table->contents[id] = {};
-        log_printf(STATUS_REPORTS, "status", "Initialising bucket with id %lu.\n", id);
-        List_ctor(&table->contents[id], DFLT_HT_CELL_SIZE, err_code);
-        if (List_status(&table->contents[id]) != 0) {
-            for (size_t rem_id = 0; rem_id < id; ++rem_id) List_dtor(table->contents + rem_id);
-            *table = {};
-            return;
-        }
     }
+
+    //* Average overflow, the list sentinel, the last free cell of the list and one spare cell for the unlucky buckets.
+    size_t average_load = expected_size / bucket_count;
+    size_t hinted_capacity = average_load > HT_INLINE_COUNT ? average_load - HT_INLINE_COUNT + 4 : 0;
+    if (hinted_capacity > table->bucket_capacity) table->bucket_capacity = hinted_capacity;
+
+    log_printf(STATUS_REPORTS, "status", "Buckets hold %lu elements inline, overflow lists will be created with %lu cells.\n",
+        HT_INLINE_COUNT, table->bucket_capacity);
 }
 
 void HashTable_dtor(HashTable* table) {
     _LOG_FAIL_CHECK_(HashTable_status(table) == 0, "error", ERROR_REPORTS, return, NULL, EINVAL);
 
-    for (size_t id = 0; id < BUCKET_COUNT; id++) {
-        List_dtor(&table->contents[id], NULL);
+    #ifdef TABLE_ARENA
+    Arena_log_stats(&table->arena, STATUS_REPORTS);
+    Arena_dtor(&table->arena);
+    #else
+    for (size_t id = 0; id < table->bucket_count; id++) {
+        if (!table->contents[id].overflow) continue;
+        List_dtor(table->contents[id].overflow, NULL);
+        free(table->contents[id].overflow);
     }
 
     free(table->contents);
+    #endif
+
+    if (table->filter.blocks) BloomFilter_dtor(&table->filter);
 }
 
 ht_status_t HashTable_status(const HashTable* table) {
@@ -146,55 +334,241 @@ ht_status_t HashTable_status(const HashTable* table) {
 
     #ifdef _DEBUG
     ht_status_t status = 0;
-    for (size_t id = 0; id < BUCKET_COUNT; ++id) {
-        if (List_status(&table->contents[id])) status |= HT_BROKEN_CELL;
+    for (size_t id = 0; id < table->bucket_count; ++id) {
+        if (table->contents[id].overflow && List_status(table->contents[id].overflow)) status |= HT_BROKEN_CELL;
     }
     #endif
 
     return 0;
 }
 
+void HashTable_enable_filter(HashTable* table, size_t key_count, err_anchor_t err_code) {
+    _LOG_FAIL_CHECK_(HashTable_status(table) == 0, "error", ERROR_REPORTS, return, err_code, EINVAL);
+    _LOG_FAIL_CHECK_(table->size == 0, "error", ERROR_REPORTS, return, err_code, EINVAL);
+    _LOG_FAIL_CHECK_(!table->filter.blocks, "error", ERROR_REPORTS, return, err_code, EINVAL);
+
+    BloomFilter_ctor(&table->filter, key_count, err_code);
+}
+
 void HashTable_insert(HashTable* table, hash_t hash, HT_ELEM_T value, ht_compar_fn_t comparator, err_anchor_t err_code) {
-    _LOG_FAIL_CHECK_(HashTable_status(table) == 0, "error", ERROR_REPORTS, return, NULL, EINVAL);
+    _API_CHECK_(HashTable_status(table) == 0, return, err_code, EINVAL);
 
-    if (HashTable_find_value(table, hash, value, comparator)) return;
+    HashTable_insert_unchecked(table, hash, value, comparator, err_code);
+}
 
-    List* list = &table->contents[hash % BUCKET_COUNT];
+/**
+ * @brief Create the overflow list of the bucket on its first spill
+ * 
+ * @param table pointer to the table
+ * @param bucket_id index of the bucket
+ * @param err_code pointer to the errno-functioning variable
+ * @return false if the list could not be created
+ */
+static bool _HashTable_create_overflow(HashTable* table, size_t bucket_id, err_anchor_t err_code) {
+    TRACE_INSTANT("bucket_spill", bucket_id);
+
+    HashBucket* bucket = &table->contents[bucket_id];
+
+    #ifdef TABLE_ARENA
+    bucket->overflow = (List*) Arena_alloc(&table->arena, sizeof(*bucket->overflow), alignof(List));
+    Arena* arena = &table->arena;
+    #else
+    bucket->overflow = (List*) calloc(1, sizeof(*bucket->overflow));
+    Arena* arena = NULL;
+    #endif
+    _LOG_FAIL_CHECK_(bucket->overflow, "error", ERROR_REPORTS, return false, err_code, ENOMEM);
+
+    *bucket->overflow = {};
+    List_ctor(bucket->overflow, table->bucket_capacity, err_code, arena);
+    _LOG_FAIL_CHECK_(List_status(bucket->overflow) == 0, "error", ERROR_REPORTS, {
+        #ifndef TABLE_ARENA
+        free(bucket->overflow);
+        #endif
+        bucket->overflow = NULL;
+        return false;
+    }, err_code, ENOMEM);
+
+    return true;
+}
 
-    List_push(list, value, err_code);
+void HashTable_insert_unchecked(HashTable* table, hash_t hash, HT_ELEM_T value, ht_compar_fn_t comparator, err_anchor_t err_code) {
+    if (HashTable_find_value_unchecked(table, hash, value, comparator)) return;
+
+    HashBucket* bucket = &table->contents[_HashTable_bucket_id(table, hash)];
+
+    if (bucket->size < HT_INLINE_COUNT) {
+        bucket->inline_values[bucket->size] = value;
+    } else {
+        if (!bucket->overflow && !_HashTable_create_overflow(table, _HashTable_bucket_id(table, hash), err_code)) return;
+
+        //* Full overflow list is relocated to a twice larger buffer by the push.
+        if (bucket->overflow->size + 2 >= bucket->overflow->capacity) TRACE_INSTANT("bucket_growth", _HashTable_bucket_id(table, hash));
+
+        if (!List_push_unchecked(bucket->overflow, value, err_code)) return;
+    }
+
+    ++bucket->size;
+
+    if (table->filter.blocks) BloomFilter_insert(&table->filter, hash);
 
     ++table->size;
 }
 
-List* HashTable_find(const HashTable* table, hash_t hash) {
-    _LOG_FAIL_CHECK_(HashTable_status(table) == 0, "error", ERROR_REPORTS, return NULL, NULL, EINVAL);
-    return &table->contents[hash % BUCKET_COUNT];
+void HashTable_insert_distinct(HashTable* table, const hash_t* hashes, const HT_ELEM_T* values, size_t count, err_anchor_t err_code) {
+    _API_CHECK_(HashTable_status(table) == 0, return, err_code, EINVAL);
+    _LOG_FAIL_CHECK_((hashes && values) || count == 0, "error", ERROR_REPORTS, return, err_code, EINVAL);
+
+    if (count == 0) return;
+
+    TRACE_SPAN("HashTable_insert_distinct");
+
+    //* Elements are grouped by bucket with a counting sort, bucket_ends[id] ends up as the end of the bucket group.
+    size_t* bucket_ends = (size_t*) calloc(table->bucket_count + 1, sizeof(*bucket_ends));
+    HT_ELEM_T* grouped = NULL;
+    if (posix_memalign((void**)&grouped, alignof(HT_ELEM_T), count * sizeof(*grouped)) != 0) grouped = NULL;
+
+    _LOG_FAIL_CHECK_(bucket_ends && grouped, "error", ERROR_REPORTS, {
+        free(bucket_ends);
+        free(grouped);
+        return;
+    }, err_code, ENOMEM);
+
+    for (size_t elem_id = 0; elem_id < count; ++elem_id) ++bucket_ends[_HashTable_bucket_id(table, hashes[elem_id]) + 1];
+    for (size_t bucket_id = 1; bucket_id < table->bucket_count; ++bucket_id) bucket_ends[bucket_id] += bucket_ends[bucket_id - 1];
+    for (size_t elem_id = 0; elem_id < count; ++elem_id) grouped[bucket_ends[_HashTable_bucket_id(table, hashes[elem_id])]++] = values[elem_id];
+
+    bool success = true;
+    size_t group_start = 0;
+
+    for (size_t bucket_id = 0; bucket_id < table->bucket_count && success; group_start = bucket_ends[bucket_id++]) {
+        HashBucket* bucket = &table->contents[bucket_id];
+        size_t group_end = bucket_ends[bucket_id];
+
+        while (group_start < group_end && bucket->size < HT_INLINE_COUNT) {
+            bucket->inline_values[bucket->size++] = grouped[group_start++];
+            ++table->size;
+        }
+
+        if (group_start == group_end) continue;
+
+        size_t spill_count = group_end - group_start;
+
+        success = (bucket->overflow || _HashTable_create_overflow(table, bucket_id, err_code)) &&
+                  List_reserve(bucket->overflow, bucket->overflow->size + spill_count, err_code) == 0 &&
+                  List_push_bulk(bucket->overflow, grouped + group_start, spill_count, err_code) != 0;
+
+        if (success) {
+            bucket->size += spill_count;
+            table->size += spill_count;
+        }
+    }
+
+    free(bucket_ends);
+    free(grouped);
+
+    //* Elements of the buckets after a failed one are not inserted, the filter only gets false positives from them.
+    if (table->filter.blocks) {
+        for (size_t elem_id = 0; elem_id < count; ++elem_id) BloomFilter_insert(&table->filter, hashes[elem_id]);
+    }
+
+    _LOG_FAIL_CHECK_(success, "error", ERROR_REPORTS, return, err_code, ENOMEM);
+}
+
+HashBucket* HashTable_find(const HashTable* table, hash_t hash) {
+    _API_CHECK_(HashTable_status(table) == 0, return NULL, NULL, EINVAL);
+    return &table->contents[_HashTable_bucket_id(table, hash)];
 }
 
 HT_ELEM_T* HashTable_find_value(const HashTable* table, hash_t hash, HT_ELEM_T value, ht_compar_fn_t* comparator) {
-    _LOG_FAIL_CHECK_(HashTable_status(table) == 0, "error", ERROR_REPORTS, return NULL, NULL, EINVAL);
+    _API_CHECK_(HashTable_status(table) == 0, return NULL, NULL, EINVAL);
+
+    return HashTable_find_value_unchecked(table, hash, value, comparator);
+}
+
+HT_ELEM_T* HashTable_find_value_unchecked(const HashTable* table, hash_t hash, HT_ELEM_T value, ht_compar_fn_t* comparator) {
+    if (table->filter.blocks && !BloomFilter_check(&table->filter, hash)) return NULL;
 
-    List* bucket = &table->contents[hash % BUCKET_COUNT];
-    _ListCell* iterator = &bucket->buffer[0];
+    HashBucket* bucket = &table->contents[_HashTable_bucket_id(table, hash)];
 
-    #if OPTIMIZATION_LEVEL == 0
-    for (size_t elem_id = 0; elem_id < bucket->size; ++elem_id, ++iterator) {
-        if (iterator->content != HT_ELEM_POISON && comparator(iterator->content, value) == 0) return &iterator->content;
+    size_t inline_size = bucket->size < HT_INLINE_COUNT ? bucket->size : HT_INLINE_COUNT;
+    for (size_t elem_id = 0; elem_id < inline_size; ++elem_id) {
+        if (ht_elem_equal(bucket->inline_values[elem_id], value, comparator)) return &bucket->inline_values[elem_id];
     }
-    #endif
 
-    #if OPTIMIZATION_LEVEL >= 1
-    __m256i search_word = value;
+    if (bucket->size <= HT_INLINE_COUNT) return NULL;
 
-    for (size_t elem_id = 0; elem_id < bucket->size; ++elem_id, ++iterator) {
-        __m256i word = iterator->content;
-        if (_mm256_testc_si256(word, search_word)) {
-            return &iterator->content;
-        }
+    _ListCell* iterator = &bucket->overflow->buffer[1];
+
+    for (size_t elem_id = HT_INLINE_COUNT; elem_id < bucket->size; ++elem_id, ++iterator) {
+        if (ht_elem_equal(iterator->content, value, comparator)) return &iterator->content;
     }
-    #endif
 
     return NULL;
 }
 
-#endif
\ No newline at end of file
+void HashTable_remove(HashTable* table, hash_t hash, HT_ELEM_T value, ht_compar_fn_t* comparator, err_anchor_t err_code) {
+    _API_CHECK_(HashTable_status(table) == 0, return, err_code, EINVAL);
+
+    HashTable_remove_unchecked(table, hash, value, comparator);
+}
+
+void HashTable_remove_unchecked(HashTable* table, hash_t hash, HT_ELEM_T value, ht_compar_fn_t* comparator) {
+    HT_ELEM_T* element = HashTable_find_value_unchecked(table, hash, value, comparator);
+    if (!element) return;
+
+    HashBucket* bucket = &table->contents[_HashTable_bucket_id(table, hash)];
+
+    //* Last element takes place of the removed one, so that inline slots are filled first and the overflow stays linear.
+    *element = *_HashBucket_at(bucket, bucket->size - 1);
+
+    if (bucket->size > HT_INLINE_COUNT) {
+        List_remove_unchecked(bucket->overflow, List_find_position_unchecked(bucket->overflow, -1));
+    }
+
+    --bucket->size;
+    --table->size;
+}
+
+size_t HashTable_bucket_count(const HashTable* table) {
+    return table->bucket_count;
+}
+
+size_t HashTable_bucket_size(const HashTable* table, size_t bucket_id) {
+    return table->contents[bucket_id].size;
+}
+
+void HashTable_stats(const HashTable* table, TableStats* stats) {
+    _LOG_FAIL_CHECK_(HashTable_status(table) == 0 && stats, "error", ERROR_REPORTS, return, NULL, EINVAL);
+
+    *stats = {};
+
+    stats->key_count = table->size;
+    stats->bucket_count = table->bucket_count;
+    #ifdef TABLE_ARENA
+    //* Memory of the buckets and the overflow lists is the memory the arena took from the system.
+    stats->bytes_allocated = sizeof(*table) + table->arena.stats.bytes_reserved + BloomFilter_memory(&table->filter);
+    #else
+    stats->bytes_allocated = sizeof(*table) + table->bucket_count * sizeof(*table->contents) + BloomFilter_memory(&table->filter);
+    #endif
+    stats->bytes_used = table->size * sizeof(HT_ELEM_T);
+
+    for (size_t id = 0; id < table->bucket_count; ++id) {
+        const HashBucket* bucket = &table->contents[id];
+
+        TableStats_add_chain(stats, bucket->size);
+
+        //* Every element of the bucket is found after comparing with all elements before it, misses compare with all of them.
+        stats->hit_probe_total += bucket->size * (bucket->size + 1) / 2;
+        stats->miss_probe_total += bucket->size;
+
+        if (bucket->size > HT_INLINE_COUNT) ++stats->overflowing_buckets;
+
+        #ifndef TABLE_ARENA
+        if (bucket->overflow) stats->bytes_allocated += List_memory(bucket->overflow);
+        #endif
+    }
+
+    TableStats_finish(stats);
+}
+
+#endif
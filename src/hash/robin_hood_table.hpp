@@ -0,0 +1,355 @@
+/**
+ * @file robin_hood_table.hpp
+ * @author Kudryashov Ilya (kudriashov.it@phystech.edu)
+ * @brief Open addressing hash table with Robin Hood linear probing.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef ROBIN_HOOD_TABLE_HPP
+#define ROBIN_HOOD_TABLE_HPP
+
+#include "hash_table.hpp"
+
+#ifndef RH_MAX_LOAD_FACTOR
+    static const double RH_MAX_LOAD_FACTOR = 0.95;
+#endif
+
+enum RH_STATUS {
+    RH_NULL         = 1 << 0,
+    RH_NO_CONTENT   = 1 << 1,
+    RH_BIG_SIZE     = 1 << 2,
+};
+
+/**
+ * @brief Table cell with the element stored inline.
+ *
+ * @param value stored element
+ * @param hash full hash of the element
+ * @param distance distance from the home cell of the element + 1 (0 if the cell is empty)
+ */
+struct RobinHoodSlot {
+    HT_ELEM_T value;
+    hash_t hash;
+    size_t distance;
+};
+
+struct RobinHoodTable {
+    size_t size = 0;
+    size_t capacity = 0;
+    RobinHoodSlot* slots = NULL;
+    BloomFilter filter = {};
+};
+
+
+//* DECLARATIONS
+
+/**
+ * @brief Construct Robin Hood table with the specified number of cells or with enough cells for the expected number of keys
+ *
+ * @param table pointer to the table
+ * @param expected_size expected number of keys used to size the table (0 if unknown)
+ * @param err_code pointer to the errno-functioning variable
+ * @param bucket_count number of cells if the expected number of keys is unknown
+ */
+void RobinHoodTable_ctor(RobinHoodTable* table, size_t expected_size, ERROR_MARKER, size_t bucket_count = BUCKET_COUNT);
+
+/**
+ * @brief Destroy the table
+ *
+ * @param table pointer to the table to destroy
+ */
+void RobinHoodTable_dtor(RobinHoodTable* table);
+
+/**
+ * @brief Get status of the table
+ *
+ * @param table pointer to the table
+ * @return ht_status_t
+ */
+ht_status_t RobinHoodTable_status(const RobinHoodTable* table);
+
+/**
+ * @brief Put Bloom filter in front of the table
+ *
+ * @param table pointer to the empty table
+ * @param key_count expected number of keys
+ * @param err_code pointer to the errno-functioning variable
+ */
+void RobinHoodTable_enable_filter(RobinHoodTable* table, size_t key_count, ERROR_MARKER);
+
+/**
+ * @brief Insert an element, taking cells from elements that are closer to their home cell
+ *
+ * @param table pointer to the table
+ * @param hash hash of the new element
+ * @param value value of the element
+ * @param comparator comparator function between elements (should return 0 on equality)
+ * @param err_code pointer to the errno-functioning variable
+ */
+void RobinHoodTable_insert(RobinHoodTable* table, hash_t hash, HT_ELEM_T value, ht_compar_fn_t* comparator, ERROR_MARKER);
+
+/**
+ * @brief Find element in the table by its hash and value
+ *
+ * @param table table to search in
+ * @param hash hash of the element
+ * @param value exact value of the element
+ * @param comparator comparator function between elements (should return 0 on equality)
+ * @return pointer to the element cell in table (NULL if the element was not found)
+ */
+HT_ELEM_T* RobinHoodTable_find_value(const RobinHoodTable* table, hash_t hash, HT_ELEM_T value, ht_compar_fn_t* comparator);
+
+/**
+ * @brief Remove element from the table, shifting the following cluster back (no tombstones are left)
+ *
+ * @param table pointer to the table
+ * @param hash hash of the element
+ * @param value exact value of the element
+ * @param comparator comparator function between elements (should return 0 on equality)
+ * @param err_code pointer to the errno-functioning variable
+ */
+void RobinHoodTable_remove(RobinHoodTable* table, hash_t hash, HT_ELEM_T value, ht_compar_fn_t* comparator, ERROR_MARKER);
+
+/**
+ * @brief Get the number of cells in the table
+ *
+ * @param table pointer to the table
+ * @return number of cells
+ */
+size_t RobinHoodTable_bucket_count(const RobinHoodTable* table);
+
+/**
+ * @brief Get probe length of the element stored in the cell
+ *
+ * @param table pointer to the table
+ * @param bucket_id index of the cell
+ * @return number of cells probed to find the element (0 if the cell is empty)
+ */
+size_t RobinHoodTable_bucket_size(const RobinHoodTable* table, size_t bucket_id);
+
+/**
+ * @brief Collect memory and probe length statistics of the table
+ *
+ * Cost of a miss is estimated without early termination, so it is the upper bound of the real one.
+ *
+ * @param table pointer to the table
+ * @param stats variable to store statistics to
+ */
+void RobinHoodTable_stats(const RobinHoodTable* table, TableStats* stats);
+
+
+//* IMPLEMENTATIONS ==============================
+
+//* Home cells are taken the same way as HashTable buckets, so that probe lengths of both tables are comparable.
+static inline size_t _RobinHoodTable_home(const RobinHoodTable* table, hash_t hash) {
+    return (size_t) (hash % table->capacity);
+}
+
+static inline size_t _RobinHoodTable_next(const RobinHoodTable* table, size_t cell_id) {
+    return cell_id + 1 == table->capacity ? 0 : cell_id + 1;
+}
+
+/**
+ * @brief Allocate empty cells of the table
+ *
+ * @param table pointer to the table
+ * @param capacity number of cells
+ * @return 0 if allocation was successful, 1 otherwise
+ */
+static int _RobinHoodTable_alloc(RobinHoodTable* table, size_t capacity) {
+    table->slots = NULL;
+
+    if (posix_memalign((void**)&table->slots, 64, capacity * sizeof(*table->slots)) != 0) {
+        table->slots = NULL;
+        return 1;
+    }
+
+    for (size_t id = 0; id < capacity; ++id) table->slots[id].distance = 0;
+
+    table->capacity = capacity;
+    table->size = 0;
+
+    return 0;
+}
+
+/**
+ * @brief Place the element into the table without checking for duplicates or load factor
+ *
+ * @param table pointer to the table
+ * @param hash hash of the element
+ * @param value element to place
+ */
+static void _RobinHoodTable_place(RobinHoodTable* table, hash_t hash, HT_ELEM_T value) {
+    RobinHoodSlot entry = {};
+    entry.value = value;
+    entry.hash = hash;
+    entry.distance = 1;
+
+    for (size_t cell_id = _RobinHoodTable_home(table, hash);; cell_id = _RobinHoodTable_next(table, cell_id), ++entry.distance) {
+        RobinHoodSlot* slot = table->slots + cell_id;
+
+        if (slot->distance == 0) {
+            *slot = entry;
+            break;
+        }
+
+        if (slot->distance < entry.distance) {
+            RobinHoodSlot rich = *slot;
+            *slot = entry;
+            entry = rich;
+        }
+    }
+
+    ++table->size;
+}
+
+/**
+ * @brief Rebuild the table with the specified number of cells
+ *
+ * @param table pointer to the table
+ * @param capacity new number of cells
+ * @return 0 if relocation was successful, 1 otherwise
+ */
+static int _RobinHoodTable_resize(RobinHoodTable* table, size_t capacity) {
+    TRACE_SPAN_ID("RobinHoodTable_resize", capacity);
+
+    RobinHoodTable new_table = {};
+    if (_RobinHoodTable_alloc(&new_table, capacity)) return 1;
+
+    for (size_t cell_id = 0; cell_id < table->capacity; ++cell_id) {
+        RobinHoodSlot* slot = table->slots + cell_id;
+        if (slot->distance) _RobinHoodTable_place(&new_table, slot->hash, slot->value);
+    }
+
+    log_printf(STATUS_REPORTS, "status", "Robin Hood table was resized to %lu cells.\n", capacity);
+
+    free(table->slots);
+
+    new_table.filter = table->filter;
+    *table = new_table;
+
+    return 0;
+}
+
+void RobinHoodTable_ctor(RobinHoodTable* table, size_t expected_size, err_anchor_t err_code, size_t bucket_count) {
+    TRACE_SPAN("RobinHoodTable_ctor");
+
+    _LOG_FAIL_CHECK_(table && bucket_count, "error", ERROR_REPORTS, return, err_code, EINVAL);
+
+    *table = {};
+
+    size_t capacity = bucket_count;
+    if (expected_size) capacity = (size_t) ((double) expected_size / RH_MAX_LOAD_FACTOR) + 2;
+
+    _LOG_FAIL_CHECK_(_RobinHoodTable_alloc(table, capacity) == 0, "error", ERROR_REPORTS, {
+        *table = {};
+        return;
+    }, err_code, ENOMEM);
+}
+
+void RobinHoodTable_dtor(RobinHoodTable* table) {
+    _LOG_FAIL_CHECK_(RobinHoodTable_status(table) == 0, "error", ERROR_REPORTS, return, NULL, EINVAL);
+
+    free(table->slots);
+
+    if (table->filter.blocks) BloomFilter_dtor(&table->filter);
+
+    *table = {};
+}
+
+ht_status_t RobinHoodTable_status(const RobinHoodTable* table) {
+    if (!table) return RH_NULL;
+    if (!table->slots) return RH_NO_CONTENT;
+    if (table->size >= table->capacity) return RH_BIG_SIZE;
+
+    return 0;
+}
+
+void RobinHoodTable_enable_filter(RobinHoodTable* table, size_t key_count, err_anchor_t err_code) {
+    _LOG_FAIL_CHECK_(RobinHoodTable_status(table) == 0, "error", ERROR_REPORTS, return, err_code, EINVAL);
+    _LOG_FAIL_CHECK_(table->size == 0, "error", ERROR_REPORTS, return, err_code, EINVAL);
+    _LOG_FAIL_CHECK_(!table->filter.blocks, "error", ERROR_REPORTS, return, err_code, EINVAL);
+
+    BloomFilter_ctor(&table->filter, key_count, err_code);
+}
+
+void RobinHoodTable_insert(RobinHoodTable* table, hash_t hash, HT_ELEM_T value, ht_compar_fn_t* comparator, err_anchor_t err_code) {
+    _API_CHECK_(RobinHoodTable_status(table) == 0, return, err_code, EINVAL);
+
+    if (RobinHoodTable_find_value(table, hash, value, comparator)) return;
+
+    if ((double) (table->size + 1) > RH_MAX_LOAD_FACTOR * (double) table->capacity) {
+        _LOG_FAIL_CHECK_(_RobinHoodTable_resize(table, table->capacity * 2) == 0, "error", ERROR_REPORTS, return, err_code, ENOMEM);
+    }
+
+    if (table->filter.blocks) BloomFilter_insert(&table->filter, hash);
+
+    _RobinHoodTable_place(table, hash, value);
+}
+
+HT_ELEM_T* RobinHoodTable_find_value(const RobinHoodTable* table, hash_t hash, HT_ELEM_T value, ht_compar_fn_t* comparator) {
+    _API_CHECK_(RobinHoodTable_status(table) == 0, return NULL, NULL, EINVAL);
+
+    if (table->filter.blocks && !BloomFilter_check(&table->filter, hash)) return NULL;
+
+    size_t distance = 1;
+    for (size_t cell_id = _RobinHoodTable_home(table, hash);; cell_id = _RobinHoodTable_next(table, cell_id), ++distance) {
+        RobinHoodSlot* slot = table->slots + cell_id;
+
+        //* The element would have taken this cell if it was present in the table.
+        if (slot->distance < distance) return NULL;
+
+        if (slot->hash == hash && ht_elem_equal(slot->value, value, comparator)) return &slot->value;
+    }
+}
+
+void RobinHoodTable_remove(RobinHoodTable* table, hash_t hash, HT_ELEM_T value, ht_compar_fn_t* comparator, err_anchor_t err_code) {
+    _API_CHECK_(RobinHoodTable_status(table) == 0, return, err_code, EINVAL);
+
+    HT_ELEM_T* element = RobinHoodTable_find_value(table, hash, value, comparator);
+    if (!element) return;
+
+    size_t cell_id = (size_t) ((RobinHoodSlot*) element - table->slots);
+
+    for (size_t next_id = _RobinHoodTable_next(table, cell_id);
+         table->slots[next_id].distance > 1;
+         cell_id = next_id, next_id = _RobinHoodTable_next(table, next_id)) {
+
+        table->slots[cell_id] = table->slots[next_id];
+        --table->slots[cell_id].distance;
+    }
+
+    table->slots[cell_id].distance = 0;
+    --table->size;
+}
+
+size_t RobinHoodTable_bucket_count(const RobinHoodTable* table) {
+    return table->capacity;
+}
+
+size_t RobinHoodTable_bucket_size(const RobinHoodTable* table, size_t bucket_id) {
+    return table->slots[bucket_id].distance;
+}
+
+static size_t _RobinHoodTable_cell_probe(const void* table, size_t cell_id) {
+    return RobinHoodTable_bucket_size((const RobinHoodTable*) table, cell_id);
+}
+
+void RobinHoodTable_stats(const RobinHoodTable* table, TableStats* stats) {
+    _LOG_FAIL_CHECK_(RobinHoodTable_status(table) == 0 && stats, "error", ERROR_REPORTS, return, NULL, EINVAL);
+
+    *stats = {};
+
+    TableStats_add_open_addressing(stats, table, table->capacity, _RobinHoodTable_cell_probe);
+
+    stats->bytes_allocated = sizeof(*table) + table->capacity * sizeof(*table->slots) + BloomFilter_memory(&table->filter);
+    stats->bytes_used = table->size * sizeof(HT_ELEM_T);
+
+    TableStats_finish(stats);
+}
+
+#endif
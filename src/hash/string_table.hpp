@@ -0,0 +1,532 @@
+/**
+ * @file string_table.hpp
+ * @author Kudryashov Ilya (kudriashov.it@phystech.edu)
+ * @brief Open addressing hash table for keys of arbitrary length stored in an append-only arena.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef STRING_TABLE_HPP
+#define STRING_TABLE_HPP
+
+#include <stdint.h>
+#include <string.h>
+
+#include "hash_table.hpp"
+
+//* Key length and the first STRING_PREFIX_LENGTH bytes of the key form a 16-byte header compared in one go.
+static const size_t STRING_PREFIX_LENGTH = 12;
+
+static const double STRING_TABLE_MAX_LOAD = 0.75;
+static const size_t DFLT_STRING_TABLE_CAPACITY = 1024;
+
+static const size_t DFLT_STRING_ARENA_CAPACITY = 1 << 16;
+//* Arena size reserved per expected key when the table is given a key count hint.
+static const size_t STRING_ARENA_KEY_ESTIMATE = 16;
+
+enum ST_STATUS {
+    ST_NULL         = 1 << 0,
+    ST_NO_CONTENT   = 1 << 1,
+    ST_BIG_SIZE     = 1 << 2,
+    ST_NO_ARENA     = 1 << 3,
+};
+
+/**
+ * @brief Append-only storage of key bytes. Keys are referenced by their offsets, which stay valid after the arena grows.
+ *
+ * @param data arena bytes
+ * @param size number of bytes taken
+ * @param capacity number of bytes allocated
+ */
+struct StringArena {
+    char* data = NULL;
+    size_t size = 0;
+    size_t capacity = 0;
+};
+
+/**
+ * @brief Table cell referencing the key in the arena.
+ *
+ * @param length length of the key (0 if the cell is empty)
+ * @param prefix first bytes of the key padded with zeros
+ * @param hash full hash of the key
+ * @param offset offset of the key in the arena
+ */
+struct StringSlot {
+    uint32_t length;
+    char prefix[STRING_PREFIX_LENGTH];
+    hash_t hash;
+    size_t offset;
+} __attribute__((__aligned__(32)));
+
+struct StringTable {
+    size_t size = 0;
+    size_t capacity = 0;
+    StringSlot* slots = NULL;
+    StringArena arena = {};
+    BloomFilter filter = {};
+};
+
+
+//* DECLARATIONS
+
+/**
+ * @brief Construct the arena
+ *
+ * @param arena pointer to the arena
+ * @param capacity initial number of bytes
+ * @param err_code pointer to the errno-functioning variable
+ */
+void StringArena_ctor(StringArena* arena, size_t capacity, ERROR_MARKER);
+
+/**
+ * @brief Destroy the arena
+ *
+ * @param arena pointer to the arena
+ */
+void StringArena_dtor(StringArena* arena);
+
+/**
+ * @brief Copy the key to the end of the arena
+ *
+ * @param arena pointer to the arena
+ * @param key first byte of the key
+ * @param length length of the key
+ * @param err_code pointer to the errno-functioning variable
+ * @return offset of the copied key (SIZE_MAX if failed)
+ */
+size_t StringArena_append(StringArena* arena, const char* key, size_t length, ERROR_MARKER);
+
+/**
+ * @brief Construct string table
+ *
+ * @param table pointer to the table
+ * @param expected_size expected number of keys used to size the table and the arena (0 if unknown)
+ * @param err_code pointer to the errno-functioning variable
+ */
+void StringTable_ctor(StringTable* table, size_t expected_size, ERROR_MARKER);
+
+/**
+ * @brief Destroy the table
+ *
+ * @param table pointer to the table to destroy
+ */
+void StringTable_dtor(StringTable* table);
+
+/**
+ * @brief Get status of the table
+ *
+ * @param table pointer to the table
+ * @return ht_status_t
+ */
+ht_status_t StringTable_status(const StringTable* table);
+
+/**
+ * @brief Put Bloom filter in front of the table
+ *
+ * @param table pointer to the empty table
+ * @param key_count expected number of keys
+ * @param err_code pointer to the errno-functioning variable
+ */
+void StringTable_enable_filter(StringTable* table, size_t key_count, ERROR_MARKER);
+
+/**
+ * @brief Copy the key to the arena and insert it into the table
+ *
+ * @param table pointer to the table
+ * @param hash hash of the key
+ * @param key first byte of the key
+ * @param length length of the key (should not be 0)
+ * @param err_code pointer to the errno-functioning variable
+ */
+void StringTable_insert(StringTable* table, hash_t hash, const char* key, size_t length, ERROR_MARKER);
+
+/**
+ * @brief Find the key in the table
+ *
+ * @param table table to search in
+ * @param hash hash of the key
+ * @param key first byte of the key
+ * @param length length of the key
+ * @return pointer to the copy of the key stored in the arena (NULL if the key was not found)
+ */
+const char* StringTable_find_value(const StringTable* table, hash_t hash, const char* key, size_t length);
+
+/**
+ * @brief Remove the key from the table (its bytes are kept in the arena)
+ *
+ * @param table pointer to the table
+ * @param hash hash of the key
+ * @param key first byte of the key
+ * @param length length of the key
+ * @param err_code pointer to the errno-functioning variable
+ */
+void StringTable_remove(StringTable* table, hash_t hash, const char* key, size_t length, ERROR_MARKER);
+
+/**
+ * @brief Get the number of cells in the table
+ *
+ * @param table pointer to the table
+ * @return number of cells
+ */
+size_t StringTable_bucket_count(const StringTable* table);
+
+/**
+ * @brief Get probe length of the key stored in the cell
+ *
+ * @param table pointer to the table
+ * @param bucket_id index of the cell
+ * @return number of cells probed to find the key (0 if the cell is empty)
+ */
+size_t StringTable_bucket_size(const StringTable* table, size_t bucket_id);
+
+/**
+ * @brief Collect memory and probe length statistics of the table
+ *
+ * @param table pointer to the table
+ * @param stats variable to store statistics to
+ */
+void StringTable_stats(const StringTable* table, TableStats* stats);
+
+
+//* IMPLEMENTATIONS ==============================
+
+void StringArena_ctor(StringArena* arena, size_t capacity, err_anchor_t err_code) {
+    _LOG_FAIL_CHECK_(arena, "error", ERROR_REPORTS, return, err_code, EINVAL);
+
+    *arena = {};
+
+    arena->data = (char*) calloc(capacity, sizeof(*arena->data));
+    _LOG_FAIL_CHECK_(arena->data, "error", ERROR_REPORTS, return, err_code, ENOMEM);
+
+    arena->capacity = capacity;
+}
+
+void StringArena_dtor(StringArena* arena) {
+    _LOG_FAIL_CHECK_(arena, "error", ERROR_REPORTS, return, NULL, EINVAL);
+
+    free(arena->data);
+    *arena = {};
+}
+
+size_t StringArena_append(StringArena* arena, const char* key, size_t length, err_anchor_t err_code) {
+    _LOG_FAIL_CHECK_(arena && arena->data, "error", ERROR_REPORTS, return SIZE_MAX, err_code, EINVAL);
+
+    if (arena->size + length > arena->capacity) {
+        size_t new_capacity = arena->capacity * 2;
+        while (arena->size + length > new_capacity) new_capacity *= 2;
+
+        char* new_data = (char*) realloc(arena->data, new_capacity);
+        _LOG_FAIL_CHECK_(new_data, "error", ERROR_REPORTS, return SIZE_MAX, err_code, ENOMEM);
+
+        arena->data = new_data;
+        arena->capacity = new_capacity;
+    }
+
+    memcpy(arena->data + arena->size, key, length);
+
+    size_t offset = arena->size;
+    arena->size += length;
+
+    return offset;
+}
+
+/**
+ * @brief Check if two byte sequences of the same length are equal
+ *
+ * @param alpha
+ * @param beta
+ * @param length number of bytes to compare
+ * @return true if sequences are equal
+ */
+static inline bool _string_key_equal(const char* alpha, const char* beta, size_t length) {
+    #if OPTIMIZATION_LEVEL >= 1
+    for (; length >= sizeof(__m256i); alpha += sizeof(__m256i), beta += sizeof(__m256i), length -= sizeof(__m256i)) {
+        __m256i difference = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*) alpha),
+                                              _mm256_loadu_si256((const __m256i*) beta));
+        if (!_mm256_testz_si256(difference, difference)) return false;
+    }
+    #endif
+
+    return memcmp(alpha, beta, length) == 0;
+}
+
+/**
+ * @brief Build the cell the key would be stored in (without the arena offset)
+ *
+ * @param hash hash of the key
+ * @param key first byte of the key
+ * @param length length of the key
+ * @return StringSlot
+ */
+static inline StringSlot _StringSlot_make(hash_t hash, const char* key, size_t length) {
+    StringSlot slot = {};
+    slot.length = (uint32_t) length;
+    memcpy(slot.prefix, key, length < STRING_PREFIX_LENGTH ? length : STRING_PREFIX_LENGTH);
+    slot.hash = hash;
+
+    return slot;
+}
+
+/**
+ * @brief Check if the cell holds the key described by the probe
+ *
+ * @param arena arena of the table
+ * @param slot cell to check
+ * @param probe cell built from the searched key
+ * @param key first byte of the searched key
+ * @return true if the cell holds the key
+ */
+static inline bool _StringSlot_match(const StringArena* arena, const StringSlot* slot, const StringSlot* probe, const char* key) {
+    if (slot->hash != probe->hash) return false;
+
+    #if OPTIMIZATION_LEVEL >= 1
+    __m128i difference = _mm_xor_si128(_mm_load_si128((const __m128i*) slot), _mm_load_si128((const __m128i*) probe));
+    if (!_mm_testz_si128(difference, difference)) return false;
+    #else
+    if (slot->length != probe->length || memcmp(slot->prefix, probe->prefix, STRING_PREFIX_LENGTH) != 0) return false;
+    #endif
+
+    if (slot->length <= STRING_PREFIX_LENGTH) return true;
+
+    return _string_key_equal(arena->data + slot->offset + STRING_PREFIX_LENGTH, key + STRING_PREFIX_LENGTH,
+                             slot->length - STRING_PREFIX_LENGTH);
+}
+
+//* Home cells are taken the same way as HashTable buckets, so that probe lengths of all engines are comparable.
+static inline size_t _StringTable_home(const StringTable* table, hash_t hash) {
+    return (size_t) (hash % table->capacity);
+}
+
+static inline size_t _StringTable_next(const StringTable* table, size_t cell_id) {
+    return cell_id + 1 == table->capacity ? 0 : cell_id + 1;
+}
+
+/**
+ * @brief Allocate empty cells of the table
+ *
+ * @param table pointer to the table
+ * @param capacity number of cells
+ * @return 0 if allocation was successful, 1 otherwise
+ */
+static int _StringTable_alloc(StringTable* table, size_t capacity) {
+    table->slots = NULL;
+
+    if (posix_memalign((void**)&table->slots, 64, capacity * sizeof(*table->slots)) != 0) {
+        table->slots = NULL;
+        return 1;
+    }
+
+    for (size_t id = 0; id < capacity; ++id) table->slots[id] = {};
+
+    table->capacity = capacity;
+    table->size = 0;
+
+    return 0;
+}
+
+/**
+ * @brief Put the cell into the first empty cell of its probe sequence
+ *
+ * @param table pointer to the table
+ * @param slot cell to place
+ */
+static void _StringTable_place(StringTable* table, const StringSlot* slot) {
+    size_t cell_id = _StringTable_home(table, slot->hash);
+    while (table->slots[cell_id].length) cell_id = _StringTable_next(table, cell_id);
+
+    table->slots[cell_id] = *slot;
+    ++table->size;
+}
+
+/**
+ * @brief Rebuild the table with the specified number of cells (the arena is not touched)
+ *
+ * @param table pointer to the table
+ * @param capacity new number of cells
+ * @return 0 if relocation was successful, 1 otherwise
+ */
+static int _StringTable_resize(StringTable* table, size_t capacity) {
+    TRACE_SPAN_ID("StringTable_resize", capacity);
+
+    StringTable new_table = {};
+    if (_StringTable_alloc(&new_table, capacity)) return 1;
+
+    for (size_t cell_id = 0; cell_id < table->capacity; ++cell_id) {
+        if (table->slots[cell_id].length) _StringTable_place(&new_table, table->slots + cell_id);
+    }
+
+    log_printf(STATUS_REPORTS, "status", "String table was resized to %lu cells.\n", capacity);
+
+    free(table->slots);
+
+    new_table.arena = table->arena;
+    new_table.filter = table->filter;
+    *table = new_table;
+
+    return 0;
+}
+
+void StringTable_ctor(StringTable* table, size_t expected_size, err_anchor_t err_code) {
+    TRACE_SPAN("StringTable_ctor");
+
+    _LOG_FAIL_CHECK_(table, "error", ERROR_REPORTS, return, err_code, EINVAL);
+
+    *table = {};
+
+    size_t capacity = DFLT_STRING_TABLE_CAPACITY;
+    size_t arena_capacity = DFLT_STRING_ARENA_CAPACITY;
+    if (expected_size) {
+        capacity = (size_t) ((double) expected_size / STRING_TABLE_MAX_LOAD) + 2;
+        arena_capacity = expected_size * STRING_ARENA_KEY_ESTIMATE;
+    }
+
+    _LOG_FAIL_CHECK_(_StringTable_alloc(table, capacity) == 0, "error", ERROR_REPORTS, {
+        *table = {};
+        return;
+    }, err_code, ENOMEM);
+
+    StringArena_ctor(&table->arena, arena_capacity, err_code);
+    _LOG_FAIL_CHECK_(table->arena.data, "error", ERROR_REPORTS, {
+        free(table->slots);
+        *table = {};
+        return;
+    }, err_code, ENOMEM);
+}
+
+void StringTable_dtor(StringTable* table) {
+    _LOG_FAIL_CHECK_(StringTable_status(table) == 0, "error", ERROR_REPORTS, return, NULL, EINVAL);
+
+    free(table->slots);
+    StringArena_dtor(&table->arena);
+
+    if (table->filter.blocks) BloomFilter_dtor(&table->filter);
+
+    *table = {};
+}
+
+ht_status_t StringTable_status(const StringTable* table) {
+    if (!table) return ST_NULL;
+    if (!table->slots) return ST_NO_CONTENT;
+    if (!table->arena.data) return ST_NO_ARENA;
+    if (table->size >= table->capacity) return ST_BIG_SIZE;
+
+    return 0;
+}
+
+void StringTable_enable_filter(StringTable* table, size_t key_count, err_anchor_t err_code) {
+    _LOG_FAIL_CHECK_(StringTable_status(table) == 0, "error", ERROR_REPORTS, return, err_code, EINVAL);
+    _LOG_FAIL_CHECK_(table->size == 0, "error", ERROR_REPORTS, return, err_code, EINVAL);
+    _LOG_FAIL_CHECK_(!table->filter.blocks, "error", ERROR_REPORTS, return, err_code, EINVAL);
+
+    BloomFilter_ctor(&table->filter, key_count, err_code);
+}
+
+void StringTable_insert(StringTable* table, hash_t hash, const char* key, size_t length, err_anchor_t err_code) {
+    _API_CHECK_(StringTable_status(table) == 0, return, err_code, EINVAL);
+    _LOG_FAIL_CHECK_(key && length > 0 && length <= UINT32_MAX, "error", ERROR_REPORTS, return, err_code, EINVAL);
+
+    if (StringTable_find_value(table, hash, key, length)) return;
+
+    if ((double) (table->size + 1) > STRING_TABLE_MAX_LOAD * (double) table->capacity) {
+        _LOG_FAIL_CHECK_(_StringTable_resize(table, table->capacity * 2) == 0, "error", ERROR_REPORTS, return, err_code, ENOMEM);
+    }
+
+    StringSlot slot = _StringSlot_make(hash, key, length);
+
+    slot.offset = StringArena_append(&table->arena, key, length, err_code);
+    if (slot.offset == SIZE_MAX) return;
+
+    if (table->filter.blocks) BloomFilter_insert(&table->filter, hash);
+
+    _StringTable_place(table, &slot);
+}
+
+const char* StringTable_find_value(const StringTable* table, hash_t hash, const char* key, size_t length) {
+    _API_CHECK_(StringTable_status(table) == 0, return NULL, NULL, EINVAL);
+
+    if (table->filter.blocks && !BloomFilter_check(&table->filter, hash)) return NULL;
+
+    StringSlot probe = _StringSlot_make(hash, key, length);
+
+    for (size_t cell_id = _StringTable_home(table, hash); table->slots[cell_id].length; cell_id = _StringTable_next(table, cell_id)) {
+        const StringSlot* slot = table->slots + cell_id;
+        if (_StringSlot_match(&table->arena, slot, &probe, key)) return table->arena.data + slot->offset;
+    }
+
+    return NULL;
+}
+
+void StringTable_remove(StringTable* table, hash_t hash, const char* key, size_t length, err_anchor_t err_code) {
+    _API_CHECK_(StringTable_status(table) == 0, return, err_code, EINVAL);
+
+    StringSlot probe = _StringSlot_make(hash, key, length);
+
+    size_t cell_id = _StringTable_home(table, hash);
+    for (; table->slots[cell_id].length; cell_id = _StringTable_next(table, cell_id)) {
+        if (_StringSlot_match(&table->arena, table->slots + cell_id, &probe, key)) break;
+    }
+
+    if (!table->slots[cell_id].length) return;
+
+    //* Move back every following element of the cluster that can take the freed cell, so that no tombstones are left.
+    size_t free_id = cell_id;
+    for (size_t next_id = _StringTable_next(table, free_id); table->slots[next_id].length; next_id = _StringTable_next(table, next_id)) {
+        size_t home = _StringTable_home(table, table->slots[next_id].hash);
+
+        bool movable = free_id <= next_id ? (home <= free_id || home > next_id)
+                                          : (home <= free_id && home > next_id);
+        if (!movable) continue;
+
+        table->slots[free_id] = table->slots[next_id];
+        free_id = next_id;
+    }
+
+    table->slots[free_id] = {};
+    --table->size;
+}
+
+size_t StringTable_bucket_count(const StringTable* table) {
+    return table->capacity;
+}
+
+size_t StringTable_bucket_size(const StringTable* table, size_t bucket_id) {
+    if (!table->slots[bucket_id].length) return 0;
+
+    size_t home = _StringTable_home(table, table->slots[bucket_id].hash);
+    return (bucket_id + table->capacity - home) % table->capacity + 1;
+}
+
+static size_t _StringTable_cell_probe(const void* table, size_t cell_id) {
+    return StringTable_bucket_size((const StringTable*) table, cell_id);
+}
+
+/**
+ * @brief Add cells and keys of the table to the statistics
+ *
+ * @param table pointer to the table
+ * @param stats statistics to add to
+ */
+static void _StringTable_add_stats(const StringTable* table, TableStats* stats) {
+    TableStats_add_open_addressing(stats, table, table->capacity, _StringTable_cell_probe);
+
+    stats->bytes_allocated += sizeof(*table) + table->capacity * sizeof(*table->slots) + table->arena.capacity
+                            + BloomFilter_memory(&table->filter);
+
+    for (size_t cell_id = 0; cell_id < table->capacity; ++cell_id) stats->bytes_used += table->slots[cell_id].length;
+}
+
+void StringTable_stats(const StringTable* table, TableStats* stats) {
+    _LOG_FAIL_CHECK_(StringTable_status(table) == 0 && stats, "error", ERROR_REPORTS, return, NULL, EINVAL);
+
+    *stats = {};
+
+    _StringTable_add_stats(table, stats);
+
+    TableStats_finish(stats);
+}
+
+#endif
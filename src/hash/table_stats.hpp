@@ -0,0 +1,184 @@
+/**
+ * @file table_stats.hpp
+ * @author Kudryashov Ilya (kudriashov.it@phystech.edu)
+ * @brief Memory and probe-length statistics shared by all hash table engines.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef TABLE_STATS_HPP
+#define TABLE_STATS_HPP
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "lib/util/dbg/debug.h"
+
+//* Last bin of the histogram counts all chains of this length and longer.
+static const size_t TABLE_STATS_HISTOGRAM_SIZE = 16;
+
+enum TABLE_STATS_FORMAT {
+    STATS_CSV,
+    STATS_JSON,
+};
+
+/**
+ * @brief Snapshot of the table state.
+ *
+ * @param key_count number of stored keys
+ * @param bucket_count number of buckets (cells for open addressing tables)
+ * @param bytes_allocated memory taken by the table
+ * @param bytes_used memory taken by the keys themselves
+ * @param load_factor number of keys per bucket
+ * @param chain_histogram number of buckets with the specified number of elements
+ *      (number of elements with the specified probe length for open addressing tables)
+ * @param max_chain length of the longest chain
+ * @param hit_probe_total number of elements (cells) inspected to find every stored key once
+ * @param miss_probe_total number of elements (cells) inspected by one missing lookup starting in every bucket
+ * @param probes_per_hit expected number of elements (cells) inspected by a successful lookup
+ * @param probes_per_miss expected number of elements (cells) inspected by a lookup of an absent key
+ * @param overflowing_buckets number of buckets over their inline capacity (displaced elements for open addressing tables)
+ */
+struct TableStats {
+    size_t key_count = 0;
+    size_t bucket_count = 0;
+    size_t bytes_allocated = 0;
+    size_t bytes_used = 0;
+    double load_factor = 0.0;
+    size_t chain_histogram[TABLE_STATS_HISTOGRAM_SIZE] = {};
+    size_t max_chain = 0;
+    size_t hit_probe_total = 0;
+    size_t miss_probe_total = 0;
+    double probes_per_hit = 0.0;
+    double probes_per_miss = 0.0;
+    size_t overflowing_buckets = 0;
+};
+
+typedef size_t table_cell_probe_fn_t(const void* table, size_t cell_id);
+
+
+//* DECLARATIONS
+
+/**
+ * @brief Put chain of the specified length into the histogram
+ *
+ * @param stats pointer to the statistics
+ * @param length length of the chain
+ */
+void TableStats_add_chain(TableStats* stats, size_t length);
+
+/**
+ * @brief Collect statistics of the linear probing cell array
+ *
+ * @param stats pointer to the statistics to add to
+ * @param table pointer to the table passed to cell_probe
+ * @param cell_count number of cells in the table
+ * @param cell_probe function returning probe length of the element in the cell (0 if the cell is empty)
+ */
+void TableStats_add_open_addressing(TableStats* stats, const void* table, size_t cell_count, table_cell_probe_fn_t* cell_probe);
+
+/**
+ * @brief Calculate averages from the collected totals
+ *
+ * @param stats pointer to the statistics
+ */
+void TableStats_finish(TableStats* stats);
+
+/**
+ * @brief Print statistics
+ *
+ * @param stats pointer to the statistics
+ * @param file file to print to
+ * @param format output format
+ */
+void TableStats_print(const TableStats* stats, FILE* file, TABLE_STATS_FORMAT format);
+
+
+//* IMPLEMENTATIONS ==============================
+
+void TableStats_add_chain(TableStats* stats, size_t length) {
+    ++stats->chain_histogram[length < TABLE_STATS_HISTOGRAM_SIZE ? length : TABLE_STATS_HISTOGRAM_SIZE - 1];
+    if (length > stats->max_chain) stats->max_chain = length;
+}
+
+void TableStats_add_open_addressing(TableStats* stats, const void* table, size_t cell_count, table_cell_probe_fn_t* cell_probe) {
+    _LOG_FAIL_CHECK_(stats && table && cell_probe, "error", ERROR_REPORTS, return, NULL, EINVAL);
+
+    size_t empty_id = cell_count;
+
+    for (size_t cell_id = 0; cell_id < cell_count; ++cell_id) {
+        size_t probe_length = cell_probe(table, cell_id);
+
+        if (probe_length == 0) {
+            empty_id = cell_id;
+            continue;
+        }
+
+        TableStats_add_chain(stats, probe_length);
+
+        ++stats->key_count;
+        stats->hit_probe_total += probe_length;
+        if (probe_length > 1) ++stats->overflowing_buckets;
+    }
+
+    stats->bucket_count += cell_count;
+
+    _LOG_FAIL_CHECK_(empty_id < cell_count, "error", ERROR_REPORTS, return, NULL, EINVAL);
+
+    //* Lookup of an absent key walks to the end of the cluster it started in, so walk clusters backwards from an empty cell.
+    size_t run_length = 0;
+    for (size_t step = 0; step < cell_count; ++step) {
+        size_t cell_id = (empty_id + cell_count - step) % cell_count;
+
+        run_length = cell_probe(table, cell_id) ? run_length + 1 : 0;
+        stats->miss_probe_total += run_length + 1;
+    }
+}
+
+void TableStats_finish(TableStats* stats) {
+    _LOG_FAIL_CHECK_(stats, "error", ERROR_REPORTS, return, NULL, EINVAL);
+
+    stats->load_factor = stats->bucket_count ? (double) stats->key_count / (double) stats->bucket_count : 0.0;
+    stats->probes_per_hit = stats->key_count ? (double) stats->hit_probe_total / (double) stats->key_count : 0.0;
+    stats->probes_per_miss = stats->bucket_count ? (double) stats->miss_probe_total / (double) stats->bucket_count : 0.0;
+}
+
+void TableStats_print(const TableStats* stats, FILE* file, TABLE_STATS_FORMAT format) {
+    _LOG_FAIL_CHECK_(stats && file, "error", ERROR_REPORTS, return, NULL, EINVAL);
+
+    double bytes_per_key = stats->key_count ? (double) stats->bytes_allocated / (double) stats->key_count : 0.0;
+
+    switch (format) {
+        case STATS_CSV: {
+            fprintf(file, "keys,buckets,bytes_allocated,bytes_used,bytes_per_key,load_factor,"
+                          "probes_per_hit,probes_per_miss,max_chain,overflowing_buckets");
+            for (size_t bin = 0; bin < TABLE_STATS_HISTOGRAM_SIZE; ++bin) fprintf(file, ",chain_%lu", bin);
+            fputc('\n', file);
+
+            fprintf(file, "%lu,%lu,%lu,%lu,%lg,%lg,%lg,%lg,%lu,%lu",
+                stats->key_count, stats->bucket_count, stats->bytes_allocated, stats->bytes_used, bytes_per_key,
+                stats->load_factor, stats->probes_per_hit, stats->probes_per_miss, stats->max_chain, stats->overflowing_buckets);
+            for (size_t bin = 0; bin < TABLE_STATS_HISTOGRAM_SIZE; ++bin) fprintf(file, ",%lu", stats->chain_histogram[bin]);
+            fputc('\n', file);
+            break;
+        }
+        case STATS_JSON: {
+            fprintf(file, "{\"keys\": %lu, \"buckets\": %lu, \"bytes_allocated\": %lu, \"bytes_used\": %lu, "
+                          "\"bytes_per_key\": %lg, \"load_factor\": %lg, \"probes_per_hit\": %lg, \"probes_per_miss\": %lg, "
+                          "\"max_chain\": %lu, \"overflowing_buckets\": %lu, \"chain_histogram\": [",
+                stats->key_count, stats->bucket_count, stats->bytes_allocated, stats->bytes_used, bytes_per_key,
+                stats->load_factor, stats->probes_per_hit, stats->probes_per_miss, stats->max_chain, stats->overflowing_buckets);
+            for (size_t bin = 0; bin < TABLE_STATS_HISTOGRAM_SIZE; ++bin) {
+                fprintf(file, "%s%lu", bin ? ", " : "", stats->chain_histogram[bin]);
+            }
+            fprintf(file, "]}\n");
+            break;
+        }
+        default: break;
+    }
+}
+
+#endif
@@ -0,0 +1,530 @@
+/**
+ * @file tiered_table.hpp
+ * @author Kudryashov Ilya (kudriashov.it@phystech.edu)
+ * @brief Hash table routing short keys into size-class tiers that store them as integers or SIMD words.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef TIERED_TABLE_HPP
+#define TIERED_TABLE_HPP
+
+#include <stdint.h>
+#include <string.h>
+
+#include "string_table.hpp"
+
+//* Keys of up to 8, 16 and 32 bytes are stored as uint64_t, __m128i and __m256i, longer keys go to StringTable.
+static const size_t KEY_TIER_COUNT = 3;
+static const size_t KEY_TIER_SIZES[KEY_TIER_COUNT] = { sizeof(uint64_t), sizeof(__m128i), sizeof(__m256i) };
+static const size_t MAX_TIER_KEY_SIZE = sizeof(__m256i);
+
+static const double KEY_TIER_MAX_LOAD = 0.75;
+static const size_t DFLT_KEY_TIER_CAPACITY = 256;
+
+static const size_t KEY_TIER_NOT_FOUND = SIZE_MAX;
+
+enum TT_STATUS {
+    TT_NULL         = 1 << 0,
+    TT_NO_CONTENT   = 1 << 1,
+    TT_BIG_SIZE     = 1 << 2,
+    TT_BROKEN_LONG  = 1 << 3,
+};
+
+/**
+ * @brief Open addressing table of zero-padded keys of the same size class. Empty cells are all zeros.
+ *
+ * @param key_size size of the stored keys
+ * @param size number of stored keys
+ * @param capacity number of cells
+ * @param keys cells with the keys, only they are read during lookups
+ * @param hashes hashes of the keys, used to find home cells on resize and remove
+ */
+struct KeyTier {
+    size_t key_size = 0;
+    size_t size = 0;
+    size_t capacity = 0;
+    char* keys = NULL;
+    hash_t* hashes = NULL;
+};
+
+struct TieredTable {
+    size_t size = 0;
+    KeyTier tiers[KEY_TIER_COUNT] = {};
+    StringTable long_keys = {};
+    BloomFilter filter = {};
+};
+
+
+//* DECLARATIONS
+
+/**
+ * @brief Construct tiered table
+ *
+ * @param table pointer to the table
+ * @param expected_size expected number of keys, split evenly between the tiers (0 if unknown)
+ * @param err_code pointer to the errno-functioning variable
+ */
+void TieredTable_ctor(TieredTable* table, size_t expected_size, ERROR_MARKER);
+
+/**
+ * @brief Destroy the table
+ *
+ * @param table pointer to the table to destroy
+ */
+void TieredTable_dtor(TieredTable* table);
+
+/**
+ * @brief Get status of the table
+ *
+ * @param table pointer to the table
+ * @return ht_status_t
+ */
+ht_status_t TieredTable_status(const TieredTable* table);
+
+/**
+ * @brief Put Bloom filter in front of all tiers of the table
+ *
+ * @param table pointer to the empty table
+ * @param key_count expected number of keys
+ * @param err_code pointer to the errno-functioning variable
+ */
+void TieredTable_enable_filter(TieredTable* table, size_t key_count, ERROR_MARKER);
+
+/**
+ * @brief Insert the key into the tier matching its length
+ *
+ * @param table pointer to the table
+ * @param hash hash of the key
+ * @param key first byte of the key
+ * @param length length of the key (should not be 0)
+ * @param err_code pointer to the errno-functioning variable
+ */
+void TieredTable_insert(TieredTable* table, hash_t hash, const char* key, size_t length, ERROR_MARKER);
+
+/**
+ * @brief Find the key in the tier matching its length
+ *
+ * @param table table to search in
+ * @param hash hash of the key
+ * @param key first byte of the key
+ * @param length length of the key
+ * @return pointer to the stored copy of the key, zero-padded to the tier key size (NULL if the key was not found)
+ */
+const char* TieredTable_find_value(const TieredTable* table, hash_t hash, const char* key, size_t length);
+
+/**
+ * @brief Remove the key from the table
+ *
+ * @param table pointer to the table
+ * @param hash hash of the key
+ * @param key first byte of the key
+ * @param length length of the key
+ * @param err_code pointer to the errno-functioning variable
+ */
+void TieredTable_remove(TieredTable* table, hash_t hash, const char* key, size_t length, ERROR_MARKER);
+
+/**
+ * @brief Get the total number of cells in all tiers
+ *
+ * @param table pointer to the table
+ * @return number of cells
+ */
+size_t TieredTable_bucket_count(const TieredTable* table);
+
+/**
+ * @brief Get probe length of the key stored in the cell (cells are numbered tier by tier, long keys go last)
+ *
+ * @param table pointer to the table
+ * @param bucket_id index of the cell
+ * @return number of cells probed to find the key (0 if the cell is empty)
+ */
+size_t TieredTable_bucket_size(const TieredTable* table, size_t bucket_id);
+
+/**
+ * @brief Collect memory and probe length statistics of all tiers of the table
+ *
+ * @param table pointer to the table
+ * @param stats variable to store statistics to
+ */
+void TieredTable_stats(const TieredTable* table, TableStats* stats);
+
+
+//* IMPLEMENTATIONS ==============================
+
+/**
+ * @brief Get the tier the key belongs to
+ *
+ * @param key first byte of the key
+ * @param length length of the key
+ * @return index of the tier (KEY_TIER_COUNT if the key should be stored in StringTable)
+ */
+static inline size_t _TieredTable_tier_id(const char* key, size_t length) {
+    //* Zero padding can not tell "a" from "a\0", so keys ending with zero keep their exact length in StringTable.
+    if (length == 0 || length > MAX_TIER_KEY_SIZE || key[length - 1] == '\0') return KEY_TIER_COUNT;
+
+    size_t tier_id = 0;
+    while (KEY_TIER_SIZES[tier_id] < length) ++tier_id;
+
+    return tier_id;
+}
+
+//* Home cells are taken the same way as HashTable buckets, so that probe lengths of all engines are comparable.
+static inline size_t _KeyTier_home(const KeyTier* tier, hash_t hash) {
+    return (size_t) (hash % tier->capacity);
+}
+
+static inline size_t _KeyTier_next(const KeyTier* tier, size_t cell_id) {
+    return cell_id + 1 == tier->capacity ? 0 : cell_id + 1;
+}
+
+static inline bool _KeyTier_is_empty(const KeyTier* tier, size_t cell_id) {
+    const char* cell = tier->keys + cell_id * tier->key_size;
+
+    switch (tier->key_size) {
+        case sizeof(uint64_t):  return *(const uint64_t*) cell == 0;
+        case sizeof(__m128i):   return _mm_testz_si128(*(const __m128i*) cell, *(const __m128i*) cell);
+        case sizeof(__m256i):   return _mm256_testz_si256(*(const __m256i*) cell, *(const __m256i*) cell);
+        default:                return true;
+    }
+}
+
+static size_t _KeyTier_cell_probe(const void* tier_ptr, size_t cell_id) {
+    const KeyTier* tier = (const KeyTier*) tier_ptr;
+    if (_KeyTier_is_empty(tier, cell_id)) return 0;
+
+    size_t home = _KeyTier_home(tier, tier->hashes[cell_id]);
+    return (cell_id + tier->capacity - home) % tier->capacity + 1;
+}
+
+/**
+ * @brief Allocate empty cells of the tier
+ *
+ * @param tier pointer to the tier
+ * @param key_size size of the stored keys
+ * @param capacity number of cells
+ * @return 0 if allocation was successful, 1 otherwise
+ */
+static int _KeyTier_alloc(KeyTier* tier, size_t key_size, size_t capacity) {
+    *tier = {};
+
+    if (posix_memalign((void**)&tier->keys, 64, capacity * key_size) != 0) {
+        tier->keys = NULL;
+        return 1;
+    }
+
+    tier->hashes = (hash_t*) calloc(capacity, sizeof(*tier->hashes));
+    if (!tier->hashes) {
+        free(tier->keys);
+        *tier = {};
+        return 1;
+    }
+
+    memset(tier->keys, 0, capacity * key_size);
+
+    tier->key_size = key_size;
+    tier->capacity = capacity;
+
+    return 0;
+}
+
+static void _KeyTier_free(KeyTier* tier) {
+    free(tier->keys);
+    free(tier->hashes);
+    *tier = {};
+}
+
+/**
+ * @brief Find the cell holding the key
+ *
+ * @param tier pointer to the tier
+ * @param hash hash of the key
+ * @param key key zero-padded to MAX_TIER_KEY_SIZE bytes
+ * @return index of the cell (KEY_TIER_NOT_FOUND if the key is absent)
+ */
+static size_t _KeyTier_find_cell(const KeyTier* tier, hash_t hash, const char* key) {
+    size_t cell_id = _KeyTier_home(tier, hash);
+
+    //* Every tier has its own probe loop, so that equality and emptiness are a single integer or vector test.
+    switch (tier->key_size) {
+        case sizeof(uint64_t): {
+            const uint64_t* cells = (const uint64_t*) tier->keys;
+            uint64_t word = 0;
+            memcpy(&word, key, sizeof(word));
+
+            for (; cells[cell_id]; cell_id = _KeyTier_next(tier, cell_id)) {
+                if (cells[cell_id] == word) return cell_id;
+            }
+            return KEY_TIER_NOT_FOUND;
+        }
+        case sizeof(__m128i): {
+            const __m128i* cells = (const __m128i*) tier->keys;
+            __m128i word = _mm_loadu_si128((const __m128i*) key);
+
+            for (; !_mm_testz_si128(cells[cell_id], cells[cell_id]); cell_id = _KeyTier_next(tier, cell_id)) {
+                __m128i difference = _mm_xor_si128(cells[cell_id], word);
+                if (_mm_testz_si128(difference, difference)) return cell_id;
+            }
+            return KEY_TIER_NOT_FOUND;
+        }
+        case sizeof(__m256i): {
+            const __m256i* cells = (const __m256i*) tier->keys;
+            __m256i word = _mm256_loadu_si256((const __m256i*) key);
+
+            for (; !_mm256_testz_si256(cells[cell_id], cells[cell_id]); cell_id = _KeyTier_next(tier, cell_id)) {
+                __m256i difference = _mm256_xor_si256(cells[cell_id], word);
+                if (_mm256_testz_si256(difference, difference)) return cell_id;
+            }
+            return KEY_TIER_NOT_FOUND;
+        }
+        default: return KEY_TIER_NOT_FOUND;
+    }
+}
+
+/**
+ * @brief Put the key into the first empty cell of its probe sequence
+ *
+ * @param tier pointer to the tier
+ * @param hash hash of the key
+ * @param key key zero-padded to the tier key size
+ */
+static void _KeyTier_place(KeyTier* tier, hash_t hash, const char* key) {
+    size_t cell_id = _KeyTier_home(tier, hash);
+    while (!_KeyTier_is_empty(tier, cell_id)) cell_id = _KeyTier_next(tier, cell_id);
+
+    memcpy(tier->keys + cell_id * tier->key_size, key, tier->key_size);
+    tier->hashes[cell_id] = hash;
+    ++tier->size;
+}
+
+/**
+ * @brief Rebuild the tier with the specified number of cells
+ *
+ * @param tier pointer to the tier
+ * @param capacity new number of cells
+ * @return 0 if relocation was successful, 1 otherwise
+ */
+static int _KeyTier_resize(KeyTier* tier, size_t capacity) {
+    TRACE_SPAN_ID("KeyTier_resize", capacity);
+
+    KeyTier new_tier = {};
+    if (_KeyTier_alloc(&new_tier, tier->key_size, capacity)) return 1;
+
+    for (size_t cell_id = 0; cell_id < tier->capacity; ++cell_id) {
+        if (!_KeyTier_is_empty(tier, cell_id))
+            _KeyTier_place(&new_tier, tier->hashes[cell_id], tier->keys + cell_id * tier->key_size);
+    }
+
+    log_printf(STATUS_REPORTS, "status", "Tier of %lu-byte keys was resized to %lu cells.\n", tier->key_size, capacity);
+
+    _KeyTier_free(tier);
+    *tier = new_tier;
+
+    return 0;
+}
+
+/**
+ * @brief Remove the key from the cell, shifting the following cluster back
+ *
+ * @param tier pointer to the tier
+ * @param cell_id index of the cell
+ */
+static void _KeyTier_erase(KeyTier* tier, size_t cell_id) {
+    size_t free_id = cell_id;
+    for (size_t next_id = _KeyTier_next(tier, free_id); !_KeyTier_is_empty(tier, next_id); next_id = _KeyTier_next(tier, next_id)) {
+        size_t home = _KeyTier_home(tier, tier->hashes[next_id]);
+
+        bool movable = free_id <= next_id ? (home <= free_id || home > next_id)
+                                          : (home <= free_id && home > next_id);
+        if (!movable) continue;
+
+        memcpy(tier->keys + free_id * tier->key_size, tier->keys + next_id * tier->key_size, tier->key_size);
+        tier->hashes[free_id] = tier->hashes[next_id];
+        free_id = next_id;
+    }
+
+    memset(tier->keys + free_id * tier->key_size, 0, tier->key_size);
+    tier->hashes[free_id] = 0;
+    --tier->size;
+}
+
+void TieredTable_ctor(TieredTable* table, size_t expected_size, err_anchor_t err_code) {
+    TRACE_SPAN("TieredTable_ctor");
+
+    _LOG_FAIL_CHECK_(table, "error", ERROR_REPORTS, return, err_code, EINVAL);
+
+    *table = {};
+
+    size_t tier_hint = expected_size / (KEY_TIER_COUNT + 1);
+    size_t capacity = tier_hint ? (size_t) ((double) tier_hint / KEY_TIER_MAX_LOAD) + 2 : DFLT_KEY_TIER_CAPACITY;
+
+    for (size_t tier_id = 0; tier_id < KEY_TIER_COUNT; ++tier_id) {
+        _LOG_FAIL_CHECK_(_KeyTier_alloc(&table->tiers[tier_id], KEY_TIER_SIZES[tier_id], capacity) == 0, "error", ERROR_REPORTS, {
+            for (size_t rem_id = 0; rem_id < tier_id; ++rem_id) _KeyTier_free(&table->tiers[rem_id]);
+            *table = {};
+            return;
+        }, err_code, ENOMEM);
+    }
+
+    StringTable_ctor(&table->long_keys, tier_hint, err_code);
+    _LOG_FAIL_CHECK_(StringTable_status(&table->long_keys) == 0, "error", ERROR_REPORTS, {
+        for (size_t tier_id = 0; tier_id < KEY_TIER_COUNT; ++tier_id) _KeyTier_free(&table->tiers[tier_id]);
+        *table = {};
+        return;
+    }, err_code, ENOMEM);
+}
+
+void TieredTable_dtor(TieredTable* table) {
+    _LOG_FAIL_CHECK_(TieredTable_status(table) == 0, "error", ERROR_REPORTS, return, NULL, EINVAL);
+
+    for (size_t tier_id = 0; tier_id < KEY_TIER_COUNT; ++tier_id) _KeyTier_free(&table->tiers[tier_id]);
+    StringTable_dtor(&table->long_keys);
+
+    if (table->filter.blocks) BloomFilter_dtor(&table->filter);
+
+    *table = {};
+}
+
+ht_status_t TieredTable_status(const TieredTable* table) {
+    if (!table) return TT_NULL;
+
+    for (size_t tier_id = 0; tier_id < KEY_TIER_COUNT; ++tier_id) {
+        const KeyTier* tier = &table->tiers[tier_id];
+        if (!tier->keys || !tier->hashes) return TT_NO_CONTENT;
+        if (tier->size >= tier->capacity) return TT_BIG_SIZE;
+    }
+
+    if (StringTable_status(&table->long_keys)) return TT_BROKEN_LONG;
+
+    return 0;
+}
+
+void TieredTable_enable_filter(TieredTable* table, size_t key_count, err_anchor_t err_code) {
+    _LOG_FAIL_CHECK_(TieredTable_status(table) == 0, "error", ERROR_REPORTS, return, err_code, EINVAL);
+    _LOG_FAIL_CHECK_(table->size == 0, "error", ERROR_REPORTS, return, err_code, EINVAL);
+    _LOG_FAIL_CHECK_(!table->filter.blocks, "error", ERROR_REPORTS, return, err_code, EINVAL);
+
+    BloomFilter_ctor(&table->filter, key_count, err_code);
+}
+
+void TieredTable_insert(TieredTable* table, hash_t hash, const char* key, size_t length, err_anchor_t err_code) {
+    _API_CHECK_(TieredTable_status(table) == 0, return, err_code, EINVAL);
+    _LOG_FAIL_CHECK_(key && length > 0, "error", ERROR_REPORTS, return, err_code, EINVAL);
+
+    size_t tier_id = _TieredTable_tier_id(key, length);
+
+    if (tier_id == KEY_TIER_COUNT) {
+        size_t old_size = table->long_keys.size;
+        StringTable_insert(&table->long_keys, hash, key, length, err_code);
+        if (table->long_keys.size == old_size) return;
+    } else {
+        KeyTier* tier = &table->tiers[tier_id];
+
+        char padded_key[MAX_TIER_KEY_SIZE] __attribute__((__aligned__(32))) = {};
+        memcpy(padded_key, key, length);
+
+        if (_KeyTier_find_cell(tier, hash, padded_key) != KEY_TIER_NOT_FOUND) return;
+
+        if ((double) (tier->size + 1) > KEY_TIER_MAX_LOAD * (double) tier->capacity) {
+            _LOG_FAIL_CHECK_(_KeyTier_resize(tier, tier->capacity * 2) == 0, "error", ERROR_REPORTS, return, err_code, ENOMEM);
+        }
+
+        _KeyTier_place(tier, hash, padded_key);
+    }
+
+    if (table->filter.blocks) BloomFilter_insert(&table->filter, hash);
+
+    ++table->size;
+}
+
+const char* TieredTable_find_value(const TieredTable* table, hash_t hash, const char* key, size_t length) {
+    _API_CHECK_(TieredTable_status(table) == 0, return NULL, NULL, EINVAL);
+
+    if (table->filter.blocks && !BloomFilter_check(&table->filter, hash)) return NULL;
+
+    size_t tier_id = _TieredTable_tier_id(key, length);
+
+    if (tier_id == KEY_TIER_COUNT) return StringTable_find_value(&table->long_keys, hash, key, length);
+
+    const KeyTier* tier = &table->tiers[tier_id];
+
+    char padded_key[MAX_TIER_KEY_SIZE] __attribute__((__aligned__(32))) = {};
+    memcpy(padded_key, key, length);
+
+    size_t cell_id = _KeyTier_find_cell(tier, hash, padded_key);
+    if (cell_id == KEY_TIER_NOT_FOUND) return NULL;
+
+    return tier->keys + cell_id * tier->key_size;
+}
+
+void TieredTable_remove(TieredTable* table, hash_t hash, const char* key, size_t length, err_anchor_t err_code) {
+    _API_CHECK_(TieredTable_status(table) == 0, return, err_code, EINVAL);
+
+    size_t tier_id = _TieredTable_tier_id(key, length);
+
+    if (tier_id == KEY_TIER_COUNT) {
+        size_t old_size = table->long_keys.size;
+        StringTable_remove(&table->long_keys, hash, key, length, err_code);
+        if (table->long_keys.size != old_size) --table->size;
+        return;
+    }
+
+    KeyTier* tier = &table->tiers[tier_id];
+
+    char padded_key[MAX_TIER_KEY_SIZE] __attribute__((__aligned__(32))) = {};
+    memcpy(padded_key, key, length);
+
+    size_t cell_id = _KeyTier_find_cell(tier, hash, padded_key);
+    if (cell_id == KEY_TIER_NOT_FOUND) return;
+
+    _KeyTier_erase(tier, cell_id);
+    --table->size;
+}
+
+size_t TieredTable_bucket_count(const TieredTable* table) {
+    size_t count = StringTable_bucket_count(&table->long_keys);
+    for (size_t tier_id = 0; tier_id < KEY_TIER_COUNT; ++tier_id) count += table->tiers[tier_id].capacity;
+
+    return count;
+}
+
+size_t TieredTable_bucket_size(const TieredTable* table, size_t bucket_id) {
+    for (size_t tier_id = 0; tier_id < KEY_TIER_COUNT; ++tier_id) {
+        const KeyTier* tier = &table->tiers[tier_id];
+
+        if (bucket_id >= tier->capacity) {
+            bucket_id -= tier->capacity;
+            continue;
+        }
+
+        return _KeyTier_cell_probe(tier, bucket_id);
+    }
+
+    return StringTable_bucket_size(&table->long_keys, bucket_id);
+}
+
+void TieredTable_stats(const TieredTable* table, TableStats* stats) {
+    _LOG_FAIL_CHECK_(TieredTable_status(table) == 0 && stats, "error", ERROR_REPORTS, return, NULL, EINVAL);
+
+    *stats = {};
+
+    stats->bytes_allocated = sizeof(*table) - sizeof(table->long_keys) + BloomFilter_memory(&table->filter);
+
+    for (size_t tier_id = 0; tier_id < KEY_TIER_COUNT; ++tier_id) {
+        const KeyTier* tier = &table->tiers[tier_id];
+
+        TableStats_add_open_addressing(stats, tier, tier->capacity, _KeyTier_cell_probe);
+
+        stats->bytes_allocated += tier->capacity * (tier->key_size + sizeof(*tier->hashes));
+        stats->bytes_used += tier->size * tier->key_size;
+    }
+
+    _StringTable_add_stats(&table->long_keys, stats);
+
+    TableStats_finish(stats);
+}
+
+#endif
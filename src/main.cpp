@@ -23,70 +23,132 @@
 #include "lib/util/argparser.h"
 #include "lib/alloc_tracker/alloc_tracker.h"
 #include "lib/util/util.h"
+#include "lib/util/dbg/trace.h"
 
 #include "utils/config.h"
 #include "utils/main_utils.h"
 
-#include "hash/hash_functions.h"
-#include "hash/hash_table.hpp"
-
-#include "text_parser/text_parser.h"
+#include "bmark/table_adapter.h"
+#include "bmark/runner.hpp"
+#include "bmark/compare.h"
+#include "bmark/latency.h"
+#include "bmark/perf_counters.h"
 
 #define MAIN
 
-#if OPTIMIZATION_LEVEL >= 1
-int simd_comparison_placeholder(__m256i alpha, __m256i beta) { return 0; }
-#endif
-
-int main(const int argc, const char** argv) {
-    atexit(log_end_program);
+/**
+ * @brief Parameters of the tests of the filled table.
+ * 
+ * @param benchmark parameters of the benchmark and of the table (key count hint, Bloom filter, miss ratio of the queries)
+ * @param run_benchmark true if the -W benchmark should be run
+ * @param distinct_keys true if the words are known to be distinct (generated without duplicates)
+ * @param stats_format format of the table statistics (NULL to print none)
+ * @param baseline_results results to compare the benchmark with (NULL to compare with nothing)
+ * @param candidate_results result set to add the benchmark results to
+ * @param regression_threshold largest tolerated slowdown of the candidate
+ * @param counters performance counters holding values of the load phase (PERFORMANCE_TEST only)
+ * @param load_time duration of the load phase in clock ticks (PERFORMANCE_TEST only)
+ */
+struct TableTestOptions {
+    BenchmarkConfig benchmark = {};
+    bool run_benchmark = false;
+    bool distinct_keys = false;
+    const char* stats_format = NULL;
+    const ResultSet* baseline_results = NULL;
+    ResultSet* candidate_results = NULL;
+    double regression_threshold = DFLT_REGRESSION_THRESHOLD;
+    PerfCounters* counters = NULL;
+    clock_t load_time = 0;
+};
 
+/**
+ * @brief Fill the table of the tested variant with the words and run the tests enabled at runtime and at compile time.
+ * 
+ * @param options test parameters
+ * @param word_list list of words
+ * @param sample_size number of words in the list
+ * @return exit status of the program
+ */
+template <typename Table, hash_fn_t* Hash>
+static int run_table_tests(const TableTestOptions* options, word_list_t word_list, size_t sample_size) {
     start_local_tracking();
-    unsigned int log_threshold = STATUS_REPORTS;
-    MAKE_WRAPPER(log_threshold);
 
-    ActionTag line_tags[] = {
-        #include "cmd_flags/main_flags.h"
-    };
-    const int number_of_tags = ARR_SIZE(line_tags);
-
-    parse_args(argc, argv, number_of_tags, line_tags);
-    log_init("program_log.html", log_threshold, &errno);
-    print_label();
-
-    const char* sample_file_name = get_input_file_name(argc, argv, DEFAULT_SAMPLE_NAME);
-    log_printf(STATUS_REPORTS, "status", "Opening file %s.\n", sample_file_name);
-    const char* word_list = NULL;
-    size_t sample_size = read_words(sample_file_name, &word_list);
-
-    _LOG_FAIL_CHECK_(word_list, "error", ERROR_REPORTS, return_clean(EXIT_FAILURE), NULL, ENOENT);
+    const BenchmarkConfig* config = &options->benchmark;
 
     log_printf(STATUS_REPORTS, "status", "Initializing the table.\n");
 
-    HashTable table = {};
-    HashTable_ctor(&table, &errno);
-    _LOG_FAIL_CHECK_(HashTable_status(&table) == 0, "error", ERROR_REPORTS, {
-        log_printf(ERROR_REPORTS, "error", "Table status was %u;\n", HashTable_status(&table));
+    Table table = {};
+    TABLE_FN(ctor)(&table, config->expected_keys, &errno);
+    _LOG_FAIL_CHECK_(TABLE_FN(status)(&table) == 0, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Table status was %u;\n", TABLE_FN(status)(&table));
         return_clean(EXIT_FAILURE);
     }, NULL, ENOMEM);
-    track_allocation(table, HashTable_dtor);
+    track_allocation(table, static_cast<void (*)(Table*)>(TABLE_FN(dtor)));
+
+    if (config->use_bloom) {
+        log_printf(STATUS_REPORTS, "status", "Attaching Bloom filter to the table.\n");
+        TABLE_FN(enable_filter)(&table, sample_size, &errno);
+        _LOG_FAIL_CHECK_(table.filter.blocks, "error", ERROR_REPORTS, return_clean(EXIT_FAILURE), NULL, ENOMEM);
+    }
 
     log_printf(STATUS_REPORTS, "status", "Filling table with words.\n");
 
-    for (const char* word_ptr = word_list;
-        word_ptr < word_list + sample_size * MAX_WORD_LENGTH;
-        word_ptr += MAX_WORD_LENGTH) {
+    #ifdef PERFORMANCE_TEST
+    PerfCounters load_counters = *options->counters;
+
+    PerfCounters_start(options->counters);
+    clock_t build_start = clock();
+    #endif
+
+    //* Table that refused a key would make every test below measure the wrong set of keys.
+    int insert_error = 0;
+
+    {
+        TRACE_SPAN("fill");
 
-        #if OPTIMIZATION_LEVEL < 1
-        HashTable_insert(&table, TESTED_HASH(word_ptr, word_ptr + MAX_WORD_LENGTH), word_ptr, strcmp);
-        #else
-        HashTable_insert(&table, TESTED_HASH(word_ptr, word_ptr + MAX_WORD_LENGTH),
-            _mm256_load_si256((const __m256i*) word_ptr), simd_comparison_placeholder);
-        #endif
+        if (options->distinct_keys) {
+            table_insert_distinct<Hash>(&table, word_list, sample_size, &insert_error);
+        } else {
+            for (size_t word_id = 0; word_id < sample_size && !insert_error; ++word_id) {
+                TABLE_FN(insert)(&table, WORD_HASH(Hash, WORD_AT(word_list, word_id)), WORD_KEY(WORD_AT(word_list, word_id)), &insert_error);
+            }
+        }
     }
 
+    _LOG_FAIL_CHECK_(!insert_error, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Failed to fill the table with the words.\n");
+        return_clean(EXIT_FAILURE);
+    }, NULL, insert_error);
+
+    #ifdef PERFORMANCE_TEST
+    clock_t build_time = clock() - build_start;
+    PerfCounters_stop(options->counters);
+
+    PerfCounters build_counters = *options->counters;
+    #endif
+
     log_printf(STATUS_REPORTS, "status", "The table is ready for testing.\n");
 
+    if (options->stats_format) {
+        TableStats stats = {};
+        TABLE_FN(stats)(&table, &stats);
+        TableStats_print(&stats, stdout, strcmp(options->stats_format, "json") == 0 ? STATS_JSON : STATS_CSV);
+    }
+
+    if (options->run_benchmark) {
+        SampleSummary summary = {};
+        _LOG_FAIL_CHECK_((run_benchmark<Table, Hash>)(config, &table, word_list, sample_size, stdout, &summary, &errno) == 0, "error", ERROR_REPORTS,
+            return_clean(EXIT_FAILURE), NULL, EFAULT);
+
+        if (options->baseline_results) {
+            ResultSet_add(options->candidate_results, workload_name(config->workload), &summary, &errno);
+
+            if (compare_results(options->baseline_results, options->candidate_results, options->regression_threshold, stdout)) {
+                return_clean(EXIT_FAILURE);
+            }
+        }
+    }
+
 
     #ifdef DISTRIBUTION_TEST  //* DISTRIBUTION TEST CASE ==============================
 
@@ -98,8 +160,8 @@ int main(const int argc, const char** argv) {
     log_printf(STATUS_REPORTS, "status", "Reading distribution data.\n");
     fprintf(out_table, "bucket_id,size\n");
 
-    for (unsigned bucket_id = 0; bucket_id < BUCKET_COUNT; ++bucket_id) {
-        fprintf(out_table, "%u,%lu\n", bucket_id, table.contents[bucket_id].size);
+    for (size_t bucket_id = 0; bucket_id < TABLE_FN(bucket_count)(&table); ++bucket_id) {
+        fprintf(out_table, "%lu,%lu\n", bucket_id, TABLE_FN(bucket_size)(&table, bucket_id));
     }
 
     if (out_table) fclose(out_table);
@@ -108,40 +170,489 @@ int main(const int argc, const char** argv) {
 
 
     #ifdef PERFORMANCE_TEST  //* PERFORMANCE TEST CASE ==============================
+    log_printf(STATUS_REPORTS, "status", "Building query list with miss ratio %lg.\n", config->miss_ratio);
+
+    size_t absent_count = 0;
+    word_list_t query_list = BUILD_QUERY_LIST(word_list, sample_size, config->miss_ratio, &absent_count);
+    _LOG_FAIL_CHECK_(query_list, "error", ERROR_REPORTS, return_clean(EXIT_FAILURE), NULL, ENOMEM);
+    track_allocation(query_list, free_variable);
+
     log_printf(STATUS_REPORTS, "status", "Opening benchmark output file.\n");
 
     FILE* out_timetable = fopen(OUTPUT_TIMETABLE_NAME, "w");
     _LOG_FAIL_CHECK_(out_timetable, "error", ERROR_REPORTS, return_clean(EXIT_FAILURE), NULL, ENOENT);
 
+    log_printf(STATUS_REPORTS, "status", "Writing load and build phases to %s.\n", OUTPUT_PHASES_TABLE_NAME);
+
+    FILE* out_phases = fopen(OUTPUT_PHASES_TABLE_NAME, "w");
+    _LOG_FAIL_CHECK_(out_phases, "error", ERROR_REPORTS, { fclose(out_timetable); return_clean(EXIT_FAILURE); }, NULL, ENOENT);
+
+    fprintf(out_phases, "phase,operations,time");
+    PerfCounters_print_header(out_phases);
+
+    fprintf(out_phases, "\nload,%lu,%ld", sample_size, options->load_time);
+    PerfCounters_print(&load_counters, out_phases, sample_size);
+
+    fprintf(out_phases, "\nbuild,%lu,%ld", sample_size, build_time);
+    PerfCounters_print(&build_counters, out_phases, sample_size);
+
+    fputc('\n', out_phases);
+    fclose(out_phases);
+
     log_printf(STATUS_REPORTS, "status", "Writing header to the file.\n");
 
-    fprintf(out_timetable, "test_id,time\n");
+    PerfCounters* counters = options->counters;
+
+    fprintf(out_timetable, "test_id,time");
+    PerfCounters_print_header(out_timetable);
+    fputc('\n', out_timetable);
 
     log_printf(STATUS_REPORTS, "status", "Starting tests.\n");
 
     for (unsigned test_id = 0; test_id < TEST_COUNT; ++test_id) {
+        TRACE_SPAN_ID("test", test_id);
+
+        PerfCounters_start(counters);
         clock_t start_time = clock();
 
         for (unsigned repetition_id = 0; repetition_id < TEST_REPETITION; ++repetition_id)
         for (size_t word_id = 0; word_id < sample_size; ++word_id) {
-            const char* word_ptr = word_list + word_id * MAX_WORD_LENGTH;
-
-            #if OPTIMIZATION_LEVEL < 1
-            HashTable_find_value(&table, TESTED_HASH(word_ptr, word_ptr + MAX_WORD_LENGTH), word_ptr, strcmp);
-            #else
-            HashTable_find_value(&table, TESTED_HASH(word_ptr, word_ptr + MAX_WORD_LENGTH),
-                _mm256_load_si256((const __m256i*) word_ptr), simd_comparison_placeholder);
-            #endif
+            TABLE_FN(find_value)(&table, WORD_HASH(Hash, WORD_AT(query_list, word_id)), WORD_KEY(WORD_AT(query_list, word_id)));
         }
 
-        fprintf(out_timetable, "%u,%ld\n", test_id, clock() - start_time);
+        clock_t test_time = clock() - start_time;
+        PerfCounters_stop(counters);
+
+        fprintf(out_timetable, "%u,%ld", test_id, test_time);
+        PerfCounters_print(counters, out_timetable, (size_t) TEST_REPETITION * sample_size);
+        fputc('\n', out_timetable);
     }
 
     log_printf(STATUS_REPORTS, "status", "Testing is finished. Closing the file.\n");
 
     if (out_timetable) fclose(out_timetable);
 
+    log_printf(STATUS_REPORTS, "status", "Counting bucket scans eliminated by the filter.\n");
+
+    size_t miss_count = 0;
+    size_t filtered_count = 0;
+    for (size_t word_id = 0; word_id < sample_size; ++word_id) {
+        hash_t hash = WORD_HASH(Hash, WORD_AT(query_list, word_id));
+
+        if (TABLE_FN(find_value)(&table, hash, WORD_KEY(WORD_AT(query_list, word_id)))) continue;
+
+        ++miss_count;
+        if (table.filter.blocks && !BloomFilter_check(&table.filter, hash)) ++filtered_count;
+    }
+
+    FILE* out_filter_table = fopen(OUTPUT_FILTER_TABLE_NAME, "w");
+    _LOG_FAIL_CHECK_(out_filter_table, "error", ERROR_REPORTS, return_clean(EXIT_FAILURE), NULL, ENOENT);
+
+    fprintf(out_filter_table, "queries,absent,misses,filtered_misses\n");
+    fprintf(out_filter_table, "%lu,%lu,%lu,%lu\n", sample_size, absent_count, miss_count, filtered_count);
+
+    printf("%lu of %lu lookups missed, %lu of them were rejected by the filter.\n", miss_count, sample_size, filtered_count);
+
+    fclose(out_filter_table);
+
+    #endif
+
+
+    #ifdef LATENCY_TEST  //* LATENCY TEST CASE ==============================
+    log_printf(STATUS_REPORTS, "status", "Pinning the thread and calibrating the time stamp counter.\n");
+
+    pin_thread(BENCHMARK_CPU);
+    double ticks_per_ns = tsc_calibrate();
+    uint64_t timer_overhead = tsc_overhead();
+
+    //* Histograms are too large for the stack.
+    static LatencyHistogram insert_latency = {};
+    static LatencyHistogram find_latency = {};
+
+    size_t latency_absent_count = 0;
+    word_list_t latency_queries = BUILD_QUERY_LIST(word_list, sample_size, config->miss_ratio, &latency_absent_count);
+    _LOG_FAIL_CHECK_(latency_queries, "error", ERROR_REPORTS, return_clean(EXIT_FAILURE), NULL, ENOMEM);
+    track_allocation(latency_queries, free_variable);
+
+    log_printf(STATUS_REPORTS, "status", "Measuring insertion latency.\n");
+
+    for (unsigned run_id = 0; run_id < LATENCY_WARMUP_RUNS + TEST_COUNT; ++run_id) {
+        TRACE_SPAN_ID("latency_insert", run_id);
+
+        Table scratch_table = {};
+        TABLE_FN(ctor)(&scratch_table, config->expected_keys, &errno);
+        _LOG_FAIL_CHECK_(TABLE_FN(status)(&scratch_table) == 0, "error", ERROR_REPORTS, return_clean(EXIT_FAILURE), NULL, ENOMEM);
+        if (config->use_bloom) TABLE_FN(enable_filter)(&scratch_table, sample_size, &errno);
+
+        for (size_t word_id = 0; word_id < sample_size; ++word_id) {
+            uint64_t start = tsc_begin();
+            TABLE_FN(insert)(&scratch_table, WORD_HASH(Hash, WORD_AT(word_list, word_id)), WORD_KEY(WORD_AT(word_list, word_id)));
+            uint64_t end = tsc_end();
+
+            if (run_id >= LATENCY_WARMUP_RUNS) LatencyHistogram_record(&insert_latency, tsc_elapsed(start, end, timer_overhead));
+        }
+
+        TABLE_FN(dtor)(&scratch_table);
+    }
+
+    log_printf(STATUS_REPORTS, "status", "Measuring lookup latency.\n");
+
+    size_t found_count = 0;
+    for (unsigned run_id = 0; run_id < LATENCY_WARMUP_RUNS + TEST_COUNT; ++run_id)
+    for (size_t word_id = 0; word_id < sample_size; ++word_id) {
+        uint64_t start = tsc_begin();
+        bool found = TABLE_FN(find_value)(&table, WORD_HASH(Hash, WORD_AT(latency_queries, word_id)), WORD_KEY(WORD_AT(latency_queries, word_id)));
+        uint64_t end = tsc_end();
+
+        if (run_id >= LATENCY_WARMUP_RUNS) LatencyHistogram_record(&find_latency, tsc_elapsed(start, end, timer_overhead));
+        found_count += found;
+    }
+
+    log_printf(STATUS_REPORTS, "status", "%lu lookups succeeded.\n", found_count);
+
+    FILE* out_latency_table = fopen(OUTPUT_LATENCY_TABLE_NAME, "w");
+    _LOG_FAIL_CHECK_(out_latency_table, "error", ERROR_REPORTS, return_clean(EXIT_FAILURE), NULL, ENOENT);
+
+    fprintf(out_latency_table, "operation,samples,min_ns,p50_ns,p99_ns,p999_ns,max_ns\n");
+    LatencyHistogram_print(&insert_latency, out_latency_table, "insert", ticks_per_ns);
+    LatencyHistogram_print(&find_latency, out_latency_table, "find", ticks_per_ns);
+
+    fclose(out_latency_table);
+
+    printf("operation,samples,min_ns,p50_ns,p99_ns,p999_ns,max_ns\n");
+    LatencyHistogram_print(&insert_latency, stdout, "insert", ticks_per_ns);
+    LatencyHistogram_print(&find_latency, stdout, "find", ticks_per_ns);
+
     #endif
 
     return_clean(errno == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
 }
+
+int main(const int argc, const char** argv) {
+    atexit(log_end_program);
+
+    start_local_tracking();
+    unsigned int log_threshold = STATUS_REPORTS;
+    MAKE_WRAPPER(log_threshold);
+    bool use_bloom = false;
+    MAKE_WRAPPER(use_bloom);
+    double miss_ratio = 0.0;
+    MAKE_WRAPPER(miss_ratio);
+    int expected_keys = 0;
+    MAKE_WRAPPER(expected_keys);
+    const char* stats_format = NULL;
+    MAKE_WRAPPER(stats_format);
+    const char* workload = NULL;
+    MAKE_WRAPPER(workload);
+    const char* summary_format = NULL;
+    MAKE_WRAPPER(summary_format);
+    int test_count = 0;
+    MAKE_WRAPPER(test_count);
+    int test_repetition = 0;
+    MAKE_WRAPPER(test_repetition);
+    double zipf_exponent = DFLT_ZIPF_EXPONENT;
+    MAKE_WRAPPER(zipf_exponent);
+    const char* operation_mix = NULL;
+    MAKE_WRAPPER(operation_mix);
+    int generated_keys = 0;
+    MAKE_WRAPPER(generated_keys);
+    int sweep_keys = 0;
+    MAKE_WRAPPER(sweep_keys);
+    const char* length_range = NULL;
+    MAKE_WRAPPER(length_range);
+    const char* key_alphabet = NULL;
+    MAKE_WRAPPER(key_alphabet);
+    double duplicate_rate = 0.0;
+    MAKE_WRAPPER(duplicate_rate);
+    const char* baseline_file = NULL;
+    MAKE_WRAPPER(baseline_file);
+    const char* candidate_file = NULL;
+    MAKE_WRAPPER(candidate_file);
+    double regression_threshold = DFLT_REGRESSION_THRESHOLD;
+    MAKE_WRAPPER(regression_threshold);
+    const char* text_file = NULL;
+    MAKE_WRAPPER(text_file);
+    const char* wordlist_output = NULL;
+    MAKE_WRAPPER(wordlist_output);
+    int thread_count = 0;
+    MAKE_WRAPPER(thread_count);
+    const char* stream_file = NULL;
+    MAKE_WRAPPER(stream_file);
+    const char* compact_output = NULL;
+    MAKE_WRAPPER(compact_output);
+    const char* compact_file = NULL;
+    MAKE_WRAPPER(compact_file);
+    const char* shard_directory = NULL;
+    MAKE_WRAPPER(shard_directory);
+    const char* engine_name = NULL;
+    MAKE_WRAPPER(engine_name);
+    const char* hash_name = NULL;
+    MAKE_WRAPPER(hash_name);
+    int bucket_count = 0;
+    MAKE_WRAPPER(bucket_count);
+    const char* matrix_spec = NULL;
+    MAKE_WRAPPER(matrix_spec);
+
+    ActionTag line_tags[] = {
+        #include "cmd_flags/main_flags.h"
+    };
+    const int number_of_tags = ARR_SIZE(line_tags);
+
+    parse_args(argc, argv, number_of_tags, line_tags);
+    log_init("program_log.html", log_threshold, &errno);
+    print_label();
+
+    #ifdef TRACE_SPANS
+    trace_open(OUTPUT_TRACE_NAME, &errno);
+    atexit(trace_close);
+    #endif
+
+    KeyGeneratorConfig generator = {};
+    generator.duplicate_rate = duplicate_rate;
+    if (key_alphabet) generator.alphabet = key_alphabet;
+
+    _LOG_FAIL_CHECK_(!length_range || parse_length_range(length_range, &generator), "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Invalid key length range \"%s\".\n", length_range);
+        return_clean(EXIT_FAILURE);
+    }, NULL, EINVAL);
+
+    ResultSet baseline_results = {};
+    track_allocation(baseline_results, ResultSet_dtor);
+    ResultSet candidate_results = {};
+    track_allocation(candidate_results, ResultSet_dtor);
+
+    if (baseline_file) {
+        _LOG_FAIL_CHECK_(read_results(baseline_file, &baseline_results, &errno) == 0, "error", ERROR_REPORTS,
+            return_clean(EXIT_FAILURE), NULL, EINVAL);
+    }
+
+    if (candidate_file) {
+        _LOG_FAIL_CHECK_(baseline_file, "error", ERROR_REPORTS, {
+            log_printf(ERROR_REPORTS, "error", "Candidate results can only be compared with a baseline (-C).\n");
+            return_clean(EXIT_FAILURE);
+        }, NULL, EINVAL);
+
+        _LOG_FAIL_CHECK_(read_results(candidate_file, &candidate_results, &errno) == 0, "error", ERROR_REPORTS,
+            return_clean(EXIT_FAILURE), NULL, EINVAL);
+
+        size_t regression_count = compare_results(&baseline_results, &candidate_results, regression_threshold, stdout);
+        return_clean(regression_count == 0 && errno == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    _LOG_FAIL_CHECK_(thread_count >= 0, "error", ERROR_REPORTS, return_clean(EXIT_FAILURE), NULL, EINVAL);
+
+    _LOG_FAIL_CHECK_(!engine_name || is_table_engine(engine_name), "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Unknown table engine \"%s\".\n", engine_name);
+        return_clean(EXIT_FAILURE);
+    }, NULL, EINVAL);
+
+    _LOG_FAIL_CHECK_(!hash_name || find_hash_function(hash_name), "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Unknown hash function \"%s\".\n", hash_name);
+        return_clean(EXIT_FAILURE);
+    }, NULL, EINVAL);
+
+    _LOG_FAIL_CHECK_(bucket_count >= 0, "error", ERROR_REPORTS, return_clean(EXIT_FAILURE), NULL, EINVAL);
+
+    if (engine_name) tested_variant.engine = engine_name;
+    if (hash_name) tested_variant.hash = *find_hash_function(hash_name);
+    if (bucket_count) tested_variant.bucket_count = (size_t) bucket_count;
+
+    log_printf(STATUS_REPORTS, "status", "Tested variant is %s with %s and %lu buckets.\n",
+        tested_variant.engine, tested_variant.hash.name, tested_variant.bucket_count);
+
+    MatrixSpec matrix = {};
+    _LOG_FAIL_CHECK_(!matrix_spec || parse_matrix_spec(matrix_spec, &matrix), "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Invalid matrix \"%s\".\n", matrix_spec);
+        return_clean(EXIT_FAILURE);
+    }, NULL, EINVAL);
+
+    for (size_t engine_id = 0; engine_id < matrix.engine_count; ++engine_id) {
+        _LOG_FAIL_CHECK_(is_table_engine(matrix.engines[engine_id]), "error", ERROR_REPORTS, {
+            log_printf(ERROR_REPORTS, "error", "Unknown table engine \"%s\".\n", matrix.engines[engine_id]);
+            return_clean(EXIT_FAILURE);
+        }, NULL, EINVAL);
+    }
+
+    TableTestOptions options = {};
+    options.stats_format = stats_format;
+    options.run_benchmark = workload;
+    //* Distinct generated keys let the table skip duplicate checks while it is built.
+    options.distinct_keys = generated_keys > 0 && duplicate_rate <= 0.0;
+    options.baseline_results = baseline_file ? &baseline_results : NULL;
+    options.candidate_results = &candidate_results;
+    options.regression_threshold = regression_threshold;
+
+    _LOG_FAIL_CHECK_(expected_keys >= 0, "error", ERROR_REPORTS, return_clean(EXIT_FAILURE), NULL, EINVAL);
+
+    BenchmarkConfig* config = &options.benchmark;
+    config->miss_ratio = miss_ratio;
+    config->zipf_exponent = zipf_exponent;
+    config->expected_keys = (size_t) expected_keys;
+    config->use_bloom = use_bloom;
+
+    _LOG_FAIL_CHECK_(!stats_format || strcmp(stats_format, "csv") == 0 || strcmp(stats_format, "json") == 0, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Unknown statistics format \"%s\".\n", stats_format);
+        return_clean(EXIT_FAILURE);
+    }, NULL, EINVAL);
+
+    //* Matrix benchmarks the workload of -W, lookups of stored keys by default.
+    if (workload) config->workload = parse_workload(workload);
+
+    _LOG_FAIL_CHECK_(config->workload != WORKLOAD_UNKNOWN, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Unknown workload \"%s\".\n", workload);
+        return_clean(EXIT_FAILURE);
+    }, NULL, EINVAL);
+
+    _LOG_FAIL_CHECK_(test_count >= 0 && test_repetition >= 0, "error", ERROR_REPORTS, return_clean(EXIT_FAILURE), NULL, EINVAL);
+    if (test_count) config->test_count = (unsigned) test_count;
+    if (test_repetition) config->repetition = (unsigned) test_repetition;
+
+    _LOG_FAIL_CHECK_(!operation_mix || parse_operation_mix(operation_mix, &config->insert_share, &config->remove_share),
+        "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Invalid operation mix \"%s\".\n", operation_mix);
+        return_clean(EXIT_FAILURE);
+    }, NULL, EINVAL);
+
+    _LOG_FAIL_CHECK_(!summary_format || strcmp(summary_format, "csv") == 0 || strcmp(summary_format, "json") == 0,
+        "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Unknown summary format \"%s\".\n", summary_format);
+        return_clean(EXIT_FAILURE);
+    }, NULL, EINVAL);
+    config->format = summary_format && strcmp(summary_format, "json") == 0 ? SUMMARY_JSON : SUMMARY_CSV;
+
+    if (wordlist_output) {
+        _LOG_FAIL_CHECK_(text_file, "error", ERROR_REPORTS, {
+            log_printf(ERROR_REPORTS, "error", "Word list can only be written from the tokenized text (-P).\n");
+            return_clean(EXIT_FAILURE);
+        }, NULL, EINVAL);
+
+        const char* words = NULL;
+        size_t word_count = tokenize_words(text_file, &words, (unsigned) thread_count, &errno);
+        int write_status = words ? write_words(wordlist_output, words, word_count, &errno) : -1;
+        free((void*) words);
+
+        _LOG_FAIL_CHECK_(write_status == 0, "error", ERROR_REPORTS, return_clean(EXIT_FAILURE), NULL, EIO);
+
+        printf("Wrote %lu words to %s.\n", word_count, wordlist_output);
+        return_clean(EXIT_SUCCESS);
+    }
+
+    if (stream_file) {
+        int status = with_table_engine(tested_variant.engine, [&]<typename Table>(Table*) {
+            return run_stream_ingest<Table>(config, stream_file, stdout, &errno);
+        });
+
+        _LOG_FAIL_CHECK_(status == 0, "error", ERROR_REPORTS, return_clean(EXIT_FAILURE), NULL, EFAULT);
+
+        return_clean(errno == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    if (shard_directory) {
+        int status = with_table_engine(tested_variant.engine, [&]<typename Table>(Table*) {
+            return run_shard_ingest<Table>(config, shard_directory, (unsigned) thread_count, stdout, &errno);
+        });
+
+        _LOG_FAIL_CHECK_(status == 0, "error", ERROR_REPORTS, return_clean(EXIT_FAILURE), NULL, EFAULT);
+
+        return_clean(errno == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    if (compact_output) {
+        const char* sample_file_name = get_input_file_name(argc, argv, DEFAULT_SAMPLE_NAME);
+        log_printf(STATUS_REPORTS, "status", "Converting file %s.\n", sample_file_name);
+
+        const char* words = NULL;
+        size_t word_count = read_words(sample_file_name, &words);
+        int write_status = words ? write_compact_words(compact_output, words, word_count, tested_variant.hash.function, TESTED_HASH_NAME, &errno) : -1;
+        if (words) munmap((void*) words, word_count * MAX_WORD_LENGTH);
+
+        _LOG_FAIL_CHECK_(write_status == 0, "error", ERROR_REPORTS, return_clean(EXIT_FAILURE), NULL, EIO);
+
+        printf("Wrote %lu words to %s.\n", word_count, compact_output);
+        return_clean(EXIT_SUCCESS);
+    }
+
+    if (compact_file) {
+        int status = with_table_variant(&tested_variant, [&]<typename Table, hash_fn_t* Hash>(Table*, HashFunction<Hash>) {
+            return run_compact_ingest<Table, Hash>(config, compact_file, stdout, &errno);
+        });
+
+        _LOG_FAIL_CHECK_(status == 0, "error", ERROR_REPORTS, return_clean(EXIT_FAILURE), NULL, EFAULT);
+
+        return_clean(errno == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    if (sweep_keys > 0) {
+        int status = with_table_variant(&tested_variant, [&]<typename Table, hash_fn_t* Hash>(Table*, HashFunction<Hash>) {
+            return run_size_sweep<Table, Hash>(config, &generator, (size_t) sweep_keys, stdout, &errno);
+        });
+
+        _LOG_FAIL_CHECK_(status == 0, "error", ERROR_REPORTS, return_clean(EXIT_FAILURE), NULL, EFAULT);
+
+        return_clean(errno == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    #ifdef PERFORMANCE_TEST
+    PerfCounters counters = {};
+    PerfCounters_ctor(&counters, &errno);
+    track_allocation(counters, PerfCounters_dtor);
+
+    PerfCounters_start(&counters);
+    clock_t load_start = clock();
+    #endif
+
+    word_list_t word_list = NULL;
+    size_t sample_size = 0;
+
+    if (generated_keys > 0) {
+        generator.key_count = (size_t) generated_keys;
+        sample_size = GENERATE_SAMPLE(&generator, &word_list);
+    } else if (text_file) {
+        sample_size = TOKENIZE_SAMPLE(text_file, &word_list, (unsigned) thread_count, &errno);
+    } else {
+        const char* sample_file_name = get_input_file_name(argc, argv, DEFAULT_SAMPLE_NAME);
+        log_printf(STATUS_REPORTS, "status", "Opening file %s.\n", sample_file_name);
+        sample_size = READ_SAMPLE(sample_file_name, &word_list);
+    }
+
+    _LOG_FAIL_CHECK_(word_list, "error", ERROR_REPORTS, return_clean(EXIT_FAILURE), NULL, ENOENT);
+
+    #ifdef PERFORMANCE_TEST
+    options.load_time = clock() - load_start;
+    PerfCounters_stop(&counters);
+
+    options.counters = &counters;
+    #endif
+
+    //* Word lists of 32-byte words read from word list files are memory-mapped, all others are allocated on the heap.
+    #ifdef STRING_KEYS
+    word_list_t owned_list = word_list;
+    #else
+    word_list_t owned_list = generated_keys > 0 || text_file ? word_list : NULL;
+    #endif
+    track_allocation(owned_list, free_variable);
+
+    if (matrix_spec) {
+        log_printf(STATUS_REPORTS, "status", "Running the matrix of up to %lu variants.\n", MatrixSpec_size(&matrix));
+
+        FILE* out_matrix = fopen(OUTPUT_MATRIX_TABLE_NAME, "w");
+        _LOG_FAIL_CHECK_(out_matrix, "error", ERROR_REPORTS, return_clean(EXIT_FAILURE), NULL, ENOENT);
+
+        int variant_count = run_matrix(&matrix, config, word_list, sample_size, out_matrix, &candidate_results, &errno);
+        fclose(out_matrix);
+
+        _LOG_FAIL_CHECK_(variant_count >= 0, "error", ERROR_REPORTS, return_clean(EXIT_FAILURE), NULL, EFAULT);
+
+        printf("Benchmarked %d variants, results were written to %s.\n", variant_count, OUTPUT_MATRIX_TABLE_NAME);
+
+        size_t regression_count = baseline_file ? compare_results(&baseline_results, &candidate_results, regression_threshold, stdout) : 0;
+        return_clean(regression_count == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    //* Word list is tracked by this function, so it is freed only after the tests.
+    int status = with_table_variant(&tested_variant, [&]<typename Table, hash_fn_t* Hash>(Table*, HashFunction<Hash>) {
+        return run_table_tests<Table, Hash>(&options, word_list, sample_size);
+    });
+
+    return_clean(status);
+}
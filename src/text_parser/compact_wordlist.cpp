@@ -0,0 +1,118 @@
+#include "compact_wordlist.h"
+
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+int write_compact_words(const char* file_name, const char* words, size_t word_count, hash_fn_t* hash, const char* hash_name, err_anchor_t err_code) {
+    _LOG_FAIL_CHECK_(file_name && (words || word_count == 0), "error", ERROR_REPORTS, return -1, err_code, EINVAL);
+    _LOG_FAIL_CHECK_(!hash || (hash_name && strlen(hash_name) < sizeof(CompactWordListHeader::hash_name)),
+        "error", ERROR_REPORTS, return -1, err_code, EINVAL);
+
+    CompactWordListHeader header = {};
+    memcpy(header.magic, COMPACT_WORDLIST_MAGIC, sizeof(header.magic));
+    header.version = COMPACT_WORDLIST_VERSION;
+    header.flags = hash ? COMPACT_HAS_HASHES : 0;
+    header.word_count = word_count;
+    if (hash) strcpy(header.hash_name, hash_name);
+
+    for (size_t word_id = 0; word_id < word_count; ++word_id) {
+        header.key_bytes += strnlen(words + word_id * MAX_WORD_LENGTH, MAX_WORD_LENGTH) + 1;
+    }
+
+    FILE* file = fopen(file_name, "wb");
+    _LOG_FAIL_CHECK_(file, "error", ERROR_REPORTS, return -1, err_code, ENOENT);
+
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1;
+
+    for (size_t word_id = 0; hash && written && word_id < word_count; ++word_id) {
+        const char* word = words + word_id * MAX_WORD_LENGTH;
+        hash_t word_hash = hash(word, word + MAX_WORD_LENGTH);
+        written = fwrite(&word_hash, sizeof(word_hash), 1, file) == 1;
+    }
+
+    for (size_t word_id = 0; written && word_id < word_count; ++word_id) {
+        written = fputc((int) strnlen(words + word_id * MAX_WORD_LENGTH, MAX_WORD_LENGTH), file) != EOF;
+    }
+
+    for (size_t word_id = 0; written && word_id < word_count; ++word_id) {
+        const char* word = words + word_id * MAX_WORD_LENGTH;
+        size_t length = strnlen(word, MAX_WORD_LENGTH);
+        written = fwrite(word, 1, length, file) == length && fputc('\0', file) != EOF;
+    }
+
+    written = fclose(file) == 0 && written;
+
+    _LOG_FAIL_CHECK_(written, "error", ERROR_REPORTS, return -1, err_code, EIO);
+
+    return 0;
+}
+
+size_t read_compact_words(const char* file_name, CompactWordList* list, err_anchor_t err_code) {
+    _LOG_FAIL_CHECK_(file_name && list, "error", ERROR_REPORTS, return 0, err_code, EINVAL);
+
+    *list = {};
+
+    int fd = open(file_name, O_RDONLY);
+    _LOG_FAIL_CHECK_(fd != -1, "error", ERROR_REPORTS, return 0, err_code, ENOENT);
+
+    struct stat st = {};
+    fstat(fd, &st);
+    size_t file_size = (size_t) st.st_size;
+
+    _LOG_FAIL_CHECK_(file_size >= sizeof(CompactWordListHeader), "error", ERROR_REPORTS, { close(fd); return 0; }, err_code, EINVAL);
+
+    //* The whole list is inserted right away, so it is read in advance.
+    void* mapping = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+    close(fd);
+
+    _LOG_FAIL_CHECK_(mapping != MAP_FAILED, "error", ERROR_REPORTS, return 0, err_code, ENOMEM);
+
+    list->mapping = mapping;
+    list->file_size = file_size;
+
+    const CompactWordListHeader* header = (const CompactWordListHeader*) mapping;
+    size_t hash_bytes = header->flags & COMPACT_HAS_HASHES && header->word_count <= file_size ? header->word_count * sizeof(hash_t) : 0;
+
+    _LOG_FAIL_CHECK_(memcmp(header->magic, COMPACT_WORDLIST_MAGIC, sizeof(header->magic)) == 0 &&
+                     header->version == COMPACT_WORDLIST_VERSION &&
+                     memchr(header->hash_name, '\0', sizeof(header->hash_name)) &&
+                     header->word_count > 0 && header->word_count <= file_size && header->key_bytes <= file_size &&
+                     sizeof(*header) + hash_bytes + header->word_count + header->key_bytes == file_size,
+        "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "File %s is not a valid compact word list.\n", file_name);
+        CompactWordList_dtor(list);
+        return 0;
+    }, err_code, EINVAL);
+
+    list->word_count = header->word_count;
+    list->hashes = hash_bytes ? (const hash_t*) (header + 1) : NULL;
+    list->hash_name = header->hash_name;
+    list->lengths = (const unsigned char*) (header + 1) + hash_bytes;
+    list->keys = (const char*) list->lengths + list->word_count;
+
+    //* Keys are found by summing their lengths, so the index has to match the key section.
+    //* The last key has to be terminated, so that no key comparison reaches the end of the mapping.
+    size_t key_bytes = 0;
+    for (size_t word_id = 0; word_id < list->word_count; ++word_id) {
+        if (list->lengths[word_id] > MAX_WORD_LENGTH) key_bytes = SIZE_MAX;
+        else key_bytes += list->lengths[word_id] + 1lu;
+
+        if (key_bytes > header->key_bytes) break;
+    }
+
+    _LOG_FAIL_CHECK_(key_bytes == header->key_bytes && list->keys[key_bytes - 1] == '\0', "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Length index of %s does not match its keys.\n", file_name);
+        CompactWordList_dtor(list);
+        return 0;
+    }, err_code, EINVAL);
+
+    return list->word_count;
+}
+
+void CompactWordList_dtor(CompactWordList* list) {
+    if (list->mapping) munmap(list->mapping, list->file_size);
+    *list = {};
+}
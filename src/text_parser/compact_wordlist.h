@@ -0,0 +1,133 @@
+/**
+ * @file compact_wordlist.h
+ * @author Kudryashov Ilya (kudriashov.it@phystech.edu)
+ * @brief Word lists of concatenated variable-length keys with a length index and optional precomputed hashes.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef COMPACT_WORDLIST_H
+#define COMPACT_WORDLIST_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <x86intrin.h>
+
+#include "lib/util/dbg/debug.h"
+#include "src/hash/hash.h"
+#include "src/utils/config.h"
+
+//* File layout (little-endian):
+//*     CompactWordListHeader
+//*     hash_t hashes[word_count]           (only if COMPACT_HAS_HASHES is set)
+//*     uint8_t lengths[word_count]
+//*     char keys[key_bytes]                (keys in the order of lengths, each followed by a single zero byte)
+
+static const char COMPACT_WORDLIST_MAGIC[8] = { 'H', 'T', 'W', 'O', 'R', 'D', 'S', '\0' };
+static const uint32_t COMPACT_WORDLIST_VERSION = 1;
+
+enum COMPACT_WORDLIST_FLAG {
+    COMPACT_HAS_HASHES = 1 << 0,
+};
+
+/**
+ * @brief Header of the compact word list file.
+ *
+ * @param magic COMPACT_WORDLIST_MAGIC
+ * @param version COMPACT_WORDLIST_VERSION
+ * @param flags COMPACT_WORDLIST_FLAG bits
+ * @param word_count number of words
+ * @param key_bytes size of the key section
+ * @param hash_name zero-terminated name of the hash function the hashes were computed with
+ *      (over MAX_WORD_LENGTH bytes of the zero-padded word, as in read_words() lists)
+ */
+struct CompactWordListHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint64_t word_count;
+    uint64_t key_bytes;
+    char hash_name[32];
+};
+
+/**
+ * @brief Memory-mapped compact word list.
+ *
+ * @param keys zero-terminated keys, one after another
+ * @param lengths lengths of the keys
+ * @param hashes precomputed hashes of the keys (NULL if the file has none)
+ * @param hash_name name of the hash function the hashes were computed with
+ * @param word_count number of words
+ * @param file_size size of the mapped file
+ * @param mapping mapped file
+ */
+struct CompactWordList {
+    const char* keys = NULL;
+    const unsigned char* lengths = NULL;
+    const hash_t* hashes = NULL;
+    const char* hash_name = NULL;
+    size_t word_count = 0;
+    size_t file_size = 0;
+    void* mapping = NULL;
+};
+
+/**
+ * @brief Convert word list in the format of read_words() to the compact format and write it to the file
+ *
+ * @param file_name name of the file to write to
+ * @param words word list
+ * @param word_count number of words in the list
+ * @param hash hash function to precompute hashes with (NULL to store no hashes)
+ * @param hash_name name of the hash function
+ * @param err_code variable to use as errno
+ * @return 0 if the list was written, -1 otherwise
+ */
+int write_compact_words(const char* file_name, const char* words, size_t word_count, hash_fn_t* hash, const char* hash_name, ERROR_MARKER);
+
+/**
+ * @brief Map compact word list file to memory
+ *
+ * @param file_name name of the file to read
+ * @param list list to initialize (should be destroyed with CompactWordList_dtor())
+ * @param err_code variable to use as errno
+ * @return number of words (0 if failed)
+ */
+size_t read_compact_words(const char* file_name, CompactWordList* list, ERROR_MARKER);
+
+/**
+ * @brief Unmap the list
+ *
+ * @param list list to destroy
+ */
+void CompactWordList_dtor(CompactWordList* list);
+
+/**
+ * @brief Load the key to the register zero-padded to MAX_WORD_LENGTH bytes without copying it in memory
+ *
+ * @param list list the key belongs to
+ * @param key first byte of the key
+ * @param length length of the key (at most MAX_WORD_LENGTH)
+ * @return zero-padded key
+ */
+static inline __m256i CompactWordList_vector(const CompactWordList* list, const char* key, size_t length) {
+    __m256i word = _mm256_setzero_si256();
+
+    //* Bytes after the key belong to the next keys, only the last keys of the file are too close to its end to be read at once.
+    if (key + MAX_WORD_LENGTH <= (const char*) list->mapping + list->file_size) {
+        word = _mm256_loadu_si256((const __m256i*) key);
+    } else {
+        memcpy(&word, key, length);
+    }
+
+    __m256i index = _mm256_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+                                     16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31);
+    __m256i mask = _mm256_cmpgt_epi8(_mm256_set1_epi8((char) length), index);
+
+    return _mm256_and_si256(word, mask);
+}
+
+#endif
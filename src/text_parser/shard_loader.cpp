@@ -0,0 +1,609 @@
+#include "shard_loader.h"
+
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lib/util/dbg/trace.h"
+
+/**
+ * @brief Word list file being read.
+ *
+ * @param fd descriptor of the file (-1 if not opened or already read)
+ * @param size size of the file
+ * @param remaining number of bytes not yet passed to the consumer
+ */
+struct ShardFile {
+    int fd = -1;
+    size_t size = 0;
+    size_t remaining = 0;
+};
+
+/**
+ * @brief Read of a part of the file.
+ *
+ * @param file_id file to read
+ * @param offset offset of the part in the file
+ * @param size size of the part
+ * @param done number of bytes already read
+ * @param words buffer to read the part to
+ * @param hashes hashes of the words of the part
+ */
+struct ShardRead {
+    size_t file_id = 0;
+    size_t offset = 0;
+    size_t size = 0;
+    size_t done = 0;
+    char* words = NULL;
+    hash_t* hashes = NULL;
+};
+
+/**
+ * @brief State of the loader.
+ *
+ * @param file_names names of the files
+ * @param files files
+ * @param file_count number of files
+ * @param next_file file the next read belongs to
+ * @param next_offset offset of the next read in its file
+ * @param config loader parameters
+ * @param consumer function to pass every read to
+ * @param context first argument of the consumer
+ * @param stats results of the loader
+ * @param error errno value of the first failure (0 if nothing failed)
+ * @param lock mutex guarding the files, the next read, the results and the error in the thread pool
+ * @param consumer_lock mutex letting one thread at a time call the consumer
+ */
+struct ShardLoader {
+    const char* const* file_names = NULL;
+    ShardFile* files = NULL;
+    size_t file_count = 0;
+    size_t next_file = 0;
+    size_t next_offset = 0;
+    const ShardLoaderConfig* config = NULL;
+    word_batch_fn_t* consumer = NULL;
+    void* context = NULL;
+    ShardLoaderStats stats = {};
+    int error = 0;
+    pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+    pthread_mutex_t consumer_lock = PTHREAD_MUTEX_INITIALIZER;
+};
+
+static void ShardLoader_fail(ShardLoader* loader, int error) {
+    if (!loader->error) loader->error = error;
+}
+
+/**
+ * @brief Choose the next part to read, opening files as they are reached (called with the lock held)
+ *
+ * @param loader loader state
+ * @param read read to initialize
+ * @return false if all files were read or opening a file failed
+ */
+static bool ShardLoader_next(ShardLoader* loader, ShardRead* read) {
+    for (; loader->next_file < loader->file_count; ++loader->next_file, loader->next_offset = 0) {
+        ShardFile* file = &loader->files[loader->next_file];
+
+        if (loader->next_offset == 0) {
+            file->fd = open(loader->file_names[loader->next_file], O_RDONLY);
+            if (file->fd == -1) {
+                ShardLoader_fail(loader, ENOENT);
+                return false;
+            }
+
+            struct stat st = {};
+            fstat(file->fd, &st);
+            file->size = file->remaining = (size_t) st.st_size;
+            ++loader->stats.file_count;
+
+            if (file->size % MAX_WORD_LENGTH != 0) {
+                ShardLoader_fail(loader, EINVAL);
+                return false;
+            }
+
+            posix_fadvise(file->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        }
+
+        if (loader->next_offset < file->size) break;
+
+        //* Empty files are closed right away, others once their last read is consumed.
+        if (file->size == 0) {
+            close(file->fd);
+            file->fd = -1;
+        }
+    }
+
+    if (loader->next_file == loader->file_count) return false;
+
+    ShardFile* file = &loader->files[loader->next_file];
+
+    read->file_id = loader->next_file;
+    read->offset = loader->next_offset;
+    read->size = file->size - loader->next_offset;
+    if (read->size > loader->config->read_size) read->size = loader->config->read_size;
+    read->done = 0;
+
+    loader->next_offset += read->size;
+
+    return true;
+}
+
+/**
+ * @brief Hash the words of the completed read and pass them to the consumer
+ *
+ * @param loader loader state
+ * @param read completed read
+ */
+static void ShardLoader_finish(ShardLoader* loader, ShardRead* read) {
+    size_t word_count = read->size / MAX_WORD_LENGTH;
+
+    {
+        TRACE_SPAN_ID("shard_hash", read->file_id);
+
+        for (size_t word_id = 0; word_id < word_count; ++word_id) {
+            const char* word = read->words + word_id * MAX_WORD_LENGTH;
+            read->hashes[word_id] = loader->config->hash(word, word + MAX_WORD_LENGTH);
+        }
+    }
+
+    pthread_mutex_lock(&loader->consumer_lock);
+    {
+        TRACE_SPAN_ID("shard_insert", read->file_id);
+        loader->consumer(loader->context, read->words, read->hashes, word_count);
+    }
+    pthread_mutex_unlock(&loader->consumer_lock);
+
+    pthread_mutex_lock(&loader->lock);
+
+    loader->stats.word_count += word_count;
+    loader->stats.bytes_read += read->size;
+
+    ShardFile* file = &loader->files[read->file_id];
+    file->remaining -= read->size;
+    if (file->remaining == 0) {
+        close(file->fd);
+        file->fd = -1;
+    }
+
+    pthread_mutex_unlock(&loader->lock);
+}
+
+static bool ShardRead_ctor(ShardRead* read, size_t read_size) {
+    *read = {};
+    read->words = (char*) aligned_alloc(MAX_WORD_LENGTH, read_size);
+    read->hashes = (hash_t*) calloc(read_size / MAX_WORD_LENGTH, sizeof(*read->hashes));
+
+    return read->words && read->hashes;
+}
+
+static void ShardRead_dtor(ShardRead* read) {
+    free(read->words);
+    free(read->hashes);
+    *read = {};
+}
+
+//* IO_URING ==============================
+
+/**
+ * @brief Submission and completion queues of io_uring mapped to memory.
+ */
+struct ShardRing {
+    int fd = -1;
+    unsigned* sq_tail = NULL;
+    unsigned* sq_mask = NULL;
+    unsigned* sq_array = NULL;
+    io_uring_sqe* sqes = NULL;
+    unsigned* cq_head = NULL;
+    unsigned* cq_tail = NULL;
+    unsigned* cq_mask = NULL;
+    io_uring_cqe* cqes = NULL;
+    void* sq_ring = NULL;
+    size_t sq_ring_size = 0;
+    void* cq_ring = NULL;
+    size_t cq_ring_size = 0;
+    size_t sqes_size = 0;
+};
+
+static void ShardRing_dtor(ShardRing* ring) {
+    if (ring->sqes && ring->sqes != MAP_FAILED) munmap(ring->sqes, ring->sqes_size);
+    if (ring->cq_ring && ring->cq_ring != MAP_FAILED && ring->cq_ring != ring->sq_ring) munmap(ring->cq_ring, ring->cq_ring_size);
+    if (ring->sq_ring && ring->sq_ring != MAP_FAILED) munmap(ring->sq_ring, ring->sq_ring_size);
+    if (ring->fd != -1) close(ring->fd);
+    *ring = {};
+}
+
+/**
+ * @brief Set up io_uring with at least the specified number of entries
+ *
+ * @param ring ring to set up
+ * @param entries number of entries
+ * @return false if io_uring is not available
+ */
+static bool ShardRing_ctor(ShardRing* ring, unsigned entries) {
+    *ring = {};
+
+    io_uring_params params = {};
+    ring->fd = (int) syscall(__NR_io_uring_setup, entries, &params);
+    if (ring->fd < 0) {
+        ring->fd = -1;
+        return false;
+    }
+
+    ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    ring->sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+
+    //* Newer kernels map both rings at once.
+    bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap && ring->cq_ring_size > ring->sq_ring_size) ring->sq_ring_size = ring->cq_ring_size;
+
+    ring->sq_ring = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+    ring->cq_ring = single_mmap ? ring->sq_ring :
+        mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+    ring->sqes = (io_uring_sqe*) mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+
+    if (ring->sq_ring == MAP_FAILED || ring->cq_ring == MAP_FAILED || ring->sqes == MAP_FAILED) {
+        ShardRing_dtor(ring);
+        return false;
+    }
+
+    char* sq_ring = (char*) ring->sq_ring;
+    ring->sq_tail = (unsigned*) (sq_ring + params.sq_off.tail);
+    ring->sq_mask = (unsigned*) (sq_ring + params.sq_off.ring_mask);
+    ring->sq_array = (unsigned*) (sq_ring + params.sq_off.array);
+
+    char* cq_ring = (char*) ring->cq_ring;
+    ring->cq_head = (unsigned*) (cq_ring + params.cq_off.head);
+    ring->cq_tail = (unsigned*) (cq_ring + params.cq_off.tail);
+    ring->cq_mask = (unsigned*) (cq_ring + params.cq_off.ring_mask);
+    ring->cqes = (io_uring_cqe*) (cq_ring + params.cq_off.cqes);
+
+    return true;
+}
+
+/**
+ * @brief Check that the kernel supports IORING_OP_READ (added in 5.6, together with the probe itself)
+ *
+ * @param ring ring to probe
+ * @return false if reads have to go through the thread pool
+ */
+static bool ShardRing_can_read(const ShardRing* ring) {
+    unsigned op_count = IORING_OP_READ + 1;
+    io_uring_probe* probe = (io_uring_probe*) calloc(1, sizeof(*probe) + op_count * sizeof(probe->ops[0]));
+    if (!probe) return false;
+
+    bool can_read = syscall(__NR_io_uring_register, ring->fd, IORING_REGISTER_PROBE, probe, op_count) == 0 &&
+        probe->last_op >= IORING_OP_READ && (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED);
+
+    free(probe);
+    return can_read;
+}
+
+/**
+ * @brief Queue the rest of the read (submitted by the next ShardRing_enter())
+ *
+ * @param ring ring to queue the read to
+ * @param read read
+ * @param fd descriptor of the file
+ * @param read_id identifier of the read passed back with its completion
+ */
+static void ShardRing_queue(ShardRing* ring, const ShardRead* read, int fd, size_t read_id) {
+    unsigned tail = *ring->sq_tail;
+    unsigned index = tail & *ring->sq_mask;
+
+    io_uring_sqe* sqe = &ring->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = fd;
+    sqe->addr = (uintptr_t) (read->words + read->done);
+    sqe->len = (uint32_t) (read->size - read->done);
+    sqe->off = read->offset + read->done;
+    sqe->user_data = read_id;
+
+    ring->sq_array[index] = index;
+
+    //* The kernel may see the entry as soon as the tail moves.
+    __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Submit queued reads and wait for completions
+ *
+ * @return number of submitted reads (-1 if failed)
+ */
+static int ShardRing_enter(ShardRing* ring, unsigned submit_count, unsigned wait_count) {
+    int submitted = -1;
+
+    do submitted = (int) syscall(__NR_io_uring_enter, ring->fd, submit_count, wait_count, IORING_ENTER_GETEVENTS, NULL, 0);
+    while (submitted < 0 && errno == EINTR);
+
+    return submitted;
+}
+
+/**
+ * @brief Read all files through io_uring
+ *
+ * @param loader loader state
+ * @return false if io_uring is not available
+ */
+static bool ShardLoader_uring(ShardLoader* loader) {
+    unsigned depth = loader->config->queue_depth;
+
+    ShardRing ring = {};
+    if (!ShardRing_ctor(&ring, depth)) return false;
+
+    if (!ShardRing_can_read(&ring)) {
+        ShardRing_dtor(&ring);
+        return false;
+    }
+
+    loader->stats.used_uring = true;
+
+    ShardRead* reads = (ShardRead*) calloc(depth, sizeof(*reads));
+    size_t* free_reads = (size_t*) calloc(depth, sizeof(*free_reads));
+    size_t free_count = 0;
+
+    for (size_t read_id = 0; reads && free_reads && read_id < depth; ++read_id) {
+        if (!ShardRead_ctor(&reads[read_id], loader->config->read_size)) break;
+        free_reads[free_count++] = read_id;
+    }
+
+    if (free_count < depth) ShardLoader_fail(loader, ENOMEM);
+
+    unsigned in_flight = 0;
+    unsigned queued = 0;
+
+    for (;;) {
+        while (!loader->error && free_count > 0 && ShardLoader_next(loader, &reads[free_reads[free_count - 1]])) {
+            size_t read_id = free_reads[--free_count];
+            ShardRing_queue(&ring, &reads[read_id], loader->files[reads[read_id].file_id].fd, read_id);
+            ++queued;
+            ++in_flight;
+        }
+
+        //* After a failure the reads the kernel has not taken yet are dropped, the rest are waited for.
+        if (in_flight == queued && (queued == 0 || loader->error)) break;
+
+        unsigned submit_count = loader->error ? 0 : queued;
+        int submitted = ShardRing_enter(&ring, submit_count, 1);
+        if (submitted < 0) {
+            ShardLoader_fail(loader, errno);
+            if (submit_count == 0) break;
+            continue;
+        }
+        queued -= (unsigned) submitted;
+
+        unsigned head = *ring.cq_head;
+        unsigned tail = __atomic_load_n(ring.cq_tail, __ATOMIC_ACQUIRE);
+
+        for (; head != tail; ++head) {
+            const io_uring_cqe* cqe = &ring.cqes[head & *ring.cq_mask];
+            size_t read_id = (size_t) cqe->user_data;
+            ShardRead* read = &reads[read_id];
+            --in_flight;
+
+            //* Reads of regular files are rarely short, but the rest of a short one is read again.
+            if (cqe->res > 0) read->done += (size_t) cqe->res;
+            else ShardLoader_fail(loader, cqe->res < 0 ? -cqe->res : EIO);
+
+            if (cqe->res > 0 && read->done < read->size && !loader->error) {
+                ShardRing_queue(&ring, read, loader->files[read->file_id].fd, read_id);
+                ++queued;
+                ++in_flight;
+                continue;
+            }
+
+            if (read->done == read->size) ShardLoader_finish(loader, read);
+            free_reads[free_count++] = read_id;
+        }
+
+        __atomic_store_n(ring.cq_head, head, __ATOMIC_RELEASE);
+    }
+
+    //* Closing the ring does not stop reads the kernel still runs, so their buffers are leaked if waiting failed.
+    bool reads_in_flight = in_flight > queued;
+
+    ShardRing_dtor(&ring);
+
+    if (!reads_in_flight) {
+        for (size_t read_id = 0; reads && read_id < depth; ++read_id) ShardRead_dtor(&reads[read_id]);
+        free(reads);
+    }
+    free(free_reads);
+
+    return true;
+}
+
+//* THREAD POOL ==============================
+
+static void* ShardLoader_worker(void* loader_ptr) {
+    ShardLoader* loader = (ShardLoader*) loader_ptr;
+
+    ShardRead read = {};
+    if (!ShardRead_ctor(&read, loader->config->read_size)) {
+        pthread_mutex_lock(&loader->lock);
+        ShardLoader_fail(loader, ENOMEM);
+        pthread_mutex_unlock(&loader->lock);
+
+        ShardRead_dtor(&read);
+        return NULL;
+    }
+
+    for (;;) {
+        pthread_mutex_lock(&loader->lock);
+        bool has_read = !loader->error && ShardLoader_next(loader, &read);
+        //* The file stays open until this read is consumed.
+        int fd = has_read ? loader->files[read.file_id].fd : -1;
+        pthread_mutex_unlock(&loader->lock);
+
+        if (!has_read) break;
+
+        {
+            TRACE_SPAN_ID("shard_pread", read.file_id);
+
+            while (read.done < read.size) {
+                ssize_t read_size = pread(fd, read.words + read.done, read.size - read.done, (off_t) (read.offset + read.done));
+                if (read_size <= 0) break;
+                read.done += (size_t) read_size;
+            }
+        }
+
+        if (read.done == read.size) {
+            ShardLoader_finish(loader, &read);
+        } else {
+            pthread_mutex_lock(&loader->lock);
+            ShardLoader_fail(loader, EIO);
+            pthread_mutex_unlock(&loader->lock);
+        }
+    }
+
+    ShardRead_dtor(&read);
+    return NULL;
+}
+
+/**
+ * @brief Read all files with the pool of threads
+ *
+ * @param loader loader state
+ */
+static void ShardLoader_pool(ShardLoader* loader) {
+    size_t thread_count = loader->config->thread_count;
+    if (thread_count == 0) {
+        long processor_count = sysconf(_SC_NPROCESSORS_ONLN);
+        thread_count = processor_count > 0 ? (size_t) processor_count : 1;
+    }
+
+    pthread_t* threads = (pthread_t*) calloc(thread_count, sizeof(*threads));
+    bool* started = (bool*) calloc(thread_count, sizeof(*started));
+
+    //* The calling thread is one of the workers, so reading goes on even if no thread could be started.
+    for (size_t thread_id = 1; threads && started && thread_id < thread_count; ++thread_id) {
+        started[thread_id] = pthread_create(&threads[thread_id], NULL, ShardLoader_worker, loader) == 0;
+    }
+
+    ShardLoader_worker(loader);
+
+    for (size_t thread_id = 1; threads && started && thread_id < thread_count; ++thread_id) {
+        if (started[thread_id]) pthread_join(threads[thread_id], NULL);
+    }
+
+    free(threads);
+    free(started);
+}
+
+//* INTERFACE ==============================
+
+int load_shards(const char* const* file_names, size_t file_count, const ShardLoaderConfig* config,
+                word_batch_fn_t* consumer, void* context, ShardLoaderStats* stats, err_anchor_t err_code) {
+    _LOG_FAIL_CHECK_(file_names && file_count > 0 && config && config->hash && consumer, "error", ERROR_REPORTS, return -1, err_code, EINVAL);
+    _LOG_FAIL_CHECK_(config->read_size > 0 && config->read_size % MAX_WORD_LENGTH == 0 && config->queue_depth > 0,
+        "error", ERROR_REPORTS, return -1, err_code, EINVAL);
+
+    ShardLoader loader = {};
+    loader.file_names = file_names;
+    loader.file_count = file_count;
+    loader.config = config;
+    loader.consumer = consumer;
+    loader.context = context;
+
+    loader.files = (ShardFile*) calloc(file_count, sizeof(*loader.files));
+    _LOG_FAIL_CHECK_(loader.files, "error", ERROR_REPORTS, return -1, err_code, ENOMEM);
+
+    for (size_t file_id = 0; file_id < file_count; ++file_id) loader.files[file_id] = {};
+
+    if (!config->use_uring || !ShardLoader_uring(&loader)) {
+        log_printf(STATUS_REPORTS, "status", "Reading %lu files with the thread pool.\n", file_count);
+        ShardLoader_pool(&loader);
+    }
+
+    for (size_t file_id = 0; file_id < file_count; ++file_id) {
+        if (loader.files[file_id].fd != -1) close(loader.files[file_id].fd);
+    }
+
+    free(loader.files);
+    pthread_mutex_destroy(&loader.lock);
+    pthread_mutex_destroy(&loader.consumer_lock);
+
+    if (stats) *stats = loader.stats;
+
+    _LOG_FAIL_CHECK_(loader.error == 0, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Reading shard files failed: %s.\n", strerror(loader.error));
+        return -1;
+    }, err_code, loader.error);
+
+    return 0;
+}
+
+//* FILE LISTS ==============================
+
+static int compare_file_names(const void* alpha, const void* beta) {
+    return strcmp(*(char* const*) alpha, *(char* const*) beta);
+}
+
+size_t list_shard_files(const char* directory, char*** file_names_ptr, err_anchor_t err_code) {
+    _LOG_FAIL_CHECK_(directory && file_names_ptr, "error", ERROR_REPORTS, return 0, err_code, EINVAL);
+
+    DIR* dir = opendir(directory);
+    _LOG_FAIL_CHECK_(dir, "error", ERROR_REPORTS, return 0, err_code, ENOENT);
+
+    char** file_names = NULL;
+    size_t file_count = 0;
+    size_t capacity = 0;
+    bool allocated = true;
+
+    for (const dirent* entry = readdir(dir); entry && allocated; entry = readdir(dir)) {
+        size_t name_size = strlen(directory) + strlen(entry->d_name) + 2;
+        char* name = (char*) calloc(name_size, sizeof(*name));
+        allocated = name;
+        if (!name) break;
+
+        snprintf(name, name_size, "%s/%s", directory, entry->d_name);
+
+        struct stat st = {};
+        if (stat(name, &st) != 0 || !S_ISREG(st.st_mode)) {
+            free(name);
+            continue;
+        }
+
+        if (file_count == capacity) {
+            capacity = capacity ? capacity * 2 : 16;
+            char** new_names = (char**) realloc(file_names, capacity * sizeof(*file_names));
+            allocated = new_names;
+            if (!new_names) {
+                free(name);
+                break;
+            }
+            file_names = new_names;
+        }
+
+        file_names[file_count++] = name;
+    }
+
+    closedir(dir);
+
+    _LOG_FAIL_CHECK_(allocated, "error", ERROR_REPORTS, {
+        free_shard_files(file_names, file_count);
+        return 0;
+    }, err_code, ENOMEM);
+
+    _LOG_FAIL_CHECK_(file_count > 0, "error", ERROR_REPORTS, return 0, err_code, ENOENT);
+
+    qsort(file_names, file_count, sizeof(*file_names), compare_file_names);
+
+    *file_names_ptr = file_names;
+
+    return file_count;
+}
+
+void free_shard_files(char** file_names, size_t file_count) {
+    for (size_t file_id = 0; file_names && file_id < file_count; ++file_id) free(file_names[file_id]);
+    free(file_names);
+}
@@ -0,0 +1,93 @@
+/**
+ * @file shard_loader.h
+ * @author Kudryashov Ilya (kudriashov.it@phystech.edu)
+ * @brief Concurrent loader of word lists split into many shard files.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef SHARD_LOADER_H
+#define SHARD_LOADER_H
+
+#include <stddef.h>
+
+#include "lib/util/dbg/debug.h"
+#include "src/hash/hash.h"
+#include "src/utils/config.h"
+
+#include "word_stream.h"
+
+/**
+ * @brief Parameters of the shard loader.
+ *
+ * @param read_size number of bytes read at once (multiple of MAX_WORD_LENGTH)
+ * @param queue_depth number of reads in flight
+ * @param thread_count number of reading threads if io_uring is not available (0 to use every online processor)
+ * @param use_uring false to read with the thread pool even if io_uring is available
+ * @param hash hash function applied to every word
+ */
+struct ShardLoaderConfig {
+    size_t read_size = SHARD_READ_SIZE;
+    unsigned queue_depth = SHARD_QUEUE_DEPTH;
+    unsigned thread_count = 0;
+    bool use_uring = true;
+    hash_fn_t* hash = NULL;
+};
+
+/**
+ * @brief Results of the shard loader.
+ *
+ * @param file_count number of files read
+ * @param word_count number of words passed to the consumer
+ * @param bytes_read number of bytes read
+ * @param used_uring true if the files were read through io_uring
+ */
+struct ShardLoaderStats {
+    size_t file_count = 0;
+    size_t word_count = 0;
+    size_t bytes_read = 0;
+    bool used_uring = false;
+};
+
+/**
+ * @brief List regular files of the directory in the order of their names
+ *
+ * @param directory name of the directory
+ * @param file_names_ptr variable to store the array of file names to (should be freed with free_shard_files())
+ * @param err_code variable to use as errno
+ * @return number of files (0 if failed)
+ */
+size_t list_shard_files(const char* directory, char*** file_names_ptr, ERROR_MARKER);
+
+/**
+ * @brief Free the list of file names made by list_shard_files()
+ *
+ * @param file_names file names
+ * @param file_count number of file names
+ */
+void free_shard_files(char** file_names, size_t file_count);
+
+/**
+ * @brief Read word list files with many reads in flight and pass every completed read to the consumer.
+ *
+ * Reads are submitted through io_uring (raw system calls, no liburing) and completed buffers are hashed and consumed
+ * in the calling thread. If io_uring is not available, a pool of threads reads the files with pread()
+ * and hashes the words, and the consumer is called by one thread at a time.
+ * Buffers complete in arbitrary order, so words of different reads reach the consumer in arbitrary order.
+ *
+ * @param file_names names of the files (in the format of read_words())
+ * @param file_count number of files
+ * @param config loader parameters
+ * @param consumer function to pass every read to
+ * @param context first argument of the consumer
+ * @param stats variable to store the results to (can be NULL)
+ * @param err_code variable to use as errno
+ * @return 0 if every file was read, -1 otherwise
+ */
+int load_shards(const char* const* file_names, size_t file_count, const ShardLoaderConfig* config,
+                word_batch_fn_t* consumer, void* context, ShardLoaderStats* stats, ERROR_MARKER);
+
+#endif
@@ -3,10 +3,17 @@
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <unistd.h>
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
 
+#include "lib/util/dbg/trace.h"
 #include "src/utils/config.h"
 
 size_t read_words(const char* file_name, const char** buffer_ptr) {
+    TRACE_SPAN("read_words");
+
     int fd = open(file_name, O_RDONLY);
 
     _LOG_FAIL_CHECK_(fd != -1, "error", ERROR_REPORTS, return 0, NULL, ENOENT);
@@ -14,9 +21,77 @@ size_t read_words(const char* file_name, const char** buffer_ptr) {
     struct stat st = {};
     fstat(fd, &st);
 
-    _LOG_FAIL_CHECK_(st.st_size % MAX_WORD_LENGTH == 0, "error", ERROR_REPORTS, return 0, NULL, EINVAL);
+    _LOG_FAIL_CHECK_(st.st_size % MAX_WORD_LENGTH == 0, "error", ERROR_REPORTS, { close(fd); return 0; }, NULL, EINVAL);
+
+    //* The whole list is searched at random right away, so it is read in advance.
+    const char* words = (const char*) mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+    close(fd);
 
-    *buffer_ptr = (const char*) mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    _LOG_FAIL_CHECK_(words != MAP_FAILED, "error", ERROR_REPORTS, return 0, NULL, ENOMEM);
+
+    *buffer_ptr = words;
 
     return (size_t) st.st_size / (size_t) MAX_WORD_LENGTH;
 }
+
+size_t padded_token_length(size_t length) {
+    return (length / TOKEN_ALIGNMENT + 1) * TOKEN_ALIGNMENT;
+}
+
+size_t read_tokens(const char* file_name, StringKey** keys_ptr) {
+    TRACE_SPAN("read_tokens");
+
+    int fd = open(file_name, O_RDONLY);
+
+    _LOG_FAIL_CHECK_(fd != -1, "error", ERROR_REPORTS, return 0, NULL, ENOENT);
+
+    struct stat st = {};
+    fstat(fd, &st);
+    size_t file_size = (size_t) st.st_size;
+
+    _LOG_FAIL_CHECK_(file_size > 0, "error", ERROR_REPORTS, { close(fd); return 0; }, NULL, EINVAL);
+
+    const char* text = (const char*) mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    _LOG_FAIL_CHECK_(text != MAP_FAILED, "error", ERROR_REPORTS, return 0, NULL, ENOMEM);
+
+    size_t token_count = 0;
+    size_t storage_size = 0;
+
+    for (size_t id = 0; id < file_size;) {
+        while (id < file_size && isspace((unsigned char) text[id])) ++id;
+        if (id == file_size) break;
+
+        size_t start = id;
+        while (id < file_size && !isspace((unsigned char) text[id])) ++id;
+
+        ++token_count;
+        storage_size += padded_token_length(id - start);
+    }
+
+    //* Key array and token storage share one allocation, the storage starts aligned as sizeof(StringKey) is.
+    StringKey* keys = (StringKey*) calloc(token_count * sizeof(*keys) + storage_size, 1);
+    _LOG_FAIL_CHECK_(keys, "error", ERROR_REPORTS, { munmap((void*) text, file_size); return 0; }, NULL, ENOMEM);
+
+    char* storage = (char*) (keys + token_count);
+    size_t token_id = 0;
+
+    for (size_t id = 0; id < file_size;) {
+        while (id < file_size && isspace((unsigned char) text[id])) ++id;
+        if (id == file_size) break;
+
+        size_t start = id;
+        while (id < file_size && !isspace((unsigned char) text[id])) ++id;
+
+        memcpy(storage, text + start, id - start);
+        keys[token_id++] = { .begin = storage, .length = id - start };
+        storage += padded_token_length(id - start);
+    }
+
+    munmap((void*) text, file_size);
+
+    *keys_ptr = keys;
+
+    return token_count;
+}
@@ -12,8 +12,21 @@
 #ifndef TEXT_PARSER_H
 #define TEXT_PARSER_H
 
+#include <stddef.h>
+
 #include "lib/util/dbg/debug.h"
 
+/**
+ * @brief Key of arbitrary length.
+ * 
+ * @param begin first byte of the key, followed by zero padding up to TOKEN_ALIGNMENT bytes
+ * @param length length of the key without padding
+ */
+struct StringKey {
+    const char* begin = NULL;
+    size_t length = 0;
+};
+
 /**
  * @brief Read word list from file
  * 
@@ -23,4 +36,24 @@
  */
 size_t read_words(const char* file_name, const char** buffer_ptr);
 
+/**
+ * @brief Split text file into whitespace-separated tokens of arbitrary length
+ * 
+ * Tokens are copied next to the returned key array and padded with zeros to TOKEN_ALIGNMENT bytes,
+ * so that hash functions reading whole words never reach bytes of the neighbouring tokens.
+ * 
+ * @param file_name name of the file to read
+ * @param keys_ptr variable to store the key array to (should be freed by the caller)
+ * @return number of tokens read (0 if failed)
+ */
+size_t read_tokens(const char* file_name, StringKey** keys_ptr);
+
+/**
+ * @brief Get the number of bytes the token takes in the padded token storage
+ * 
+ * @param length length of the token
+ * @return padded length (always greater than the length, so that every token is zero-terminated)
+ */
+size_t padded_token_length(size_t length);
+
 #endif
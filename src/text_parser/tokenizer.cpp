@@ -0,0 +1,353 @@
+#include "tokenizer.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <x86intrin.h>
+
+#include "lib/util/dbg/trace.h"
+#include "src/utils/config.h"
+
+static const size_t TOKENIZER_BLOCK_SIZE = sizeof(__m256i);
+
+static_assert(MAX_WORD_LENGTH == sizeof(__m256i), "Fixed-width words are written with a single vector store.");
+
+enum TOKENIZER_PASS {
+    TOKENIZER_COUNT,
+    TOKENIZER_EMIT_WORDS,
+    TOKENIZER_EMIT_TOKENS,
+};
+
+/**
+ * @brief Part of the text processed by one thread.
+ *
+ * @param text the whole text
+ * @param text_size size of the text
+ * @param begin offset of the first byte of the chunk (chunks never split words)
+ * @param end offset of the byte after the chunk
+ * @param pass what to do with the found words
+ * @param word_count number of words found (written) by the pass
+ * @param storage_size number of bytes the words of the chunk take in the padded token storage
+ * @param words where to write the words of the chunk in the read_words() format
+ * @param keys where to write the keys of the chunk in the read_tokens() format
+ * @param storage where to write the padded tokens of the chunk
+ * @param thread thread processing the chunk
+ */
+struct TokenizerChunk {
+    const char* text = NULL;
+    size_t text_size = 0;
+    size_t begin = 0;
+    size_t end = 0;
+    TOKENIZER_PASS pass = TOKENIZER_COUNT;
+    size_t word_count = 0;
+    size_t storage_size = 0;
+    char* words = NULL;
+    StringKey* keys = NULL;
+    char* storage = NULL;
+    pthread_t thread = {};
+};
+
+static inline bool is_word_byte(char symbol) {
+    unsigned char lower = (unsigned char) (symbol | 0x20);
+    return ('a' <= lower && lower <= 'z') || (unsigned char) symbol >= 0x80;
+}
+
+/**
+ * @brief Load 32 bytes of the text, filling bytes past its end with zeros
+ */
+static inline __m256i load_text_block(const char* text, size_t text_size, size_t position) {
+    if (position + TOKENIZER_BLOCK_SIZE <= text_size) return _mm256_loadu_si256((const __m256i*) (text + position));
+
+    char tail[TOKENIZER_BLOCK_SIZE] = {};
+    memcpy(tail, text + position, text_size - position);
+    return _mm256_loadu_si256((const __m256i*) tail);
+}
+
+/**
+ * @brief Get mask of the bytes of the block that belong to words
+ */
+static inline uint32_t word_byte_mask(__m256i block) {
+    __m256i lower = _mm256_or_si256(block, _mm256_set1_epi8(0x20));
+    __m256i is_letter = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)),
+                                         _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), lower));
+
+    //* Sign bits of the block itself mark bytes of multibyte UTF-8 characters.
+    return (uint32_t) _mm256_movemask_epi8(_mm256_or_si256(is_letter, block));
+}
+
+static inline __m256i lowercase_block(__m256i block) {
+    __m256i is_upper = _mm256_and_si256(_mm256_cmpgt_epi8(block, _mm256_set1_epi8('A' - 1)),
+                                        _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), block));
+    return _mm256_or_si256(block, _mm256_and_si256(is_upper, _mm256_set1_epi8(0x20)));
+}
+
+static inline char lowercase_char(char symbol) {
+    return 'A' <= symbol && symbol <= 'Z' ? (char) (symbol | 0x20) : symbol;
+}
+
+/**
+ * @brief Count or write the word of the chunk
+ *
+ * @param chunk chunk the word belongs to
+ * @param start offset of the word in the text
+ * @param length length of the word
+ */
+static void TokenizerChunk_add(TokenizerChunk* chunk, size_t start, size_t length) {
+    switch (chunk->pass) {
+        case TOKENIZER_COUNT: {
+            chunk->storage_size += padded_token_length(length);
+            break;
+        }
+        case TOKENIZER_EMIT_WORDS: {
+            if (length > MAX_WORD_LENGTH - 1) length = MAX_WORD_LENGTH - 1;
+
+            const __m256i byte_ids = _mm256_setr_epi8( 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15,
+                                                      16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31);
+            __m256i inside = _mm256_cmpgt_epi8(_mm256_set1_epi8((char) length), byte_ids);
+            __m256i word = lowercase_block(load_text_block(chunk->text, chunk->text_size, start));
+
+            _mm256_store_si256((__m256i*) (chunk->words + chunk->word_count * MAX_WORD_LENGTH), _mm256_and_si256(word, inside));
+            break;
+        }
+        case TOKENIZER_EMIT_TOKENS: {
+            size_t offset = 0;
+            for (; offset + TOKENIZER_BLOCK_SIZE <= length; offset += TOKENIZER_BLOCK_SIZE) {
+                __m256i block = lowercase_block(_mm256_loadu_si256((const __m256i*) (chunk->text + start + offset)));
+                _mm256_storeu_si256((__m256i*) (chunk->storage + offset), block);
+            }
+            for (; offset < length; ++offset) chunk->storage[offset] = lowercase_char(chunk->text[start + offset]);
+
+            chunk->keys[chunk->word_count] = { .begin = chunk->storage, .length = length };
+            chunk->storage += padded_token_length(length);
+            break;
+        }
+        default: break;
+    }
+
+    ++chunk->word_count;
+}
+
+/**
+ * @brief Find words of the chunk, classifying 32 bytes at once
+ *
+ * @param chunk_ptr pointer to the chunk
+ * @return NULL
+ */
+static void* TokenizerChunk_scan(void* chunk_ptr) {
+    TokenizerChunk* chunk = (TokenizerChunk*) chunk_ptr;
+
+    TRACE_SPAN(chunk->pass == TOKENIZER_COUNT ? "tokenize_count" : "tokenize_emit");
+
+    bool in_word = false;
+    size_t word_start = 0;
+    uint32_t carry = 0;
+
+    for (size_t position = chunk->begin; position < chunk->end; position += TOKENIZER_BLOCK_SIZE) {
+        uint32_t mask = word_byte_mask(load_text_block(chunk->text, chunk->text_size, position));
+        if (chunk->end - position < TOKENIZER_BLOCK_SIZE) mask &= (1u << (chunk->end - position)) - 1;
+
+        //* Bits where the mask differs from the previous byte mark starts and ends of the words in turn.
+        uint32_t borders = mask ^ ((mask << 1) | carry);
+        carry = mask >> (TOKENIZER_BLOCK_SIZE - 1);
+
+        for (; borders; borders &= borders - 1) {
+            size_t border = position + (size_t) __builtin_ctz(borders);
+
+            if (in_word) TokenizerChunk_add(chunk, word_start, border - word_start);
+            else word_start = border;
+
+            in_word = !in_word;
+        }
+    }
+
+    if (in_word) TokenizerChunk_add(chunk, word_start, chunk->end - word_start);
+
+    return NULL;
+}
+
+/**
+ * @brief Run the same pass over all chunks, each in its own thread
+ *
+ * @param chunks chunk array
+ * @param chunk_count number of chunks
+ * @param pass pass to run
+ */
+static void run_pass(TokenizerChunk* chunks, size_t chunk_count, TOKENIZER_PASS pass) {
+    for (size_t chunk_id = 0; chunk_id < chunk_count; ++chunk_id) {
+        chunks[chunk_id].pass = pass;
+        chunks[chunk_id].word_count = 0;
+    }
+
+    //* The calling thread takes the first chunk, chunks whose thread could not be started are processed by it afterwards.
+    bool* started = (bool*) calloc(chunk_count, sizeof(*started));
+
+    for (size_t chunk_id = 1; started && chunk_id < chunk_count; ++chunk_id) {
+        started[chunk_id] = pthread_create(&chunks[chunk_id].thread, NULL, TokenizerChunk_scan, chunks + chunk_id) == 0;
+    }
+
+    for (size_t chunk_id = 0; chunk_id < chunk_count; ++chunk_id) {
+        if (started && started[chunk_id]) pthread_join(chunks[chunk_id].thread, NULL);
+        else TokenizerChunk_scan(chunks + chunk_id);
+    }
+
+    free(started);
+}
+
+/**
+ * @brief Split the text into chunks so that no word crosses their borders
+ *
+ * @param text text to split
+ * @param text_size size of the text
+ * @param thread_count requested number of threads (0 to use every online processor)
+ * @param chunk_count_ptr variable to store the number of chunks to
+ * @return chunk array (NULL if failed)
+ */
+static TokenizerChunk* split_text(const char* text, size_t text_size, unsigned thread_count, size_t* chunk_count_ptr) {
+    size_t chunk_count = thread_count;
+    if (chunk_count == 0) {
+        long processor_count = sysconf(_SC_NPROCESSORS_ONLN);
+        chunk_count = processor_count > 0 ? (size_t) processor_count : 1;
+    }
+
+    size_t max_chunk_count = text_size / TOKENIZER_MIN_CHUNK_SIZE + 1;
+    if (chunk_count > max_chunk_count) chunk_count = max_chunk_count;
+
+    TokenizerChunk* chunks = (TokenizerChunk*) calloc(chunk_count, sizeof(*chunks));
+    if (!chunks) return NULL;
+
+    size_t border = 0;
+    for (size_t chunk_id = 0; chunk_id < chunk_count; ++chunk_id) {
+        chunks[chunk_id] = {};
+        chunks[chunk_id].text = text;
+        chunks[chunk_id].text_size = text_size;
+        chunks[chunk_id].begin = border;
+
+        border = chunk_id + 1 == chunk_count ? text_size : text_size / chunk_count * (chunk_id + 1);
+        if (border < chunks[chunk_id].begin) border = chunks[chunk_id].begin;
+        while (0 < border && border < text_size && is_word_byte(text[border - 1]) && is_word_byte(text[border])) ++border;
+
+        chunks[chunk_id].end = border;
+    }
+
+    *chunk_count_ptr = chunk_count;
+    return chunks;
+}
+
+/**
+ * @brief Tokenize the text file
+ *
+ * @param file_name name of the text file
+ * @param pass format of the output, either TOKENIZER_EMIT_WORDS or TOKENIZER_EMIT_TOKENS
+ * @param thread_count number of threads (0 to use every online processor)
+ * @param result_ptr variable to store the word list or the key array to
+ * @param err_code variable to use as errno
+ * @return number of words (0 if failed)
+ */
+static size_t tokenize(const char* file_name, TOKENIZER_PASS pass, unsigned thread_count, void** result_ptr, err_anchor_t err_code) {
+    _LOG_FAIL_CHECK_(file_name && result_ptr, "error", ERROR_REPORTS, return 0, err_code, EINVAL);
+
+    int fd = open(file_name, O_RDONLY);
+    _LOG_FAIL_CHECK_(fd != -1, "error", ERROR_REPORTS, return 0, err_code, ENOENT);
+
+    struct stat st = {};
+    fstat(fd, &st);
+    size_t text_size = (size_t) st.st_size;
+
+    _LOG_FAIL_CHECK_(text_size > 0, "error", ERROR_REPORTS, { close(fd); return 0; }, err_code, EINVAL);
+
+    const char* text = (const char*) mmap(NULL, text_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    _LOG_FAIL_CHECK_(text != MAP_FAILED, "error", ERROR_REPORTS, return 0, err_code, ENOMEM);
+
+    madvise((void*) text, text_size, MADV_SEQUENTIAL);
+
+    size_t chunk_count = 0;
+    TokenizerChunk* chunks = split_text(text, text_size, thread_count, &chunk_count);
+    _LOG_FAIL_CHECK_(chunks, "error", ERROR_REPORTS, { munmap((void*) text, text_size); return 0; }, err_code, ENOMEM);
+
+    log_printf(STATUS_REPORTS, "status", "Tokenizing %lu bytes of %s in %lu threads.\n", text_size, file_name, chunk_count);
+
+    run_pass(chunks, chunk_count, TOKENIZER_COUNT);
+
+    size_t word_count = 0;
+    size_t storage_size = 0;
+    for (size_t chunk_id = 0; chunk_id < chunk_count; ++chunk_id) {
+        word_count += chunks[chunk_id].word_count;
+        storage_size += chunks[chunk_id].storage_size;
+    }
+
+    void* result = NULL;
+    if (word_count > 0 && pass == TOKENIZER_EMIT_WORDS) {
+        result = aligned_alloc(MAX_WORD_LENGTH, word_count * MAX_WORD_LENGTH);
+    } else if (word_count > 0) {
+        //* Key array and token storage share one allocation, the same layout as in read_tokens().
+        result = calloc(word_count * sizeof(StringKey) + storage_size, 1);
+    }
+
+    _LOG_FAIL_CHECK_(result, "error", ERROR_REPORTS, {
+        log_printf(ERROR_REPORTS, "error", "Failed to store %lu words of %s.\n", word_count, file_name);
+        free(chunks);
+        munmap((void*) text, text_size);
+        return 0;
+    }, err_code, word_count ? ENOMEM : ENOENT);
+
+    char* words = (char*) result;
+    StringKey* keys = (StringKey*) result;
+    char* storage = (char*) (keys + word_count);
+
+    for (size_t chunk_id = 0; chunk_id < chunk_count; ++chunk_id) {
+        chunks[chunk_id].words = words;
+        chunks[chunk_id].keys = keys;
+        chunks[chunk_id].storage = storage;
+
+        words += chunks[chunk_id].word_count * MAX_WORD_LENGTH;
+        keys += chunks[chunk_id].word_count;
+        storage += chunks[chunk_id].storage_size;
+    }
+
+    run_pass(chunks, chunk_count, pass);
+
+    free(chunks);
+    munmap((void*) text, text_size);
+
+    *result_ptr = result;
+
+    return word_count;
+}
+
+size_t tokenize_words(const char* file_name, const char** buffer_ptr, unsigned thread_count, err_anchor_t err_code) {
+    void* words = NULL;
+    size_t word_count = tokenize(file_name, TOKENIZER_EMIT_WORDS, thread_count, &words, err_code);
+
+    *buffer_ptr = (const char*) words;
+    return word_count;
+}
+
+size_t tokenize_tokens(const char* file_name, StringKey** keys_ptr, unsigned thread_count, err_anchor_t err_code) {
+    void* keys = NULL;
+    size_t key_count = tokenize(file_name, TOKENIZER_EMIT_TOKENS, thread_count, &keys, err_code);
+
+    *keys_ptr = (StringKey*) keys;
+    return key_count;
+}
+
+int write_words(const char* file_name, const char* words, size_t word_count, err_anchor_t err_code) {
+    _LOG_FAIL_CHECK_(file_name && words, "error", ERROR_REPORTS, return -1, err_code, EINVAL);
+
+    FILE* file = fopen(file_name, "wb");
+    _LOG_FAIL_CHECK_(file, "error", ERROR_REPORTS, return -1, err_code, ENOENT);
+
+    size_t written = fwrite(words, MAX_WORD_LENGTH, word_count, file);
+    fclose(file);
+
+    _LOG_FAIL_CHECK_(written == word_count, "error", ERROR_REPORTS, return -1, err_code, EIO);
+
+    return 0;
+}
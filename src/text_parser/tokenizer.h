@@ -0,0 +1,58 @@
+/**
+ * @file tokenizer.h
+ * @author Kudryashov Ilya (kudriashov.it@phystech.edu)
+ * @brief Parallel SIMD tokenizer turning raw text into word lists.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef TOKENIZER_H
+#define TOKENIZER_H
+
+#include <stddef.h>
+
+#include "lib/util/dbg/debug.h"
+#include "text_parser.h"
+
+//* Words are runs of latin letters and bytes of multibyte UTF-8 characters (the same rule as in assets/formatter.py),
+//* latin letters are lowercased, all other bytes separate words.
+
+/**
+ * @brief Split text file into lowercase words in the format of read_words()
+ *
+ * Words are cut to MAX_WORD_LENGTH - 1 bytes and padded with zeros to MAX_WORD_LENGTH bytes.
+ *
+ * @param file_name name of the text file
+ * @param buffer_ptr variable to store the aligned word list to (should be freed by the caller)
+ * @param thread_count number of threads to split the text between (0 to use every online processor)
+ * @param err_code variable to use as errno
+ * @return number of words (0 if failed)
+ */
+size_t tokenize_words(const char* file_name, const char** buffer_ptr, unsigned thread_count, ERROR_MARKER);
+
+/**
+ * @brief Split text file into lowercase words of arbitrary length in the format of read_tokens()
+ *
+ * @param file_name name of the text file
+ * @param keys_ptr variable to store the key array to (should be freed by the caller)
+ * @param thread_count number of threads to split the text between (0 to use every online processor)
+ * @param err_code variable to use as errno
+ * @return number of words (0 if failed)
+ */
+size_t tokenize_tokens(const char* file_name, StringKey** keys_ptr, unsigned thread_count, ERROR_MARKER);
+
+/**
+ * @brief Write word list in the format of read_words() to the file
+ *
+ * @param file_name name of the file to write to
+ * @param words word list
+ * @param word_count number of words in the list
+ * @param err_code variable to use as errno
+ * @return 0 if the list was written, -1 otherwise
+ */
+int write_words(const char* file_name, const char* words, size_t word_count, ERROR_MARKER);
+
+#endif
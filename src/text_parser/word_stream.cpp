@@ -0,0 +1,262 @@
+#include "word_stream.h"
+
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lib/util/dbg/trace.h"
+
+enum STREAM_WINDOW_STATE {
+    WINDOW_FREE,
+    WINDOW_READ,
+    WINDOW_HASHED,
+};
+
+/**
+ * @brief Window of words passed between the pipeline stages.
+ *
+ * @param words words of the window
+ * @param hashes hashes of the words
+ * @param word_count number of words in the window
+ * @param last true if the window is the last one of the file
+ * @param state stage the window is ready for
+ */
+struct StreamWindow {
+    char* words = NULL;
+    hash_t* hashes = NULL;
+    size_t word_count = 0;
+    bool last = false;
+    STREAM_WINDOW_STATE state = WINDOW_FREE;
+};
+
+/**
+ * @brief State of the streaming pipeline.
+ *
+ * @param fd descriptor of the file
+ * @param file_size size of the file
+ * @param window_words number of words in a full window
+ * @param windows ring of windows
+ * @param window_count number of windows in the ring
+ * @param hash hash function
+ * @param failed true if the file could not be read
+ * @param lock mutex guarding window states
+ * @param changed condition signalled on every change of window state
+ */
+struct WordStream {
+    int fd = -1;
+    size_t file_size = 0;
+    size_t window_words = 0;
+    StreamWindow* windows = NULL;
+    size_t window_count = 0;
+    hash_fn_t* hash = NULL;
+    bool failed = false;
+    pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+    pthread_cond_t changed = PTHREAD_COND_INITIALIZER;
+};
+
+/**
+ * @brief Wait until the window is ready for the stage
+ *
+ * @param stream pipeline state
+ * @param window_id sequential number of the window in the file
+ * @param state state the stage expects
+ * @return pointer to the window
+ */
+static StreamWindow* WordStream_wait(WordStream* stream, size_t window_id, STREAM_WINDOW_STATE state) {
+    StreamWindow* window = &stream->windows[window_id % stream->window_count];
+
+    pthread_mutex_lock(&stream->lock);
+    while (window->state != state) pthread_cond_wait(&stream->changed, &stream->lock);
+    pthread_mutex_unlock(&stream->lock);
+
+    return window;
+}
+
+/**
+ * @brief Pass the window to the next stage
+ */
+static void WordStream_pass(WordStream* stream, StreamWindow* window, STREAM_WINDOW_STATE state) {
+    pthread_mutex_lock(&stream->lock);
+    window->state = state;
+    pthread_cond_broadcast(&stream->changed);
+    pthread_mutex_unlock(&stream->lock);
+}
+
+/**
+ * @brief Read the window and drop its pages from the page cache
+ *
+ * @param stream pipeline state
+ * @param window window to read to
+ * @param window_id sequential number of the window in the file
+ */
+static void WordStream_read(WordStream* stream, StreamWindow* window, size_t window_id) {
+    TRACE_SPAN_ID("stream_read", window_id);
+
+    size_t offset = window_id * stream->window_words * MAX_WORD_LENGTH;
+    size_t size = offset < stream->file_size ? stream->file_size - offset : 0;
+    if (size > stream->window_words * MAX_WORD_LENGTH) size = stream->window_words * MAX_WORD_LENGTH;
+
+    size_t done = 0;
+    while (done < size) {
+        ssize_t read_size = pread(stream->fd, window->words + done, size - done, (off_t) (offset + done));
+        if (read_size <= 0) break;
+        done += (size_t) read_size;
+    }
+
+    //* Failed window ends the stream, so that all stages stop.
+    if (done < size) stream->failed = true;
+
+    posix_fadvise(stream->fd, (off_t) offset, (off_t) size, POSIX_FADV_DONTNEED);
+
+    window->word_count = stream->failed ? 0 : size / MAX_WORD_LENGTH;
+    window->last = stream->failed || offset + size >= stream->file_size;
+}
+
+static void WordStream_hash(WordStream* stream, StreamWindow* window) {
+    TRACE_SPAN("stream_hash");
+
+    for (size_t word_id = 0; word_id < window->word_count; ++word_id) {
+        const char* word = window->words + word_id * MAX_WORD_LENGTH;
+        window->hashes[word_id] = stream->hash(word, word + MAX_WORD_LENGTH);
+    }
+}
+
+static void* WordStream_reader(void* stream_ptr) {
+    WordStream* stream = (WordStream*) stream_ptr;
+
+    for (size_t window_id = 0;; ++window_id) {
+        StreamWindow* window = WordStream_wait(stream, window_id, WINDOW_FREE);
+
+        WordStream_read(stream, window, window_id);
+
+        //* Once passed, the window may be refilled by the other stages.
+        bool last = window->last;
+        WordStream_pass(stream, window, WINDOW_READ);
+
+        if (last) return NULL;
+    }
+}
+
+static void* WordStream_hasher(void* stream_ptr) {
+    WordStream* stream = (WordStream*) stream_ptr;
+
+    for (size_t window_id = 0;; ++window_id) {
+        StreamWindow* window = WordStream_wait(stream, window_id, WINDOW_READ);
+
+        WordStream_hash(stream, window);
+
+        bool last = window->last;
+        WordStream_pass(stream, window, WINDOW_HASHED);
+
+        if (last) return NULL;
+    }
+}
+
+static void WordStream_dtor(WordStream* stream) {
+    for (size_t window_id = 0; stream->windows && window_id < stream->window_count; ++window_id) {
+        free(stream->windows[window_id].words);
+        free(stream->windows[window_id].hashes);
+    }
+
+    free(stream->windows);
+    stream->windows = NULL;
+
+    if (stream->fd != -1) close(stream->fd);
+    stream->fd = -1;
+
+    pthread_mutex_destroy(&stream->lock);
+    pthread_cond_destroy(&stream->changed);
+}
+
+size_t stream_words(const char* file_name, const WordStreamConfig* config, word_batch_fn_t* consumer, void* context, err_anchor_t err_code) {
+    _LOG_FAIL_CHECK_(file_name && config && config->hash && consumer, "error", ERROR_REPORTS, return 0, err_code, EINVAL);
+    _LOG_FAIL_CHECK_(config->window_size >= MAX_WORD_LENGTH && config->window_count >= 2, "error", ERROR_REPORTS, return 0, err_code, EINVAL);
+
+    WordStream stream = {};
+    stream.hash = config->hash;
+    stream.window_count = config->window_count;
+    stream.window_words = config->window_size / MAX_WORD_LENGTH;
+
+    stream.fd = open(file_name, O_RDONLY);
+    _LOG_FAIL_CHECK_(stream.fd != -1, "error", ERROR_REPORTS, return 0, err_code, ENOENT);
+
+    struct stat st = {};
+    fstat(stream.fd, &st);
+    stream.file_size = (size_t) st.st_size;
+
+    _LOG_FAIL_CHECK_(stream.file_size % MAX_WORD_LENGTH == 0, "error", ERROR_REPORTS, {
+        WordStream_dtor(&stream);
+        return 0;
+    }, err_code, EINVAL);
+
+    posix_fadvise(stream.fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    stream.windows = (StreamWindow*) calloc(stream.window_count, sizeof(*stream.windows));
+    bool allocated = stream.windows;
+
+    for (size_t window_id = 0; allocated && window_id < stream.window_count; ++window_id) {
+        StreamWindow* window = &stream.windows[window_id];
+        *window = {};
+
+        window->words = (char*) aligned_alloc(MAX_WORD_LENGTH, stream.window_words * MAX_WORD_LENGTH);
+        window->hashes = (hash_t*) calloc(stream.window_words, sizeof(*window->hashes));
+
+        allocated = window->words && window->hashes;
+    }
+
+    _LOG_FAIL_CHECK_(allocated, "error", ERROR_REPORTS, {
+        WordStream_dtor(&stream);
+        return 0;
+    }, err_code, ENOMEM);
+
+    log_printf(STATUS_REPORTS, "status", "Streaming %s in %lu windows of %lu words.\n", file_name, stream.window_count, stream.window_words);
+
+    //* Stages that could not get their own thread are run by the consumer thread.
+    pthread_t reader = {};
+    pthread_t hasher = {};
+    bool reader_started = pthread_create(&reader, NULL, WordStream_reader, &stream) == 0;
+    bool hasher_started = reader_started && pthread_create(&hasher, NULL, WordStream_hasher, &stream) == 0;
+
+    size_t word_count = 0;
+
+    for (size_t window_id = 0;; ++window_id) {
+        StreamWindow* window = &stream.windows[window_id % stream.window_count];
+
+        if (!reader_started) {
+            WordStream_read(&stream, window, window_id);
+            WordStream_pass(&stream, window, WINDOW_READ);
+        }
+
+        if (!hasher_started) {
+            WordStream_wait(&stream, window_id, WINDOW_READ);
+            WordStream_hash(&stream, window);
+            WordStream_pass(&stream, window, WINDOW_HASHED);
+        }
+
+        WordStream_wait(&stream, window_id, WINDOW_HASHED);
+
+        {
+            TRACE_SPAN_ID("stream_insert", window_id);
+            consumer(context, window->words, window->hashes, window->word_count);
+        }
+        word_count += window->word_count;
+
+        bool last = window->last;
+        WordStream_pass(&stream, window, WINDOW_FREE);
+
+        if (last) break;
+    }
+
+    if (reader_started) pthread_join(reader, NULL);
+    if (hasher_started) pthread_join(hasher, NULL);
+
+    bool failed = stream.failed;
+    WordStream_dtor(&stream);
+
+    _LOG_FAIL_CHECK_(!failed, "error", ERROR_REPORTS, return 0, err_code, EIO);
+
+    return word_count;
+}
@@ -0,0 +1,59 @@
+/**
+ * @file word_stream.h
+ * @author Kudryashov Ilya (kudriashov.it@phystech.edu)
+ * @brief Streaming reader of word lists larger than memory.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#ifndef WORD_STREAM_H
+#define WORD_STREAM_H
+
+#include <stddef.h>
+
+#include "lib/util/dbg/debug.h"
+#include "src/hash/hash.h"
+#include "src/utils/config.h"
+
+/**
+ * @brief Parameters of the streaming reader.
+ *
+ * @param window_size number of bytes read at once (rounded down to whole words)
+ * @param window_count number of windows in flight, the reader never holds more than window_count * window_size bytes of words
+ * @param hash hash function applied to every word
+ */
+struct WordStreamConfig {
+    size_t window_size = STREAM_WINDOW_SIZE;
+    size_t window_count = STREAM_WINDOW_COUNT;
+    hash_fn_t* hash = NULL;
+};
+
+/**
+ * @brief Consumer of the streamed words (words and hashes are only valid until it returns).
+ *
+ * @param context consumer data
+ * @param words words in the format of read_words()
+ * @param hashes hashes of the words
+ * @param word_count number of words
+ */
+typedef void word_batch_fn_t(void* context, const char* words, const hash_t* hashes, size_t word_count);
+
+/**
+ * @brief Pass the word list file to the consumer window by window.
+ *
+ * Reading and hashing run in their own threads, overlapping with the consumer, which runs in the calling thread.
+ * Windows are read sequentially with readahead hints, and their pages are dropped from the page cache once read.
+ *
+ * @param file_name name of the word list file (in the format of read_words())
+ * @param config reader parameters
+ * @param consumer function to pass every window of words to
+ * @param context first argument of the consumer
+ * @param err_code variable to use as errno
+ * @return number of words passed to the consumer (0 if failed)
+ */
+size_t stream_words(const char* file_name, const WordStreamConfig* config, word_batch_fn_t* consumer, void* context, ERROR_MARKER);
+
+#endif
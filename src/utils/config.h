@@ -16,16 +16,53 @@
 
 static const int NUMBER_OF_OWLS = 10;
 
+#ifdef STRING_KEYS
+static const char DEFAULT_SAMPLE_NAME[] = "comedy_of_errors.txt";
+#else
 static const char DEFAULT_SAMPLE_NAME[] = "sample.wordlist";
+#endif
 static const char OUTPUT_TABLE_NAME[] = "output.csv";
 static const char OUTPUT_TIMETABLE_NAME[] = "bmark.csv";
+static const char OUTPUT_FILTER_TABLE_NAME[] = "filter.csv";
+static const char OUTPUT_LATENCY_TABLE_NAME[] = "latency.csv";
+static const char OUTPUT_PHASES_TABLE_NAME[] = "phases.csv";
+static const char OUTPUT_MATRIX_TABLE_NAME[] = "matrix.csv";
+static const char OUTPUT_TRACE_NAME[] = "trace.json";
 
 static const unsigned MAX_WORD_LENGTH = 32;
 
+//* Arbitrary-length tokens are padded with zeros to the size of the words read by hash functions.
+static const size_t TOKEN_ALIGNMENT = 8;
+
+static const unsigned QUERY_SEED = 2027;
+
+//* Tokenizer gives every thread at least this many bytes of text.
+static const size_t TOKENIZER_MIN_CHUNK_SIZE = 1 << 20;
+
+//* Streaming reader keeps at most this many windows of this many bytes of words in memory.
+static const size_t STREAM_WINDOW_SIZE = 1 << 24;
+static const size_t STREAM_WINDOW_COUNT = 4;
+
+//* Shard loader keeps this many reads of this many bytes of words in flight.
+static const size_t SHARD_READ_SIZE = 1 << 20;
+static const unsigned SHARD_QUEUE_DEPTH = 64;
+
 #ifndef OPTIMIZATION_LEVEL
 #define OPTIMIZATION_LEVEL 0
 #endif
 
+#if defined(STRING_KEYS) && !defined(TESTED_TABLE)
+#define TESTED_TABLE StringTable
+#endif
+
+#ifndef TESTED_TABLE
+#define TESTED_TABLE HashTable
+#endif
+
+#ifndef TESTED_HASH
+#define TESTED_HASH murmur_hash
+#endif
+
 #ifndef BUCKET_COUNT
     static const unsigned BUCKET_COUNT = 2027;
 #endif
@@ -37,4 +74,38 @@ static const unsigned MAX_WORD_LENGTH = 32;
 #ifndef TEST_REPETITION
     static const unsigned TEST_REPETITION = 2000;
 #endif
-#endif
\ No newline at end of file
+
+//* Latency test repeats the runs this many times before recording samples to warm up caches and branch predictors.
+#ifndef LATENCY_WARMUP_RUNS
+    static const unsigned LATENCY_WARMUP_RUNS = 2;
+#endif
+
+//* Zipf-skewed benchmark queries: the key of rank r is requested with probability proportional to 1/r^exponent.
+static const double DFLT_ZIPF_EXPONENT = 0.99;
+
+//* Shares of insertions and removals in the mixed benchmark workload, the rest are lookups.
+static const double DFLT_MIX_INSERT_SHARE = 0.1;
+static const double DFLT_MIX_REMOVE_SHARE = 0.1;
+
+//* Generated keys (see bmark/key_generator.h).
+static const size_t DFLT_GENERATED_MIN_LENGTH = 4;
+static const size_t DFLT_GENERATED_MAX_LENGTH = 12;
+static const char DFLT_GENERATED_ALPHABET[] = "abcdefghijklmnopqrstuvwxyz";
+
+//* Size sweep starts with this many keys and multiplies it by 10 on every step.
+static const size_t SWEEP_MIN_KEYS = 1000;
+//* Small tables of the sweep are searched several times, so that every step makes at least this many lookups.
+static const size_t SWEEP_MIN_LOOKUPS = 1000000;
+
+//* Comparison of benchmark results fails if the candidate is significantly slower than the baseline by more than this share.
+static const double DFLT_REGRESSION_THRESHOLD = 0.05;
+
+//* Pages backing the arena of the table built with TABLE_ARENA (see lib/alloc_tracker/arena.h).
+#ifndef TABLE_ARENA_PAGES
+#define TABLE_ARENA_PAGES ARENA_TRANSPARENT_HUGE_PAGES
+#endif
+
+#ifndef BENCHMARK_CPU
+    static const int BENCHMARK_CPU = 0;
+#endif
+#endif
\ No newline at end of file
@@ -12,3 +12,58 @@ void print_label() {
     printf("Build from\n%s %s\n", __DATE__, __TIME__);
     log_printf(ABSOLUTE_IMPORTANCE, "build info", "Build from %s %s.\n", __DATE__, __TIME__);
 }
+
+char* build_query_list(const char* word_list, size_t word_count, double miss_ratio, size_t* miss_count) {
+    char* queries = (char*) aligned_alloc(MAX_WORD_LENGTH, word_count * MAX_WORD_LENGTH);
+    _LOG_FAIL_CHECK_(queries, "error", ERROR_REPORTS, return NULL, NULL, ENOMEM);
+
+    memcpy(queries, word_list, word_count * MAX_WORD_LENGTH);
+
+    srand(QUERY_SEED);
+
+    size_t absent_count = 0;
+    for (size_t word_id = 0; word_id < word_count; ++word_id) {
+        if ((double) rand() / RAND_MAX >= miss_ratio) continue;
+
+        queries[word_id * MAX_WORD_LENGTH] ^= 0x20;
+        ++absent_count;
+    }
+
+    log_printf(STATUS_REPORTS, "status", "Built %lu queries with %lu absent words.\n", word_count, absent_count);
+
+    if (miss_count) *miss_count = absent_count;
+
+    return queries;
+}
+
+StringKey* build_token_query_list(const StringKey* key_list, size_t key_count, double miss_ratio, size_t* miss_count) {
+    size_t storage_size = 0;
+    for (size_t key_id = 0; key_id < key_count; ++key_id) {
+        storage_size += padded_token_length(key_list[key_id].length);
+    }
+
+    StringKey* queries = (StringKey*) calloc(key_count * sizeof(*queries) + storage_size, 1);
+    _LOG_FAIL_CHECK_(queries, "error", ERROR_REPORTS, return NULL, NULL, ENOMEM);
+
+    char* storage = (char*) (queries + key_count);
+
+    srand(QUERY_SEED);
+
+    size_t absent_count = 0;
+    for (size_t key_id = 0; key_id < key_count; ++key_id) {
+        memcpy(storage, key_list[key_id].begin, key_list[key_id].length);
+        queries[key_id] = { .begin = storage, .length = key_list[key_id].length };
+        storage += padded_token_length(key_list[key_id].length);
+
+        if ((double) rand() / RAND_MAX >= miss_ratio) continue;
+
+        *(char*) queries[key_id].begin ^= 0x20;
+        ++absent_count;
+    }
+
+    log_printf(STATUS_REPORTS, "status", "Built %lu queries with %lu absent keys.\n", key_count, absent_count);
+
+    if (miss_count) *miss_count = absent_count;
+
+    return queries;
+}
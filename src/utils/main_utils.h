@@ -17,10 +17,38 @@
 
 #include "common_utils.h"
 
+#include "src/text_parser/text_parser.h"
+
 /**
  * @brief Print program label and build date/time to console and log.
  * 
  */
 void print_label();
 
-#endif
\ No newline at end of file
+/**
+ * @brief Build list of benchmark queries from the word list, replacing some words with absent ones.
+ * 
+ * Absent words are produced by flipping the case of the first letter of the original word.
+ * 
+ * @param word_list list of words padded to MAX_WORD_LENGTH
+ * @param word_count number of words in the list
+ * @param miss_ratio share of absent words in the result (from 0 to 1)
+ * @param miss_count variable to store the number of absent words to (can be NULL)
+ * @return aligned query list of word_count words (NULL if failed), should be freed by the caller
+ */
+char* build_query_list(const char* word_list, size_t word_count, double miss_ratio, size_t* miss_count);
+
+/**
+ * @brief Build list of benchmark queries from the list of arbitrary-length keys, replacing some keys with absent ones.
+ * 
+ * Keys are copied next to the returned array with the same padding as in read_tokens().
+ * 
+ * @param key_list list of keys
+ * @param key_count number of keys in the list
+ * @param miss_ratio share of absent keys in the result (from 0 to 1)
+ * @param miss_count variable to store the number of absent keys to (can be NULL)
+ * @return query list of key_count keys (NULL if failed), should be freed by the caller
+ */
+StringKey* build_token_query_list(const StringKey* key_list, size_t key_count, double miss_ratio, size_t* miss_count);
+
+#endif
\ No newline at end of file